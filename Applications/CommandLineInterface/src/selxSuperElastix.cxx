@@ -21,17 +21,26 @@
 #include "selxAnyFileReader.h"
 #include "selxAnyFileWriter.h"
 #include "selxLogger.h"
+#include "selxProfiler.h"
 #include "selxGitInfo.h"
+#include "selxThreadBudget.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iterator>
+#include <map>
 #include <string>
 #include <stdexcept>
+#include <thread>
 
 template< class T >
 std::ostream &
@@ -68,14 +77,384 @@ namespace selx
   }
 }
 
+namespace
+{
+typedef std::vector< std::string >             VectorOfStringsType;
+typedef std::vector< boost::filesystem::path > VectorOfPathsType;
+typedef std::map< std::string, std::string >   NamesAndPathsType;
+
+// One line of a batch manifest: the inputs and outputs of a single execution of the blueprint
+struct BatchJob
+{
+  std::string       id;
+  NamesAndPathsType inputs;
+  NamesAndPathsType outputs;
+};
+
+struct BatchJobReport
+{
+  std::string id;
+  bool        succeeded;
+  double      seconds;
+  std::string message;
+};
+
+// CSV manifest: a header with an optional "id" column and columns "in:<name>" and "out:<name>", followed by a line per job.
+std::vector< BatchJob >
+ReadBatchManifestCsv( const boost::filesystem::path & manifestPath )
+{
+  std::ifstream manifestFile( manifestPath.string() );
+  if( !manifestFile )
+  {
+    throw std::runtime_error( "Cannot open batch manifest " + manifestPath.string() );
+  }
+
+  std::string         line;
+  VectorOfStringsType header;
+  std::getline( manifestFile, line );
+  boost::split( header, line, boost::is_any_of( "," ) );
+  for( auto & column : header )
+  {
+    boost::trim( column );
+    if( column != "id" && !boost::starts_with( column, "in:" ) && !boost::starts_with( column, "out:" ) )
+    {
+      throw std::runtime_error( "Batch manifest column '" + column + "' is not 'id', 'in:<name>' or 'out:<name>'" );
+    }
+  }
+
+  std::vector< BatchJob > jobs;
+  unsigned int            lineNumber = 1;
+  while( std::getline( manifestFile, line ) )
+  {
+    ++lineNumber;
+    boost::trim( line );
+    if( line.empty() )
+    {
+      continue;
+    }
+
+    VectorOfStringsType values;
+    boost::split( values, line, boost::is_any_of( "," ) );
+    if( values.size() != header.size() )
+    {
+      throw std::runtime_error( "Batch manifest line " + std::to_string( lineNumber ) + " does not have " + std::to_string( header.size() ) + " columns" );
+    }
+
+    BatchJob job;
+    job.id = std::to_string( jobs.size() + 1 );
+    for( std::size_t column = 0; column < header.size(); ++column )
+    {
+      const std::string value = boost::trim_copy( values[ column ] );
+      if( header[ column ] == "id" )
+      {
+        job.id = value;
+      }
+      else if( boost::starts_with( header[ column ], "in:" ) )
+      {
+        job.inputs[ header[ column ].substr( 3 ) ] = value;
+      }
+      else
+      {
+        job.outputs[ header[ column ].substr( 4 ) ] = value;
+      }
+    }
+    jobs.push_back( job );
+  }
+  return jobs;
+}
+
+
+// JSON manifest: a list of jobs, e.g. [ { "id": "pair1", "in": { "FixedImage": "a.mhd" }, "out": { "ResultImage": "b.mhd" } } ]
+std::vector< BatchJob >
+ReadBatchManifestJson( const boost::filesystem::path & manifestPath )
+{
+  boost::property_tree::ptree manifest;
+  boost::property_tree::read_json( manifestPath.string(), manifest );
+
+  std::vector< BatchJob > jobs;
+  for( const auto & jobNode : manifest )
+  {
+    BatchJob job;
+    job.id = jobNode.second.get< std::string >( "id", std::to_string( jobs.size() + 1 ) );
+    for( const auto & input : jobNode.second.get_child( "in", boost::property_tree::ptree() ) )
+    {
+      job.inputs[ input.first ] = input.second.data();
+    }
+    for( const auto & output : jobNode.second.get_child( "out", boost::property_tree::ptree() ) )
+    {
+      job.outputs[ output.first ] = output.second.data();
+    }
+    jobs.push_back( job );
+  }
+  return jobs;
+}
+
+
+std::vector< BatchJob >
+ReadBatchManifest( const boost::filesystem::path & manifestPath )
+{
+  if( boost::iequals( manifestPath.extension().string(), ".json" ) )
+  {
+    return ReadBatchManifestJson( manifestPath );
+  }
+  return ReadBatchManifestCsv( manifestPath );
+}
+
+
+// Merges the configuration files into one Blueprint
+selx::Blueprint::Pointer
+ReadBlueprint( const VectorOfPathsType & configurationPaths, selx::Logger::Pointer logger )
+{
+  selx::Blueprint::Pointer blueprint = selx::Blueprint::New();
+  blueprint->SetLogger( logger );
+  for( const auto & configurationPath : configurationPaths )
+  {
+    blueprint->MergeFromFile( configurationPath.string() );
+  }
+  return blueprint;
+}
+
+
+// A worker configures its SuperElastixFilter once and executes the realized network for each of its jobs.
+// The Blueprint is shared by all workers, the filters only read it.
+class BatchWorker
+{
+public:
+
+  BatchWorker( selx::Blueprint::Pointer blueprint, selx::Logger::Pointer logger, selx::Profiler::Pointer profiler,
+    unsigned int numberOfStreamChunks, const std::string & memoizationDirectory ) :
+    m_Blueprint( blueprint ), m_Logger( logger ), m_Profiler( profiler ), m_NumberOfStreamChunks( numberOfStreamChunks ),
+    m_MemoizationDirectory( memoizationDirectory )
+  {
+  }
+
+
+  void Run( const BatchJob & job )
+  {
+    // Inputs that are not given by a job would silently be taken from the previous job, so
+    // a job with other input or output names starts with a new filter.
+    if( !this->m_SuperElastixFilter || !HasSameNames( job.inputs, this->m_FileReaders ) || !HasSameNames( job.outputs, this->m_FileWriters ) )
+    {
+      this->Initialize();
+    }
+
+    try
+    {
+      for( const auto & nameAndPath : job.inputs )
+      {
+        selx::AnyFileReader::Pointer & reader = this->m_FileReaders[ nameAndPath.first ];
+        if( !reader )
+        {
+          reader = this->m_SuperElastixFilter->GetInputFileReader( nameAndPath.first );
+          this->m_SuperElastixFilter->SetInput( nameAndPath.first, reader->GetOutput() );
+        }
+        reader->SetFileName( nameAndPath.second );
+      }
+
+      for( const auto & nameAndPath : job.outputs )
+      {
+        selx::AnyFileWriter::Pointer & writer = this->m_FileWriters[ nameAndPath.first ];
+        if( !writer )
+        {
+          writer = this->m_SuperElastixFilter->GetOutputFileWriter( nameAndPath.first );
+          writer->SetInput( this->m_SuperElastixFilter->GetOutput( nameAndPath.first ) );
+          if( this->m_NumberOfStreamChunks > 1 )
+          {
+            writer->SetNumberOfStreamDivisions( this->m_NumberOfStreamChunks );
+          }
+        }
+        writer->SetFileName( nameAndPath.second );
+      }
+
+      for( auto & nameAndWriter : this->m_FileWriters )
+      {
+        nameAndWriter.second->Update();
+      }
+    }
+    catch( ... )
+    {
+      this->CollectProfile( job );
+      // The state of the network is unknown after a failure
+      this->m_SuperElastixFilter = nullptr;
+      throw;
+    }
+    this->CollectProfile( job );
+  }
+
+private:
+
+  template< typename T >
+  static bool HasSameNames( const NamesAndPathsType & namesAndPaths, const std::map< std::string, T > & namedObjects )
+  {
+    return namesAndPaths.size() == namedObjects.size()
+           && std::equal( namesAndPaths.begin(), namesAndPaths.end(), namedObjects.begin(),
+      []( const NamesAndPathsType::value_type & a, const typename std::map< std::string, T >::value_type & b ) { return a.first == b.first; } );
+  }
+
+
+  // Move the measurements of the job to the profiler shared by all workers, prefixing the component names with the job id
+  void CollectProfile( const BatchJob & job )
+  {
+    if( !this->m_Profiler || !this->m_SuperElastixFilter )
+    {
+      return;
+    }
+    const auto jobProfiler = this->m_SuperElastixFilter->GetProfiler();
+    for( auto measurement : jobProfiler->GetMeasurements() )
+    {
+      measurement.componentName = job.id + "/" + measurement.componentName;
+      this->m_Profiler->AddMeasurement( measurement );
+    }
+    for( auto iteration : jobProfiler->GetIterations() )
+    {
+      iteration.componentName = job.id + "/" + iteration.componentName;
+      this->m_Profiler->AddIteration( iteration );
+    }
+    jobProfiler->Clear();
+  }
+
+
+  void Initialize()
+  {
+    this->m_FileReaders.clear();
+    this->m_FileWriters.clear();
+
+    this->m_SuperElastixFilter = selx::SuperElastixFilter::New();
+    this->m_SuperElastixFilter->SetLogger( this->m_Logger );
+    this->m_SuperElastixFilter->SetBlueprint( this->m_Blueprint );
+    this->m_SuperElastixFilter->BatchModeOn();
+    this->m_SuperElastixFilter->SetProfiling( this->m_Profiler != nullptr );
+    this->m_SuperElastixFilter->SetMemoizationDirectory( this->m_MemoizationDirectory );
+  }
+
+
+  const selx::Blueprint::Pointer    m_Blueprint;
+  selx::Logger::Pointer             m_Logger;
+  selx::Profiler::Pointer           m_Profiler;
+  const unsigned int                m_NumberOfStreamChunks;
+  const std::string                 m_MemoizationDirectory;
+  selx::SuperElastixFilter::Pointer m_SuperElastixFilter;
+  std::map< std::string, selx::AnyFileReader::Pointer > m_FileReaders;
+  std::map< std::string, selx::AnyFileWriter::Pointer > m_FileWriters;
+};
+
+
+// Executes the jobs of the manifest by a pool of workers and returns the number of failed jobs
+unsigned int
+RunBatch( const std::vector< BatchJob > & jobs, const NamesAndPathsType & commonInputs,
+  selx::Blueprint::Pointer blueprint, const unsigned int numberOfWorkers, selx::Logger::Pointer logger,
+  selx::Profiler::Pointer profiler, const unsigned int numberOfStreamChunks, const std::string & memoizationDirectory,
+  std::ostream & report )
+{
+  std::vector< BatchJobReport > jobReports( jobs.size() );
+  std::atomic< std::size_t >    nextJobIndex( 0 );
+
+  auto work = [ & ]()
+  {
+    BatchWorker worker( blueprint, logger, profiler, numberOfStreamChunks, memoizationDirectory );
+    for( std::size_t jobIndex = nextJobIndex++; jobIndex < jobs.size(); jobIndex = nextJobIndex++ )
+    {
+      // Inputs given by --in are shared by all jobs, unless the manifest overrides them
+      BatchJob job = jobs[ jobIndex ];
+      job.inputs.insert( commonInputs.begin(), commonInputs.end() );
+
+      BatchJobReport & jobReport = jobReports[ jobIndex ];
+      jobReport.id = job.id;
+      logger->Log( selx::LogLevel::INF, "Executing job " + job.id + " ..." );
+      const auto start = std::chrono::steady_clock::now();
+      try
+      {
+        worker.Run( job );
+        jobReport.succeeded = true;
+      }
+      catch( std::exception & e )
+      {
+        jobReport.succeeded = false;
+        jobReport.message   = e.what();
+      }
+      catch( ... )
+      {
+        jobReport.succeeded = false;
+        jobReport.message   = "Exception of unknown type!";
+      }
+      jobReport.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+      if( jobReport.succeeded )
+      {
+        logger->Log( selx::LogLevel::INF, "Executing job " + job.id + " ... Done (" + std::to_string( jobReport.seconds ) + " s)" );
+      }
+      else
+      {
+        logger->Log( selx::LogLevel::ERR, "Executing job " + job.id + " ... Error: " + jobReport.message );
+      }
+    }
+  };
+
+  // The jobs that are executed concurrently split the threads of the process
+  selx::ThreadBudget::Reservation reservation( std::max( numberOfWorkers, 1u ) );
+
+  std::vector< std::thread > workers;
+  for( unsigned int workerIndex = 0; workerIndex < std::max( numberOfWorkers, 1u ); ++workerIndex )
+  {
+    workers.emplace_back( work );
+  }
+  for( auto & worker : workers )
+  {
+    worker.join();
+  }
+
+  unsigned int numberOfFailedJobs = 0;
+  report << "id,status,seconds,message" << std::endl;
+  for( const auto & jobReport : jobReports )
+  {
+    std::string message = jobReport.message;
+    std::replace( message.begin(), message.end(), ',', ';' );
+    std::replace( message.begin(), message.end(), '\n', ' ' );
+    report << jobReport.id << "," << ( jobReport.succeeded ? "succeeded" : "failed" ) << "," << jobReport.seconds << "," << message << std::endl;
+    numberOfFailedJobs += jobReport.succeeded ? 0 : 1;
+  }
+  return numberOfFailedJobs;
+}
+
+
+void
+WriteProfile( const selx::Profiler & profiler, const boost::filesystem::path & profilePath )
+{
+  std::ofstream profileFile( profilePath.string() );
+  if( !profileFile )
+  {
+    throw std::runtime_error( "Cannot open profile file " + profilePath.string() );
+  }
+  profiler.WriteJson( profileFile );
+}
+
+
+// Splits the <name>=<path> arguments of --in and --out. The path is everything after the first '='.
+NamesAndPathsType
+SplitNamesAndPaths( const VectorOfStringsType & pairs )
+{
+  NamesAndPathsType namesAndPaths;
+  for( const auto & pair : pairs )
+  {
+    const std::size_t separator = pair.find( '=' );
+    if( separator == std::string::npos || separator == 0 || separator + 1 == pair.size() )
+    {
+      throw std::runtime_error( "Argument '" + pair + "' is not of the form <name>=<path>" );
+    }
+    if( !namesAndPaths.emplace( pair.substr( 0, separator ), pair.substr( separator + 1 ) ).second )
+    {
+      throw std::runtime_error( "Argument '" + pair + "' repeats the name " + pair.substr( 0, separator ) );
+    }
+  }
+  return namesAndPaths;
+}
+} // end anonymous namespace
+
 int
 main( int ac, char * av[] )
 {
 
   selx::Logger::Pointer logger = selx::Logger::New();
-  
-  typedef std::vector< std::string > VectorOfStringsType;
-  typedef std::vector< boost::filesystem::path > VectorOfPathsType;
 
   boost::filesystem::path logPath;
   // default log level
@@ -87,6 +466,18 @@ main( int ac, char * av[] )
   VectorOfStringsType inputPairs;
   VectorOfStringsType outputPairs;
 
+  boost::filesystem::path batchManifestPath;
+  boost::filesystem::path batchReportPath;
+  unsigned int            numberOfWorkers = 1;
+
+  boost::filesystem::path profilePath;
+
+  unsigned int numberOfStreamChunks = 1;
+
+  boost::filesystem::path memoizationDirectory;
+
+  unsigned int numberOfThreads = 0;
+
   boost::program_options::variables_map vm;
 
   try
@@ -96,9 +487,16 @@ main( int ac, char * av[] )
       ( "help", "produce help message" )
       ( "revision-sha", "produce git revision SHA-1 hash of SuperElastix source" )
       ("conf", boost::program_options::value< VectorOfPathsType >(&configurationPaths)->required()->multitoken(), "Configuration file: single or multiple Blueprints [.xml|.json]")
-      ("in", boost::program_options::value< VectorOfStringsType >(&inputPairs)->multitoken(), "Input data: images, labels, meshes, etc. Usage arg: <name>=<path> (or multiple pairs)")
+      ("in", boost::program_options::value< VectorOfStringsType >(&inputPairs)->multitoken(), "Input data: images, labels, meshes, etc. Usage arg: <name>=<path> (or multiple pairs). In batch mode these inputs are shared by all jobs.")
       ("out", boost::program_options::value< VectorOfStringsType >(&outputPairs)->multitoken(), "Output data: images, labels, meshes, etc. Usage arg: <name>=<path> (or multiple pairs)")
+      ("batch", boost::program_options::value< boost::filesystem::path >(&batchManifestPath), "Batch manifest [.csv|.json] with the inputs and outputs of many executions of the same Blueprint. CSV header: [id,]in:<name>,...,out:<name>,...")
+      ("workers", boost::program_options::value< unsigned int >(&numberOfWorkers), "Number of batch jobs that are executed concurrently (default 1)")
+      ("batch-report", boost::program_options::value< boost::filesystem::path >(&batchReportPath), "Batch status and timing report file [.csv] (default: standard output)")
+      ("stream-chunks", boost::program_options::value< unsigned int >(&numberOfStreamChunks), "Write output images in this number of pieces, such that warped outputs are generated piece by piece instead of in full (default 1). Requires a file format that supports streamed writing, e.g. .mha or .nrrd")
+      ("memoize", boost::program_options::value< boost::filesystem::path >(&memoizationDirectory), "Store the results of components in this directory and reuse them when run again with the same settings and inputs")
+      ("threads", boost::program_options::value< unsigned int >(&numberOfThreads), "Number of threads, split between the batch jobs and the components that run concurrently (default: number of hardware threads). Components may be limited further by their NumberOfThreads setting")
       ("graphout", boost::program_options::value< boost::filesystem::path >(), "Output Graphviz dot file")
+      ("profile", boost::program_options::value< boost::filesystem::path >(&profilePath), "Profile output file [.json]: wall time, CPU time and peak memory increase per component, and optimizer iterations")
       ("logfile", boost::program_options::value< boost::filesystem::path >(&logPath), "Log output file")
       ("loglevel", boost::program_options::value< selx::LogLevel >(&logLevel), "Log level [off|critical|error|warning|info|debug|trace]")
       ;
@@ -143,19 +541,54 @@ main( int ac, char * av[] )
 
     logger->AddStream("cout", std::cout);
     logger->SetLogLevel(logLevel);
+
+    if( vm.count( "threads" ) )
+    {
+      selx::ThreadBudget::SetNumberOfThreads( numberOfThreads );
+    }
+
+    if( vm.count( "batch" ) )
+    {
+      if( vm.count( "out" ) )
+      {
+        throw std::runtime_error( "In batch mode the outputs of each job are given by the batch manifest, not by --out" );
+      }
+
+      logger->Log( selx::LogLevel::INF, "Reading batch manifest ..." );
+      const auto jobs = ReadBatchManifest( batchManifestPath );
+      logger->Log( selx::LogLevel::INF, "Reading batch manifest ... Done. " + std::to_string( jobs.size() ) + " jobs." );
+
+      std::ofstream reportFile;
+      if( vm.count( "batch-report" ) )
+      {
+        reportFile.open( batchReportPath.string() );
+      }
+      std::ostream & report = vm.count( "batch-report" ) ? reportFile : std::cout;
+
+      const auto profiler = vm.count( "profile" ) ? std::make_shared< selx::Profiler >() : nullptr;
+      const unsigned int numberOfFailedJobs = RunBatch( jobs, SplitNamesAndPaths( inputPairs ), ReadBlueprint( configurationPaths, logger ), numberOfWorkers, logger, profiler,
+        numberOfStreamChunks, memoizationDirectory.string(), report );
+      if( profiler )
+      {
+        WriteProfile( *profiler, profilePath );
+      }
+      if( numberOfFailedJobs > 0 )
+      {
+        logger->Log( selx::LogLevel::ERR, std::to_string( numberOfFailedJobs ) + " out of " + std::to_string( jobs.size() ) + " jobs failed." );
+        return 1;
+      }
+      return 0;
+    }
    
     // instantiate a SuperElastixFilter that is loaded with default components
     selx::SuperElastixFilter::Pointer superElastixFilter = selx::SuperElastixFilter::New();
 
     superElastixFilter->SetLogger(logger);
+    superElastixFilter->SetProfiling( vm.count( "profile" ) > 0 );
+    superElastixFilter->SetMemoizationDirectory( memoizationDirectory.string() );
+    const selx::Profiler::Pointer profiler = superElastixFilter->GetProfiler();
 
-    // create empty blueprint
-    selx::Blueprint::Pointer blueprint = selx::Blueprint::New();
-    blueprint->SetLogger(logger);
-    for (const auto & configurationPath : configurationPaths)
-    {
-      blueprint->MergeFromFile(configurationPath.string());
-    }
+    selx::Blueprint::Pointer blueprint = ReadBlueprint( configurationPaths, logger );
 
     if( vm.count( "graphout" ) )
     {
@@ -173,18 +606,22 @@ main( int ac, char * av[] )
     if( vm.count( "in" ) )
     {
       logger->Log( selx::LogLevel::INF, "Preparing input data ... ");
-      for( const auto & inputPair : inputPairs )
+      for( const auto & nameAndPath : SplitNamesAndPaths( inputPairs ) )
       {
-        VectorOfStringsType nameAndPath;
-        boost::split( nameAndPath, inputPair, boost::is_any_of( "=" ) );  // NameAndPath == { "name","path" }
-        const std::string & name = nameAndPath[ 0 ];
-        const std::string & path = nameAndPath[ 1 ];
+        const std::string & name = nameAndPath.first;
+        const std::string & path = nameAndPath.second;
 
         // since we do not know which reader type we should instantiate for input "name",
         // we ask SuperElastix for a reader that matches the type of the source component "name"
         logger->Log( selx::LogLevel::INF, "Preparing input '" + name + "': " + path + " ..." );
         selx::AnyFileReader::Pointer reader = superElastixFilter->GetInputFileReader( name );
         reader->SetFileName( path );
+        if( vm.count( "profile" ) )
+        {
+          // Read upfront, to separate reading from the execution of the network
+          selx::Profiler::Scope scope( profiler, name, "Read" );
+          reader->Update();
+        }
         superElastixFilter->SetInput( name, reader->GetOutput() );
         fileReaders.push_back( reader );
         logger->Log( selx::LogLevel::INF, "Preparing input '" + name + "': " + path + " ... Done" );
@@ -199,12 +636,10 @@ main( int ac, char * av[] )
     if( vm.count( "out" ) )
     {
       logger->Log( selx::LogLevel::INF, "Preparing output data ... ");
-      for( const auto & outputPair : outputPairs )
+      for( const auto & nameAndPath : SplitNamesAndPaths( outputPairs ) )
       {
-        VectorOfStringsType nameAndPath;
-        boost::split( nameAndPath, outputPair, boost::is_any_of( "=" ) );  // NameAndPath == { "name","path" }
-        const std::string & name = nameAndPath[ 0 ];
-        const std::string & path = nameAndPath[ 1 ];
+        const std::string & name = nameAndPath.first;
+        const std::string & path = nameAndPath.second;
 
         // since we do not know which writer type we should instantiate for output "name",
         // we ask SuperElastix for a writer that matches the type of the sink component "name"
@@ -212,6 +647,10 @@ main( int ac, char * av[] )
         selx::AnyFileWriter::Pointer writer = superElastixFilter->GetOutputFileWriter( name );
         writer->SetFileName( path );
         writer->SetInput( superElastixFilter->GetOutput( name ) );
+        if( numberOfStreamChunks > 1 )
+        {
+          writer->SetNumberOfStreamDivisions( numberOfStreamChunks );
+        }
         fileWriters.push_back( writer );
         logger->Log( selx::LogLevel::INF, "Preparing output '" + name + "': " + path + " ... Done" );
       }
@@ -223,11 +662,20 @@ main( int ac, char * av[] )
 
     /* Execute SuperElastix by updating the writers */
     logger->Log( selx::LogLevel::INF, "Executing ...");
-    for( auto & writer : fileWriters )
     {
-      writer->Update();
+      // Total of executing the network and writing the outputs
+      selx::Profiler::Scope scope( vm.count( "profile" ) ? profiler : nullptr, "SuperElastix", "Execute" );
+      for( auto & writer : fileWriters )
+      {
+        writer->Update();
+      }
     }
     logger->Log(selx:: LogLevel::INF, "Executing ... Done");
+
+    if( vm.count( "profile" ) )
+    {
+      WriteProfile( *profiler, profilePath );
+    }
   }
   catch( std::exception & e )
   {
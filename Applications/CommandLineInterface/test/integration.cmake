@@ -93,4 +93,16 @@ add_test(NAME Integration_ComposeBlueprintItk COMMAND SuperElastix
         ResultDisplacementField=${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_ComposeBlueprintItk_def.mhd
         ResultTransform=Integration_ComposeBlueprintItk.tfm)
   
-  
\ No newline at end of file
+  
+# Batch mode: the same blueprint is executed for both registration directions
+file( WRITE ${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_manifest.csv
+  "id,in:FixedImage,in:MovingImage,out:ResultImage,out:ResultDisplacementField\n"
+  "AtoB,${SUPERELASTIX_INPUT_DATA_DIR}/coneA2d64.mhd,${SUPERELASTIX_INPUT_DATA_DIR}/coneB2d64.mhd,${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_AtoB_image.mhd,${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_AtoB_deformation.mhd\n"
+  "BtoA,${SUPERELASTIX_INPUT_DATA_DIR}/coneB2d64.mhd,${SUPERELASTIX_INPUT_DATA_DIR}/coneA2d64.mhd,${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_BtoA_image.mhd,${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_BtoA_deformation.mhd\n" )
+
+add_test(NAME Integration_Batch COMMAND SuperElastix
+  --logfile ${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch.log
+  --loglevel trace
+  --conf ${SUPERELASTIX_CONFIGURATION_DATA_DIR}/itkv4_SVF_MSD.json
+  --batch ${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_manifest.csv
+  --batch-report ${SUPERELASTIX_OUTPUT_DATA_DIR}/Integration_Batch_report.csv)
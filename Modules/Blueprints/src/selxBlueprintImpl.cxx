@@ -33,6 +33,7 @@
 #include "selxLoggerImpl.h"
 
 // Standard C++ Library headers:
+#include <algorithm>
 #include <ostream>
 #include <stdexcept>
 #include <tuple>  // For std::tie.
@@ -110,7 +111,7 @@ make_edge_label_writer( ParameterMapType p )
 }
 
 
-BlueprintImpl::BlueprintImpl( LoggerImpl & loggerImpl ) : m_LoggerImpl(&loggerImpl)
+BlueprintImpl::BlueprintImpl( LoggerImpl & loggerImpl ) : m_LoggerImpl(&loggerImpl), m_ModifiedTime( 0 )
 {
 }
 
@@ -121,11 +122,16 @@ BlueprintImpl
 {
   if( this->ComponentExists( name ) )
   {
-    this->m_Graph[ name ].parameterMap = parameterMap;
+    if( this->m_Graph[ name ].parameterMap != parameterMap )
+    {
+      this->m_Graph[ name ].parameterMap = parameterMap;
+      this->ComponentModified( name );
+    }
     return true;
   }
   else
   {
+    this->ComponentModified( name );
     return this->m_Graph.insert_vertex( name, { name, parameterMap } ).second;
   }
 }
@@ -196,12 +202,17 @@ BlueprintImpl
     if (name == existingName)
     {
       // override previous parameterMap
-      boost::put(&ConnectionPropertyType::parameterMap, this->m_Graph.graph(), *ei, parameterMap);
+      if( boost::get(&ConnectionPropertyType::parameterMap, this->m_Graph.graph(), *ei) != parameterMap )
+      {
+        boost::put(&ConnectionPropertyType::parameterMap, this->m_Graph.graph(), *ei, parameterMap);
+        this->ComponentModified( downstream );
+      }
       return true;
     }
   }// no existing connections named "name" were found.
  
   boost::add_edge_by_label(upstream, downstream, { name, parameterMap }, this->m_Graph);
+  this->ComponentModified( downstream );
   return true;
 }
 
@@ -242,6 +253,7 @@ BlueprintImpl
       if (name == existingName)
       {
         boost::remove_edge(*ei, this->m_Graph.graph());
+        this->ComponentModified( downstream );
         return true;
       }
     }
@@ -454,6 +466,124 @@ BlueprintImpl
 }
 
 
+std::string
+BlueprintImpl
+::GetCanonicalDescription() const
+{
+  return this->GetCanonicalDescription( this->GetComponentNames() );
+}
+
+
+std::string
+BlueprintImpl
+::GetCanonicalDescription( const ComponentNamesType & componentNames ) const
+{
+  auto isIncluded = [ &componentNames ]( const ComponentNameType & name ) {
+      return std::find( componentNames.begin(), componentNames.end(), name ) != componentNames.end();
+    };
+
+  // Strings are prefixed by their length, such that no choice of names and values can make
+  // different blueprints look the same
+  auto append = []( std::string & description, const std::string & value ) {
+      description += std::to_string( value.size() ) + ':' + value;
+    };
+  auto appendParameterMap = [ & ]( std::string & description, const ParameterMapType & parameterMap ) {
+      description += std::to_string( parameterMap.size() ) + '{';
+      for( const auto & keyAndValues : parameterMap )
+      {
+        append( description, keyAndValues.first );
+        description += std::to_string( keyAndValues.second.size() ) + '[';
+        for( const auto & value : keyAndValues.second )
+        {
+          append( description, value );
+        }
+        description += ']';
+      }
+      description += '}';
+    };
+
+  std::vector< std::string > components;
+  const auto componentIteratorPair = boost::vertices( this->m_Graph.graph() );
+  for( auto it = componentIteratorPair.first; it != componentIteratorPair.second; ++it )
+  {
+    const ComponentPropertyType & component = this->m_Graph.graph()[ *it ];
+    if( !isIncluded( component.name ) )
+    {
+      continue;
+    }
+    std::string description = "C";
+    append( description, component.name );
+    appendParameterMap( description, component.parameterMap );
+    components.push_back( description );
+  }
+
+  std::vector< std::string > connections;
+  const auto connectionIteratorPair = boost::edges( this->m_Graph.graph() );
+  for( auto it = connectionIteratorPair.first; it != connectionIteratorPair.second; ++it )
+  {
+    const ConnectionPropertyType & connection = this->m_Graph.graph()[ *it ];
+    const ComponentNameType &      upstream   = this->m_Graph.graph()[ boost::source( *it, this->m_Graph.graph() ) ].name;
+    const ComponentNameType &      downstream = this->m_Graph.graph()[ boost::target( *it, this->m_Graph.graph() ) ].name;
+    if( !isIncluded( upstream ) || !isIncluded( downstream ) )
+    {
+      continue;
+    }
+    std::string description = "E";
+    append( description, upstream );
+    append( description, downstream );
+    append( description, connection.name );
+    appendParameterMap( description, connection.parameterMap );
+    connections.push_back( description );
+  }
+
+  // The graph stores components and connections in the order they were set
+  std::sort( components.begin(), components.end() );
+  std::sort( connections.begin(), connections.end() );
+
+  std::string canonicalDescription;
+  for( const auto & description : components )
+  {
+    canonicalDescription += description;
+  }
+  for( const auto & description : connections )
+  {
+    canonicalDescription += description;
+  }
+  return canonicalDescription;
+}
+
+
+BlueprintImpl::ModifiedTimeType
+BlueprintImpl
+::GetModifiedTime() const
+{
+  return this->m_ModifiedTime;
+}
+
+
+BlueprintImpl::ComponentNamesType
+BlueprintImpl
+::GetModifiedComponentNames( ModifiedTimeType modifiedTime ) const
+{
+  ComponentNamesType modifiedComponentNames;
+  for( const auto & nameAndModifiedTime : this->m_ComponentModifiedTimes )
+  {
+    if( nameAndModifiedTime.second > modifiedTime )
+    {
+      modifiedComponentNames.push_back( nameAndModifiedTime.first );
+    }
+  }
+  return modifiedComponentNames;
+}
+
+
+void
+BlueprintImpl
+::ComponentModified( const ComponentNameType & name )
+{
+  this->m_ComponentModifiedTimes[ name ] = ++this->m_ModifiedTime;
+}
+
 
 void
 BlueprintImpl
@@ -60,7 +60,8 @@ public:
   typedef Blueprint::ConnectionNameType ConnectionNameType;
   typedef Blueprint::ConnectionNamesType ConnectionNamesType;
 
-  
+  // Counts the modifications of the blueprint, see GetModifiedTime
+  typedef unsigned long ModifiedTimeType;
 
   // Component parameter map that sits on a node in the graph
   // and holds component configuration settings
@@ -141,6 +142,22 @@ public:
 
   ComponentNamesType GetUpdateOrder() const;
 
+  // Returns a description of all components, connections and their parameter maps that is independent of
+  // the order in which they were set. Blueprints with equal content have equal descriptions.
+  std::string GetCanonicalDescription() const;
+
+  // Returns the canonical description of the part of the blueprint made up of these components and the
+  // connections between them
+  std::string GetCanonicalDescription( const ComponentNamesType & componentNames ) const;
+
+  // Returns the number of modifications so far. Setting a component or connection to the parameter map it
+  // already has is not a modification.
+  ModifiedTimeType GetModifiedTime() const;
+
+  // Returns the components that were modified after modifiedTime. A component is modified by setting it and
+  // by setting or deleting one of its incoming connections.
+  ComponentNamesType GetModifiedComponentNames( ModifiedTimeType modifiedTime ) const;
+
   void Write( const std::string filename );
 
   void MergeFromFile(const std::string & filename);
@@ -162,8 +179,13 @@ private:
   Blueprint::Pointer FromPropertyTree(const PropertyTreeType &);
   void MergeProperties(const PropertyTreeType &);
 
+  void ComponentModified( const ComponentNameType & name );
+
   GraphType m_Graph;
 
+  ModifiedTimeType                                m_ModifiedTime;
+  std::map< ComponentNameType, ModifiedTimeType > m_ComponentModifiedTimes;
+
   LoggerImpl * m_LoggerImpl;
 };
 } // namespace selx
@@ -0,0 +1,187 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxFlattenTransform_h
+#define selxFlattenTransform_h
+
+#include "itkAffineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkImageBase.h"
+#include "itkMatrixOffsetTransformBase.h"
+#include "itkTransformToDisplacementFieldFilter.h"
+
+#include <vector>
+
+namespace selx
+{
+/** Appends the transforms of a chain to transforms, in the order in which they are applied to a point.
+ * Nested composite transforms are unpacked. Note that a composite transform applies the transform that
+ * was added last first. */
+template< class TScalar, unsigned int Dimensionality >
+void
+CollectTransforms( itk::Transform< TScalar, Dimensionality, Dimensionality > * transform,
+  std::vector< typename itk::Transform< TScalar, Dimensionality, Dimensionality >::Pointer > & transforms )
+{
+  using CompositeTransformType = itk::CompositeTransform< TScalar, Dimensionality >;
+
+  auto composite = dynamic_cast< CompositeTransformType * >( transform );
+  if( composite == nullptr )
+  {
+    transforms.push_back( transform );
+    return;
+  }
+  for( auto n = composite->GetNumberOfTransforms(); n > 0; --n )
+  {
+    CollectTransforms< TScalar, Dimensionality >( composite->GetNthTransform( n - 1 ).GetPointer(), transforms );
+  }
+}
+
+
+/** Returns an affine transform equal to a linear transform. Transforms that do not derive from
+ * MatrixOffsetTransformBase (e.g. TranslationTransform) are probed at the origin and the unit points. */
+template< class TScalar, unsigned int Dimensionality >
+typename itk::AffineTransform< TScalar, Dimensionality >::Pointer
+ToAffineTransform( const itk::Transform< TScalar, Dimensionality, Dimensionality > * transform )
+{
+  using AffineTransformType       = itk::AffineTransform< TScalar, Dimensionality >;
+  using MatrixOffsetTransformType = itk::MatrixOffsetTransformBase< TScalar, Dimensionality, Dimensionality >;
+
+  auto affine = AffineTransformType::New();
+  auto matrixOffset = dynamic_cast< const MatrixOffsetTransformType * >( transform );
+  if( matrixOffset != nullptr )
+  {
+    affine->SetMatrix( matrixOffset->GetMatrix() );
+    affine->SetOffset( matrixOffset->GetOffset() );
+    return affine;
+  }
+
+  typename AffineTransformType::InputPointType point;
+  point.Fill( 0.0 );
+  const auto origin = transform->TransformPoint( point );
+
+  typename AffineTransformType::MatrixType matrix;
+  for( unsigned int j = 0; j < Dimensionality; ++j )
+  {
+    point.Fill( 0.0 );
+    point[ j ] = 1.0;
+    const auto column = transform->TransformPoint( point ) - origin;
+    for( unsigned int i = 0; i < Dimensionality; ++i )
+    {
+      matrix[ i ][ j ] = column[ i ];
+    }
+  }
+  affine->SetMatrix( matrix );
+  affine->SetOffset( origin.GetVectorFromOrigin() );
+  return affine;
+}
+
+
+/** Collapses a transform chain into a single equivalent transform, such that resampling costs one
+ * transform evaluation per voxel instead of one per stage:
+ *  - consecutive linear transforms are merged into one affine transform;
+ *  - if the chain is linear, the merged affine transform is returned and the domain is not used;
+ *  - if a single transform remains, it is returned as is;
+ *  - otherwise the remaining chain is sampled on the grid of domain into one displacement field.
+ * A sampled transform is only exact at the grid points of domain, is interpolated linearly in between,
+ * and has no inverse. */
+template< class TScalar, unsigned int Dimensionality >
+typename itk::Transform< TScalar, Dimensionality, Dimensionality >::Pointer
+FlattenTransform( itk::Transform< TScalar, Dimensionality, Dimensionality > * transform,
+  const itk::ImageBase< Dimensionality > * domain, unsigned int numberOfThreads = 0 )
+{
+  using TransformType                  = itk::Transform< TScalar, Dimensionality, Dimensionality >;
+  using CompositeTransformType         = itk::CompositeTransform< TScalar, Dimensionality >;
+  using DisplacementFieldTransformType = itk::DisplacementFieldTransform< TScalar, Dimensionality >;
+  using DisplacementFieldType          = typename DisplacementFieldTransformType::DisplacementFieldType;
+  using DisplacementFieldFilterType    = itk::TransformToDisplacementFieldFilter< DisplacementFieldType, TScalar >;
+
+  std::vector< typename TransformType::Pointer > transforms;
+  CollectTransforms< TScalar, Dimensionality >( transform, transforms );
+
+  // Merge runs of linear transforms. The matrix of a run is the product of the matrices of its
+  // transforms, with the transform that is applied first on the right.
+  std::vector< typename TransformType::Pointer > stages;
+  typename itk::AffineTransform< TScalar, Dimensionality >::Pointer affine;
+  for( const auto & stage : transforms )
+  {
+    if( !stage->IsLinear() )
+    {
+      if( affine )
+      {
+        stages.push_back( affine.GetPointer() );
+        affine = nullptr;
+      }
+      stages.push_back( stage );
+    }
+    else if( !affine )
+    {
+      affine = ToAffineTransform< TScalar, Dimensionality >( stage.GetPointer() );
+    }
+    else
+    {
+      const auto next   = ToAffineTransform< TScalar, Dimensionality >( stage.GetPointer() );
+      const auto matrix = next->GetMatrix() * affine->GetMatrix();
+      const auto offset = next->GetMatrix() * affine->GetOffset() + next->GetOffset();
+      affine->SetMatrix( matrix );
+      affine->SetOffset( offset );
+    }
+  }
+  if( affine )
+  {
+    stages.push_back( affine.GetPointer() );
+  }
+
+  if( stages.empty() )
+  {
+    // An empty chain is the identity
+    return itk::AffineTransform< TScalar, Dimensionality >::New().GetPointer();
+  }
+  if( stages.size() == 1 )
+  {
+    return stages.front();
+  }
+
+  auto chain = CompositeTransformType::New();
+  for( auto stage = stages.rbegin(); stage != stages.rend(); ++stage )
+  {
+    chain->AddTransform( *stage );
+  }
+
+  auto displacementFieldFilter = DisplacementFieldFilterType::New();
+  displacementFieldFilter->SetTransform( chain );
+  displacementFieldFilter->SetReferenceImage( domain );
+  displacementFieldFilter->UseReferenceImageOn();
+  if( numberOfThreads > 0 )
+  {
+    displacementFieldFilter->SetNumberOfThreads( numberOfThreads );
+  }
+  displacementFieldFilter->Update();
+
+  typename DisplacementFieldType::Pointer displacementField = displacementFieldFilter->GetOutput();
+  displacementField->DisconnectPipeline();
+
+  auto displacementFieldTransform = DisplacementFieldTransformType::New();
+  displacementFieldTransform->SetDisplacementField( displacementField );
+  return displacementFieldTransform.GetPointer();
+}
+} // end namespace selx
+
+#endif // selxFlattenTransform_h
@@ -35,8 +35,10 @@ const char * const NameOfInterface              = "NameOfInterface";
 const char * const NameOfClass                  = "NameOfClass";                              // Each Component has a sting name
 const char * const Dimensionality               = "Dimensionality";                           // Template int parameter
 const char * const PixelType                    = "PixelType";                                // Template POD parameter
+const char * const InputPixelType               = "InputPixelType";                           // Template POD parameter of components that cast their input to PixelType
 const char * const InternalComputationValueType = "InternalComputationValueType";             // Template POD parameter for transforms or optimizers etc.
 const char * const CoordRepType                = "CoordRepType";
+const char * const NumberOfThreads              = "NumberOfThreads";                          // Setting of any Component: the maximum number of threads it may use, see ThreadBudget
 
 const char * const SourceInterface                      = "SourceInterface";                      // Special interface that connects to the outside of the SuperElastixFilter
 const char * const SinkInterface                        = "SinkInterface";                        // Special interface that connects to the outside of the SuperElastixFilter
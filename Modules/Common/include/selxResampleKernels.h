@@ -0,0 +1,251 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxResampleKernels_h
+#define selxResampleKernels_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace selx
+{
+/** \class BufferSampler
+ * \brief Samples a scalar image buffer at continuous indices, with the same boundary conventions as
+ * itk::LinearInterpolateImageFunction and itk::NearestNeighborInterpolateImageFunction:
+ * a continuous index is inside the buffer if first - 0.5 <= index < last + 0.5 in every dimension,
+ * and linear interpolation clamps the neighbours of an index near the border to the buffer.
+ *
+ * The sampler is not virtual and does not depend on the image type, so that the resample kernels can
+ * inline it in their scanline loops, where the compiler can vectorize it.
+ */
+template< class TPixel, unsigned int VDimension >
+class BufferSampler
+{
+public:
+
+  /** size and first are the size and index of the buffered region, the buffer is contiguous in dimension 0 */
+  template< class TIndex, class TSize >
+  BufferSampler( const TPixel * buffer, const TIndex & first, const TSize & size ) :
+    m_Buffer( buffer )
+  {
+    std::ptrdiff_t stride = 1;
+    for( unsigned int d = 0; d < VDimension; ++d )
+    {
+      this->m_Stride[ d ] = stride;
+      this->m_First[ d ]  = static_cast< std::ptrdiff_t >( first[ d ] );
+      this->m_Last[ d ]   = this->m_First[ d ] + static_cast< std::ptrdiff_t >( size[ d ] ) - 1;
+      this->m_Lower[ d ]  = this->m_First[ d ] - 0.5;
+      this->m_Upper[ d ]  = this->m_Last[ d ] + 0.5;
+      stride *= static_cast< std::ptrdiff_t >( size[ d ] );
+    }
+  }
+
+
+  bool IsInside( const double * index ) const
+  {
+    bool inside = true;
+    for( unsigned int d = 0; d < VDimension; ++d )
+    {
+      inside &= index[ d ] >= this->m_Lower[ d ] && index[ d ] < this->m_Upper[ d ];
+    }
+    return inside;
+  }
+
+
+  /** Value at the nearest voxel of an index inside the buffer, rounding halves up */
+  double Nearest( const double * index ) const
+  {
+    std::ptrdiff_t offset = 0;
+    for( unsigned int d = 0; d < VDimension; ++d )
+    {
+      const std::ptrdiff_t nearest = static_cast< std::ptrdiff_t >( std::floor( index[ d ] + 0.5 ) );
+      offset += ( std::min( std::max( nearest, this->m_First[ d ] ), this->m_Last[ d ] ) - this->m_First[ d ] ) * this->m_Stride[ d ];
+    }
+    return static_cast< double >( this->m_Buffer[ offset ] );
+  }
+
+
+  /** Multilinear interpolation at an index inside the buffer */
+  double Linear( const double * index ) const
+  {
+    std::ptrdiff_t base = 0;
+    std::ptrdiff_t step[ VDimension ];
+    double         fraction[ VDimension ];
+    for( unsigned int d = 0; d < VDimension; ++d )
+    {
+      const double   floor = std::floor( index[ d ] );
+      std::ptrdiff_t lower = static_cast< std::ptrdiff_t >( floor );
+      std::ptrdiff_t upper = lower + 1;
+      fraction[ d ] = index[ d ] - floor;
+      // Only the first and last half voxel can have neighbours outside the buffer
+      lower     = std::max( lower, this->m_First[ d ] );
+      upper     = std::min( upper, this->m_Last[ d ] );
+      base     += ( lower - this->m_First[ d ] ) * this->m_Stride[ d ];
+      step[ d ] = ( upper - lower ) * this->m_Stride[ d ];
+    }
+
+    double value = 0.0;
+    for( unsigned int corner = 0; corner < ( 1u << VDimension ); ++corner )
+    {
+      double         weight = 1.0;
+      std::ptrdiff_t offset = base;
+      for( unsigned int d = 0; d < VDimension; ++d )
+      {
+        if( corner & ( 1u << d ) )
+        {
+          weight *= fraction[ d ];
+          offset += step[ d ];
+        }
+        else
+        {
+          weight *= 1.0 - fraction[ d ];
+        }
+      }
+      value += weight * static_cast< double >( this->m_Buffer[ offset ] );
+    }
+    return value;
+  }
+
+
+  /** The range [begin, end) of k in [0, length) for which start + k * step is inside the buffer.
+   * The range is contiguous, since the index is linear in k. */
+  void InsideRange( const double * start, const double * step, std::size_t length, std::size_t & begin, std::size_t & end ) const
+  {
+    double lowest  = 0.0;
+    double highest = static_cast< double >( length ) - 1.0;
+    for( unsigned int d = 0; d < VDimension; ++d )
+    {
+      if( step[ d ] == 0.0 )
+      {
+        if( !( start[ d ] >= this->m_Lower[ d ] && start[ d ] < this->m_Upper[ d ] ) )
+        {
+          highest = -1.0;
+        }
+        continue;
+      }
+      const double atLower = ( this->m_Lower[ d ] - start[ d ] ) / step[ d ];
+      const double atUpper = ( this->m_Upper[ d ] - start[ d ] ) / step[ d ];
+      lowest  = std::max( lowest, std::min( atLower, atUpper ) );
+      highest = std::min( highest, std::max( atLower, atUpper ) );
+    }
+    if( highest < lowest )
+    {
+      begin = end = 0;
+      return;
+    }
+
+    // Widen by one voxel to be robust to rounding, then shrink to where the exact test passes
+    begin = static_cast< std::size_t >( std::max( std::ceil( lowest ) - 1.0, 0.0 ) );
+    end   = static_cast< std::size_t >( std::min( std::floor( highest ) + 2.0, static_cast< double >( length ) ) );
+    double index[ VDimension ];
+    auto   inside = [ & ]( std::size_t k ) {
+        for( unsigned int d = 0; d < VDimension; ++d )
+        {
+          index[ d ] = start[ d ] + k * step[ d ];
+        }
+        return this->IsInside( index );
+      };
+    while( begin < end && !inside( begin ) )
+    {
+      ++begin;
+    }
+    while( end > begin && !inside( end - 1 ) )
+    {
+      --end;
+    }
+  }
+
+private:
+
+  const TPixel * m_Buffer;
+  std::ptrdiff_t m_Stride[ VDimension ];
+  std::ptrdiff_t m_First[ VDimension ];
+  std::ptrdiff_t m_Last[ VDimension ];
+  double         m_Lower[ VDimension ];
+  double         m_Upper[ VDimension ];
+};
+
+/** Converts an interpolated value to an output pixel like itk::ResampleImageFilter does: values outside
+ * the range of the pixel type are clamped, others are truncated. */
+template< class TOutputPixel >
+inline TOutputPixel
+CastWithBoundsChecking( double value )
+{
+  const double minimum = static_cast< double >( std::numeric_limits< TOutputPixel >::lowest() );
+  const double maximum = static_cast< double >( std::numeric_limits< TOutputPixel >::max() );
+  return value < minimum ? std::numeric_limits< TOutputPixel >::lowest()
+       : value > maximum ? std::numeric_limits< TOutputPixel >::max()
+       : static_cast< TOutputPixel >( value );
+}
+
+
+/** Resamples the scanline of length voxels of which voxel k maps to continuous index start + k * step
+ * of the sampler. Voxels that map outside the buffer get defaultValue. */
+template< bool VLinear, class TInputPixel, class TOutputPixel, unsigned int VDimension >
+void
+ResampleAffineScanline( const BufferSampler< TInputPixel, VDimension > & sampler, const double * start, const double * step,
+  std::size_t length, TOutputPixel defaultValue, TOutputPixel * output )
+{
+  std::size_t begin, end;
+  sampler.InsideRange( start, step, length, begin, end );
+
+  std::fill( output, output + begin, defaultValue );
+  for( std::size_t k = begin; k < end; ++k )
+  {
+    double index[ VDimension ];
+    for( unsigned int d = 0; d < VDimension; ++d )
+    {
+      index[ d ] = start[ d ] + k * step[ d ];
+    }
+    output[ k ] = CastWithBoundsChecking< TOutputPixel >( VLinear ? sampler.Linear( index ) : sampler.Nearest( index ) );
+  }
+  std::fill( output + end, output + length, defaultValue );
+}
+
+/** Warps the scanline of length voxels of which voxel k maps to continuous index
+ * start + k * step + displacementToIndex * displacement[ k ] of the sampler, where displacementToIndex is a
+ * row-major matrix that maps a physical displacement to a displacement in continuous indices.
+ * Voxels that map outside the buffer get defaultValue. */
+template< bool VLinear, class TInputPixel, class TOutputPixel, class TDisplacement, unsigned int VDimension >
+void
+WarpScanline( const BufferSampler< TInputPixel, VDimension > & sampler, const double * start, const double * step,
+  const double * displacementToIndex, const TDisplacement * displacement, std::size_t length, TOutputPixel defaultValue,
+  TOutputPixel * output )
+{
+  for( std::size_t k = 0; k < length; ++k )
+  {
+    double index[ VDimension ];
+    for( unsigned int i = 0; i < VDimension; ++i )
+    {
+      index[ i ] = start[ i ] + k * step[ i ];
+      for( unsigned int j = 0; j < VDimension; ++j )
+      {
+        index[ i ] += displacementToIndex[ i * VDimension + j ] * static_cast< double >( displacement[ k ][ j ] );
+      }
+    }
+    output[ k ] = !sampler.IsInside( index ) ? defaultValue
+                : CastWithBoundsChecking< TOutputPixel >( VLinear ? sampler.Linear( index ) : sampler.Nearest( index ) );
+  }
+}
+} // end namespace selx
+
+#endif // selxResampleKernels_h
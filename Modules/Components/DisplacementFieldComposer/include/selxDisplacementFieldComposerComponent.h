@@ -67,6 +67,7 @@ public:
 
   // Base methods
   void BeforeUpdate() override;
+  void Update() override;
   bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
   static const char * GetDescription() { return "Warp a point set based on a deformation field"; };
 
@@ -55,15 +55,20 @@ void
 ItkDisplacementFieldComposerComponent< Dimensionality, TPixel, CoordRepType >
 ::BeforeUpdate()
 {
+  this->m_ComposeDisplacementFieldsImageFilter->SetDisplacementField( this->m_DisplacementField );
+  this->m_ComposeDisplacementFieldsImageFilter->SetWarpingField( this->m_WarpingDisplacementField );
+}
 
+template< int Dimensionality, class TPixel, class CoordRepType >
+void
+ItkDisplacementFieldComposerComponent< Dimensionality, TPixel, CoordRepType >
+::Update()
+{
+  // TODO: By default, the output region is copied to all inputs. Find out where it happens,
+  // and disable this behaviour. Until then, the input fields are buffered entirely before
+  // the composition is pulled by downstream components.
   this->m_DisplacementField->Update();
   this->m_WarpingDisplacementField->Update();
-
-  // TODO: By default, the output region is copied to all inputs. Find out where it happens,
-  // and disable this behaviour
-
-  this->m_ComposeDisplacementFieldsImageFilter->SetDisplacementField( this->m_DisplacementField );
-  this->m_ComposeDisplacementFieldsImageFilter->SetWarpingField( this->m_WarpingDisplacementField );
 }
 
 
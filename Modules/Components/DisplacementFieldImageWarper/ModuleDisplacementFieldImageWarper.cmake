@@ -21,4 +21,5 @@ set(${MODULE}_INCLUDE_DIRS
   ${${MODULE}_SOURCE_DIR}/interfaces)
 
 set( ${MODULE}_TEST_SOURCE_FILES
-  ${${MODULE}_SOURCE_DIR}/test/selxDisplacementFieldImageWarperTest.cxx)
+  ${${MODULE}_SOURCE_DIR}/test/selxDisplacementFieldImageWarperTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxDisplacementFieldWarpImageFilterTest.cxx)
@@ -23,9 +23,9 @@
 #include "selxSuperElastixComponent.h"
 #include "selxItkObjectInterfaces.h"
 
+#include "selxDisplacementFieldWarpImageFilter.h"
+
 #include "itkDisplacementFieldTransform.h"
-#include "itkResampleImageFilter.h"
-#include "itkNearestNeighborInterpolateImageFunction.h"
 
 namespace selx {
 
@@ -33,13 +33,13 @@ template< int Dimensionality, class TPixel, class CoordRepType >
 class ItkDisplacementFieldImageWarperComponent : public
   SuperElastixComponent<
   Accepting< itkImageMovingInterface< Dimensionality, TPixel >, itkDisplacementFieldInterface< Dimensionality, CoordRepType > >,
-  Providing< itkImageInterface< Dimensionality, TPixel > > >
+  Providing< itkImageInterface< Dimensionality, TPixel >, UpdateInterface > >
 {
 public:
   typedef ItkDisplacementFieldImageWarperComponent< Dimensionality, TPixel, CoordRepType > Self;
   typedef SuperElastixComponent<
     Accepting< itkImageMovingInterface< Dimensionality, TPixel >, itkDisplacementFieldInterface< Dimensionality, CoordRepType > >,
-    Providing< itkImageInterface< Dimensionality, TPixel > > > Superclass;
+    Providing< itkImageInterface< Dimensionality, TPixel >, UpdateInterface > > Superclass;
   typedef std::shared_ptr< Self > Pointer;
   typedef std::shared_ptr< const Self > ConstPointer;
 
@@ -66,11 +66,11 @@ public:
   using DisplacementFieldTransformType = itk::DisplacementFieldTransform< CoordRepType, Dimensionality >;
   using DisplacementFieldTransformPointer = typename DisplacementFieldTransformType::Pointer;
 
-  using ResampleImageFilterType = itk::ResampleImageFilter< MovingImageType, ResultImageType, CoordRepType >;
+  // Reads the displacements directly from the field, which lies on the output grid
+  using ResampleImageFilterType = DisplacementFieldWarpImageFilter< MovingImageType, ResultImageType, CoordRepType >;
   using ResampleImageFilterPointer = typename ResampleImageFilterType::Pointer;
 
-  using NearestNeighborInterpolatorType = itk::NearestNeighborInterpolateImageFunction<
-          ResultImageType, typename ResultImageType::PixelType>;
+  using NearestNeighborInterpolatorType = typename ResampleImageFilterType::NearestNeighborInterpolatorType;
   using NearestNeighborInterpolatorTypePointer = typename NearestNeighborInterpolatorType::Pointer;
 
   // Accept interfaces
@@ -79,6 +79,7 @@ public:
 
   // Provide interfaces
   virtual ResultImagePointer GetItkImage() override;
+  virtual void Update() override;
 
   // Base methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
@@ -99,6 +100,7 @@ protected:
 
 private:
 
+  DisplacementFieldPointer m_DisplacementField;
   DisplacementFieldTransformPointer m_DisplacementFieldTransform;
   ResampleImageFilterPointer m_ResampleImageFilter;
 
@@ -40,10 +40,10 @@ int
 ItkDisplacementFieldImageWarperComponent< Dimensionality, TPixel, CoordRepType >
 ::Accept( DisplacementFieldInterfacePointer itkDisplacementFieldInterface )
 {
-  auto displacementField = itkDisplacementFieldInterface->GetItkDisplacementField();
-  displacementField->Update();
-  this->m_DisplacementFieldTransform->SetDisplacementField( displacementField );
-  this->m_ResampleImageFilter->SetOutputParametersFromImage( displacementField );
+  // Only the geometry of the displacement field is needed to configure the warp. Its pixel data is read in Update.
+  this->m_DisplacementField = itkDisplacementFieldInterface->GetItkDisplacementField();
+  this->m_DisplacementField->UpdateOutputInformation();
+  this->m_ResampleImageFilter->SetOutputParametersFromImage( this->m_DisplacementField );
 
   return 0;
 }
@@ -66,6 +66,23 @@ ItkDisplacementFieldImageWarperComponent< Dimensionality, TPixel, CoordRepType >
   return this->m_ResampleImageFilter->GetOutput();
 }
 
+template< int Dimensionality, class TPixel, class CoordRepType >
+void
+ItkDisplacementFieldImageWarperComponent< Dimensionality, TPixel, CoordRepType >
+::Update()
+{
+  this->m_DisplacementField->Update();
+
+  // SetDisplacementField does nothing if the field is the same object, so a new transform picks up the new pixel data
+  this->m_DisplacementFieldTransform = DisplacementFieldTransformType::New();
+  this->m_DisplacementFieldTransform->SetDisplacementField( this->m_DisplacementField );
+  this->m_ResampleImageFilter->SetTransform( this->m_DisplacementFieldTransform.GetPointer() );
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    this->m_ResampleImageFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+  }
+}
+
 template< int Dimensionality, class TPixel, class CoordRepType >
 bool
 ItkDisplacementFieldImageWarperComponent< Dimensionality, TPixel, CoordRepType >
@@ -0,0 +1,118 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxDisplacementFieldWarpImageFilter_h
+#define selxDisplacementFieldWarpImageFilter_h
+
+#include "itkResampleImageFilter.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+
+#include <type_traits>
+
+namespace selx
+{
+/** \class DisplacementFieldWarpImageFilter
+ * \brief ResampleImageFilter with a dedicated kernel for displacement field transforms whose field
+ * lies on the output grid.
+ *
+ * If the transform is an itk::DisplacementFieldTransform with the same origin, spacing and direction as the
+ * output, its field buffers the requested output region, the interpolator is linear or nearest neighbour,
+ * no extrapolator is set and the pixels are scalars, the displacement of each output voxel is read directly
+ * from the field by index. This skips the conversions between points and indices and the interpolation of
+ * the field by the transform, which are exact at the grid points anyway, as well as the virtual Evaluate of
+ * the image interpolator. Threads warp slabs of the output.
+ *
+ * Otherwise the filter falls back to the generic path of itk::ResampleImageFilter.
+ */
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType = double,
+class TTransformPrecisionType = TInterpolatorPrecisionType >
+class DisplacementFieldWarpImageFilter :
+  public itk::ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+{
+public:
+
+  /** Standard class typedefs. */
+  typedef DisplacementFieldWarpImageFilter Self;
+  typedef itk::ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType,
+    TTransformPrecisionType >                Superclass;
+  typedef itk::SmartPointer< Self >       Pointer;
+  typedef itk::SmartPointer< const Self > ConstPointer;
+
+  itkNewMacro( Self );
+  itkTypeMacro( DisplacementFieldWarpImageFilter, ResampleImageFilter );
+
+  itkStaticConstMacro( ImageDimension, unsigned int, TOutputImage::ImageDimension );
+
+  typedef typename Superclass::InputImageType        InputImageType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename InputImageType::PixelType         InputPixelType;
+  typedef typename OutputImageType::PixelType        OutputPixelType;
+
+  typedef itk::DisplacementFieldTransform< TTransformPrecisionType, ImageDimension > DisplacementFieldTransformType;
+  typedef typename DisplacementFieldTransformType::DisplacementFieldType              DisplacementFieldType;
+
+  typedef itk::LinearInterpolateImageFunction< InputImageType, TInterpolatorPrecisionType >          LinearInterpolatorType;
+  typedef itk::NearestNeighborInterpolateImageFunction< InputImageType, TInterpolatorPrecisionType > NearestNeighborInterpolatorType;
+
+  /** Whether the last update used the dedicated kernel */
+  itkGetConstMacro( FastPath, bool );
+
+protected:
+
+  DisplacementFieldWarpImageFilter();
+  ~DisplacementFieldWarpImageFilter() {}
+
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  void ThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+
+  ITK_DISALLOW_COPY_AND_ASSIGN( DisplacementFieldWarpImageFilter );
+
+  typedef std::integral_constant< bool, std::is_arithmetic< InputPixelType >::value
+    && std::is_arithmetic< OutputPixelType >::value > HasScalarPixels;
+
+  void FastThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId, std::true_type );
+
+  void FastThreadedGenerateData( const OutputImageRegionType &, itk::ThreadIdType, std::false_type ) {}
+
+  bool m_FastPath;
+  bool m_NearestNeighbor;
+
+  const DisplacementFieldType * m_DisplacementField;
+
+  /** Maps an output index to a continuous input index, without displacement */
+  double m_IndexMatrix[ ImageDimension ][ ImageDimension ];
+  double m_IndexOffset[ ImageDimension ];
+
+  /** Maps a physical displacement to a displacement in continuous input indices, row-major */
+  double m_DisplacementToIndex[ ImageDimension * ImageDimension ];
+};
+} // end namespace selx
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxDisplacementFieldWarpImageFilter.hxx"
+#endif
+
+#endif // selxDisplacementFieldWarpImageFilter_h
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxDisplacementFieldWarpImageFilter_hxx
+#define selxDisplacementFieldWarpImageFilter_hxx
+
+#include "selxDisplacementFieldWarpImageFilter.h"
+#include "selxResampleKernels.h"
+
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+namespace selx
+{
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+DisplacementFieldWarpImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::DisplacementFieldWarpImageFilter() :
+  m_FastPath( false ),
+  m_NearestNeighbor( false ),
+  m_DisplacementField( nullptr )
+{
+}
+
+
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+void
+DisplacementFieldWarpImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  const InputImageType *  input        = this->GetInput();
+  const OutputImageType * output       = this->GetOutput();
+  const auto *            interpolator = this->GetInterpolator();
+  const auto *            transform    = dynamic_cast< const DisplacementFieldTransformType * >( this->GetTransform() );
+
+  this->m_DisplacementField = transform ? transform->GetDisplacementField() : nullptr;
+  this->m_NearestNeighbor   = dynamic_cast< const NearestNeighborInterpolatorType * >( interpolator ) != nullptr;
+  this->m_FastPath          = HasScalarPixels::value
+    && this->m_DisplacementField != nullptr
+    && this->m_DisplacementField->GetOrigin() == output->GetOrigin()
+    && this->m_DisplacementField->GetSpacing() == output->GetSpacing()
+    && this->m_DisplacementField->GetDirection() == output->GetDirection()
+    && this->m_DisplacementField->GetBufferedRegion().IsInside( output->GetRequestedRegion() )
+    && this->GetExtrapolator() == nullptr
+    && ( this->m_NearestNeighbor || dynamic_cast< const LinearInterpolatorType * >( interpolator ) != nullptr )
+    && input->GetBufferedRegion().GetNumberOfPixels() > 0;
+  if( !this->m_FastPath )
+  {
+    return;
+  }
+
+  // index = inputPointToIndex * ( outputOrigin + outputIndexToPoint * outputIndex + displacement - inputOrigin )
+  const auto & outputIndexToPoint = output->GetIndexToPhysicalPoint();
+  const auto & inputPointToIndex  = input->GetPhysicalPointToIndex();
+  const auto & outputOrigin       = output->GetOrigin();
+  const auto & inputOrigin        = input->GetOrigin();
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    this->m_IndexOffset[ i ] = 0.0;
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+      this->m_DisplacementToIndex[ i * ImageDimension + j ] = inputPointToIndex[ i ][ j ];
+      this->m_IndexOffset[ i ] += inputPointToIndex[ i ][ j ] * ( outputOrigin[ j ] - inputOrigin[ j ] );
+      this->m_IndexMatrix[ i ][ j ] = 0.0;
+      for( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+        this->m_IndexMatrix[ i ][ j ] += inputPointToIndex[ i ][ k ] * outputIndexToPoint[ k ][ j ];
+      }
+    }
+  }
+}
+
+
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+void
+DisplacementFieldWarpImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::ThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId )
+{
+  if( !this->m_FastPath )
+  {
+    Superclass::ThreadedGenerateData( outputRegionForThread, threadId );
+    return;
+  }
+  this->FastThreadedGenerateData( outputRegionForThread, threadId, HasScalarPixels() );
+}
+
+
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+void
+DisplacementFieldWarpImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::FastThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId, std::true_type )
+{
+  if( outputRegionForThread.GetNumberOfPixels() == 0 )
+  {
+    return;
+  }
+
+  const InputImageType *        input  = this->GetInput();
+  OutputImageType *             output = this->GetOutput();
+  const DisplacementFieldType * field  = this->m_DisplacementField;
+  const BufferSampler< InputPixelType, ImageDimension > sampler( input->GetBufferPointer(),
+    input->GetBufferedRegion().GetIndex(), input->GetBufferedRegion().GetSize() );
+  const OutputPixelType defaultValue = this->GetDefaultPixelValue();
+
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+  double            step[ ImageDimension ];
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    step[ i ] = this->m_IndexMatrix[ i ][ 0 ];
+  }
+
+  itk::ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  itk::ImageScanlineIterator< OutputImageType > it( output, outputRegionForThread );
+  while( !it.IsAtEnd() )
+  {
+    const auto index = it.GetIndex();
+    double     start[ ImageDimension ];
+    for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+      start[ i ] = this->m_IndexOffset[ i ];
+      for( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+        start[ i ] += this->m_IndexMatrix[ i ][ j ] * index[ j ];
+      }
+    }
+
+    // The field lies on the output grid, so the output index is also the index of the displacement
+    const auto *      displacement = field->GetBufferPointer() + field->ComputeOffset( index );
+    OutputPixelType * line         = output->GetBufferPointer() + output->ComputeOffset( index );
+    if( this->m_NearestNeighbor )
+    {
+      WarpScanline< false >( sampler, start, step, this->m_DisplacementToIndex, displacement, lineLength, defaultValue, line );
+    }
+    else
+    {
+      WarpScanline< true >( sampler, start, step, this->m_DisplacementToIndex, displacement, lineLength, defaultValue, line );
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  }
+}
+} // end namespace selx
+
+#endif // selxDisplacementFieldWarpImageFilter_hxx
@@ -0,0 +1,157 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxDisplacementFieldWarpImageFilter.h"
+#include "selxTestUtilities.h"
+
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace selx
+{
+class DisplacementFieldWarpImageFilterTest : public ::testing::Test
+{
+public:
+
+  typedef itk::Image< float, 3 >                                                 ImageType;
+  typedef itk::ResampleImageFilter< ImageType, ImageType, float >                GenericWarpFilterType;
+  typedef DisplacementFieldWarpImageFilter< ImageType, ImageType, float >        WarpFilterType;
+  typedef WarpFilterType::DisplacementFieldTransformType                         DisplacementFieldTransformType;
+  typedef WarpFilterType::DisplacementFieldType                                  DisplacementFieldType;
+
+  static ImageType::Pointer MakeImage( unsigned int size )
+  {
+    ImageType::SpacingType spacing;
+    spacing[ 0 ] = 1.0;
+    spacing[ 1 ] = 1.5;
+    spacing[ 2 ] = 2.0;
+    ImageType::PointType origin;
+    origin.Fill( 0.0 );
+    return TestUtilities::MakeSinCosImage< ImageType >( size, spacing, origin );
+  }
+
+
+  /** A smooth field on the grid of the image */
+  static DisplacementFieldTransformType::Pointer MakeTransform( const ImageType * image )
+  {
+    auto field = DisplacementFieldType::New();
+    field->CopyInformation( image );
+    field->SetRegions( image->GetLargestPossibleRegion() );
+    field->Allocate();
+    itk::ImageRegionIteratorWithIndex< DisplacementFieldType > it( field, field->GetLargestPossibleRegion() );
+    for( ; !it.IsAtEnd(); ++it )
+    {
+      const auto &                     index = it.GetIndex();
+      DisplacementFieldType::PixelType displacement;
+      displacement[ 0 ] = 3.0 * std::sin( 0.05 * index[ 1 ] );
+      displacement[ 1 ] = 2.0 * std::cos( 0.04 * index[ 2 ] ) - 1.0;
+      displacement[ 2 ] = 0.13 * index[ 0 ];
+      it.Set( displacement );
+    }
+    auto transform = DisplacementFieldTransformType::New();
+    transform->SetDisplacementField( field );
+    return transform;
+  }
+
+
+  template< class TFilter >
+  static typename TFilter::Pointer MakeFilter( const ImageType * image, const DisplacementFieldTransformType * transform, bool nearestNeighbor )
+  {
+    return TestUtilities::MakeResampleFilter< TFilter >( image, transform, transform->GetDisplacementField(), nearestNeighbor );
+  }
+
+
+  static void ExpectNear( const ImageType * expected, const ImageType * actual, double tolerance )
+  {
+    // Voxels that map within rounding errors of the border of the input, or of a rounding boundary of the
+    // nearest neighbour, may differ
+    TestUtilities::ExpectImagesNear( expected, actual, tolerance, 1e-3 );
+  }
+
+
+  void Benchmark( unsigned int size )
+  {
+    auto image     = MakeImage( size );
+    auto transform = MakeTransform( image );
+
+    std::cout << "Displacement field warp of " << size << "^3 voxels (float):" << std::endl;
+    for( bool nearestNeighbor : { false, true } )
+    {
+      auto         genericFilter = MakeFilter< GenericWarpFilterType >( image, transform, nearestNeighbor );
+      auto         fastFilter    = MakeFilter< WarpFilterType >( image, transform, nearestNeighbor );
+      const double generic       = TestUtilities::MeasureMilliseconds( [ & ]() { genericFilter->Update(); } );
+      const double fast          = TestUtilities::MeasureMilliseconds( [ & ]() { fastFilter->Update(); } );
+      // The timings are only meaningful if the fast path was taken
+      EXPECT_TRUE( fastFilter->GetFastPath() );
+      std::cout << ( nearestNeighbor ? "  nearest neighbour" : "  linear           " )
+                << ": itk::ResampleImageFilter " << generic << " ms, warp kernel " << fast << " ms" << std::endl;
+    }
+  }
+};
+
+TEST_F( DisplacementFieldWarpImageFilterTest, FieldOnOutputGrid )
+{
+  auto image     = MakeImage( 40 );
+  auto transform = MakeTransform( image );
+
+  for( bool nearestNeighbor : { false, true } )
+  {
+    auto expected = MakeFilter< GenericWarpFilterType >( image, transform, nearestNeighbor );
+    auto actual   = MakeFilter< WarpFilterType >( image, transform, nearestNeighbor );
+    expected->Update();
+    actual->Update();
+    EXPECT_TRUE( actual->GetFastPath() );
+    ExpectNear( expected->GetOutput(), actual->GetOutput(), 1e-2 );
+  }
+}
+
+TEST_F( DisplacementFieldWarpImageFilterTest, FallsBackIfFieldIsNotOnOutputGrid )
+{
+  auto image     = MakeImage( 20 );
+  auto transform = MakeTransform( image );
+
+  auto expected = MakeFilter< GenericWarpFilterType >( image, transform, false );
+  auto actual   = MakeFilter< WarpFilterType >( image, transform, false );
+  ImageType::SpacingType spacing = image->GetSpacing() * 0.5;
+  expected->SetOutputSpacing( spacing );
+  actual->SetOutputSpacing( spacing );
+  expected->Update();
+  actual->Update();
+  EXPECT_FALSE( actual->GetFastPath() );
+  ExpectNear( expected->GetOutput(), actual->GetOutput(), 0.0 );
+}
+
+#ifdef SUPERELASTIX_BUILD_LONG_UNIT_TESTS
+TEST_F( DisplacementFieldWarpImageFilterTest, Benchmark )
+{
+  this->Benchmark( 128 );
+}
+#endif
+
+// Needs about 1 GB of memory, run with --gtest_also_run_disabled_tests
+TEST_F( DisplacementFieldWarpImageFilterTest, DISABLED_Benchmark256 )
+{
+  this->Benchmark( 256 );
+}
+} // namespace selx
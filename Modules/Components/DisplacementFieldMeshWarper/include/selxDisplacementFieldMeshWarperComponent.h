@@ -32,13 +32,13 @@ template< int Dimensionality, class TPixel, class CoordRepType >
 class ItkDisplacementFieldMeshWarperComponent : public
   SuperElastixComponent<
   Accepting< itkMeshInterface< Dimensionality, CoordRepType >, itkDisplacementFieldInterface< Dimensionality, TPixel > >,
-  Providing< itkMeshInterface< Dimensionality, CoordRepType > > >
+  Providing< itkMeshInterface< Dimensionality, CoordRepType >, UpdateInterface > >
 {
 public:
   typedef ItkDisplacementFieldMeshWarperComponent< Dimensionality, TPixel, CoordRepType > Self;
   typedef SuperElastixComponent<
     Accepting< itkMeshInterface< Dimensionality, CoordRepType >, itkDisplacementFieldInterface< Dimensionality, TPixel > >,
-    Providing< itkMeshInterface< Dimensionality, CoordRepType > > > Superclass;
+    Providing< itkMeshInterface< Dimensionality, CoordRepType >, UpdateInterface > > Superclass;
   typedef std::shared_ptr< Self > Pointer;
   typedef std::shared_ptr< const Self > ConstPointer;
 
@@ -68,6 +68,7 @@ public:
 
   // Provide interfaces
   virtual typename ItkMeshType::Pointer GetItkMesh() override;
+  virtual void Update() override;
 
   // Base methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
@@ -88,6 +89,7 @@ protected:
 
 private:
 
+  ItkDisplacementFieldPointer m_DisplacementField;
   ItkDisplacementFieldTransformPointer m_DisplacementFieldTransform;
   ItkTransformMeshFilterPointer m_TransformMeshFilter;
 
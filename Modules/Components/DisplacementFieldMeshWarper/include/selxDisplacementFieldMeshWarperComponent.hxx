@@ -39,10 +39,8 @@ int
 ItkDisplacementFieldMeshWarperComponent< Dimensionality, TPixel, CoordRepType >
 ::Accept( ItkDisplacementFieldInterfacePointer itkDisplacementFieldInterface )
 {
-  auto displacementField = itkDisplacementFieldInterface->GetItkDisplacementField();
-  displacementField->Update(); // Needed to load world info before transform is run
-  displacementField->SetBufferedRegion(displacementField->GetRequestedRegion());
-  this->m_DisplacementFieldTransform->SetDisplacementField( displacementField );
+  // The pixel data of the displacement field is read in Update
+  this->m_DisplacementField = itkDisplacementFieldInterface->GetItkDisplacementField();
 
   return 0;
 }
@@ -65,6 +63,20 @@ ItkDisplacementFieldMeshWarperComponent< Dimensionality, TPixel, CoordRepType >
   return this->m_TransformMeshFilter->GetOutput();
 }
 
+template< int Dimensionality, class TPixel, class CoordRepType >
+void
+ItkDisplacementFieldMeshWarperComponent< Dimensionality, TPixel, CoordRepType >
+::Update()
+{
+  this->m_DisplacementField->Update();
+  this->m_DisplacementField->SetBufferedRegion( this->m_DisplacementField->GetRequestedRegion() );
+
+  // SetDisplacementField does nothing if the field is the same object, so a new transform picks up the new pixel data
+  this->m_DisplacementFieldTransform = ItkDisplacementFieldTransformType::New();
+  this->m_DisplacementFieldTransform->SetDisplacementField( this->m_DisplacementField );
+  this->m_TransformMeshFilter->SetTransform( this->m_DisplacementFieldTransform );
+}
+
 template< int Dimensionality, class TPixel, class CoordRepType >
 bool
 ItkDisplacementFieldMeshWarperComponent< Dimensionality, TPixel, CoordRepType >
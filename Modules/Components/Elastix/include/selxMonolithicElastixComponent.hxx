@@ -105,6 +105,11 @@ void
 MonolithicElastixComponent< Dimensionality, TPixel >::Update( void )
 {
   this->m_ElastixFilter->SetParameterObject(this->m_ParameterObject);
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    // The filters elastix creates internally are limited by the global maximum of ThreadBudget::SetNumberOfThreads
+    this->m_ElastixFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+  }
   this->m_ElastixFilter->Update();
 }
 
@@ -0,0 +1,73 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxImagePyramid_h
+#define selxImagePyramid_h
+
+#include "itkImage.h"
+#include "itkContinuousIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace selx
+{
+/** The domain of the image that itk::ShrinkImageFilter produces from an image with the given domain, derived
+ * without running the filter or touching any pixels. This is the geometry of a level of the pyramids of the
+ * ITKv4 registration methods, as needed by their transform parameters adaptors. */
+template< unsigned int Dimensionality >
+typename itk::ImageBase< Dimensionality >::Pointer
+ShrinkImageDomain( const itk::ImageBase< Dimensionality > * domain, const itk::FixedArray< unsigned int, Dimensionality > & shrinkFactors )
+{
+  typedef itk::ImageBase< Dimensionality > ImageDomainType;
+  typedef itk::ContinuousIndex< double, Dimensionality > ContinuousIndexType;
+
+  const typename ImageDomainType::RegionType & inputRegion = domain->GetLargestPossibleRegion();
+
+  typename ImageDomainType::SpacingType spacing;
+  typename ImageDomainType::RegionType  region;
+  ContinuousIndexType                   inputCenterIndex;
+  ContinuousIndexType                   centerIndex;
+  for( unsigned int d = 0; d < Dimensionality; ++d )
+  {
+    const double shrinkFactor = static_cast< double >( shrinkFactors[ d ] );
+    spacing[ d ] = domain->GetSpacing()[ d ] * shrinkFactor;
+    region.SetSize( d, std::max< itk::SizeValueType >( 1, static_cast< itk::SizeValueType >( std::floor( inputRegion.GetSize( d ) / shrinkFactor ) ) ) );
+    region.SetIndex( d, static_cast< itk::IndexValueType >( std::ceil( inputRegion.GetIndex( d ) / shrinkFactor ) ) );
+    inputCenterIndex[ d ] = inputRegion.GetIndex( d ) + ( inputRegion.GetSize( d ) - 1 ) / 2.0;
+    centerIndex[ d ]      = region.GetIndex( d ) + ( region.GetSize( d ) - 1 ) / 2.0;
+  }
+
+  typename ImageDomainType::Pointer shrunkDomain = ImageDomainType::New();
+  shrunkDomain->CopyInformation( domain );
+  shrunkDomain->SetSpacing( spacing );
+  shrunkDomain->SetRegions( region );
+
+  // As itk::ShrinkImageFilter, keep the physical centers of the domains at the same point
+  typename ImageDomainType::PointType inputCenter;
+  typename ImageDomainType::PointType center;
+  domain->TransformContinuousIndexToPhysicalPoint( inputCenterIndex, inputCenter );
+  shrunkDomain->TransformContinuousIndexToPhysicalPoint( centerIndex, center );
+  shrunkDomain->SetOrigin( domain->GetOrigin() + ( inputCenter - center ) );
+  return shrunkDomain;
+}
+} // end namespace selx
+
+#endif // selxImagePyramid_h
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxItkImagePyramidComponent_h
+#define selxItkImagePyramidComponent_h
+
+#include "selxSuperElastixComponent.h"
+
+#include "selxSinksAndSourcesInterfaces.h"
+#include "selxItkObjectInterfaces.h"
+#include "selxImagePyramidInterfaces.h"
+
+#include "selxImagePyramid.h"
+
+#include <vector>
+
+namespace selx
+{
+/** Provides one multi-resolution schedule of its input image to any number of components, such as the
+ * registration methods and their transform parameters adaptors, which then agree on the levels. The geometry of
+ * the levels is derived analytically, without computing pixels.
+ *
+ * Settings:
+ *   ShrinkFactorsPerLevel: one isotropic shrink factor per level, coarsest level first
+ *   SmoothingSigmasPerLevel: one standard deviation in physical units per level, 0 for no smoothing
+ */
+template< int Dimensionality, class TPixel >
+class ItkImagePyramidComponent :
+  public SuperElastixComponent<
+  Accepting< itkImageInterface< Dimensionality, TPixel >>,
+  Providing< itkImagePyramidInterface< Dimensionality >>
+  >
+{
+public:
+
+  /** Standard typedefs. */
+  typedef ItkImagePyramidComponent<
+    Dimensionality, TPixel
+    >                                      Self;
+  typedef SuperElastixComponent<
+    Accepting< itkImageInterface< Dimensionality, TPixel >>,
+    Providing< itkImagePyramidInterface< Dimensionality >>
+    >                                      Superclass;
+  typedef std::shared_ptr< Self >       Pointer;
+  typedef std::shared_ptr< const Self > ConstPointer;
+
+  ItkImagePyramidComponent( const std::string & name, LoggerImpl & logger );
+  virtual ~ItkImagePyramidComponent();
+
+  typedef TPixel                                                                  PixelType;
+  typedef typename itkImageInterface< Dimensionality, TPixel >::ItkImageType      ItkImageType;
+  typedef typename ItkImageType::Pointer                                          ItkImagePointer;
+  typedef typename itkImagePyramidInterface< Dimensionality >::ItkImageDomainType ItkImageDomainType;
+  typedef typename ItkImageDomainType::Pointer                                    ItkImageDomainPointer;
+
+  // Accepting Interfaces:
+  virtual int Accept( typename itkImageInterface< Dimensionality, TPixel >::Pointer ) override;
+
+  // Providing Interfaces:
+  virtual unsigned int GetNumberOfLevels() override;
+
+  virtual unsigned int GetShrinkFactorAtLevel( unsigned int level ) override;
+
+  virtual double GetSmoothingSigmaAtLevel( unsigned int level ) override;
+
+  virtual ItkImageDomainPointer GetItkImageDomainAtLevel( unsigned int level ) override;
+
+  virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
+
+  static const char * GetDescription() { return "ItkImagePyramid Component"; }
+
+private:
+
+  void CheckLevel( unsigned int level ) const;
+
+  ItkImagePointer m_Image;
+
+  std::vector< unsigned int > m_ShrinkFactorsPerLevel;
+  std::vector< double >       m_SmoothingSigmasPerLevel;
+
+protected:
+
+  // return the class name and the template arguments to uniquely identify this component.
+  static inline const std::map< std::string, std::string > TemplateProperties()
+  {
+    return { { keys::NameOfClass, "ItkImagePyramidComponent" }, { keys::PixelType, PodString< TPixel >::Get() }, { keys::Dimensionality, std::to_string( Dimensionality ) } };
+  }
+};
+} //end namespace selx
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxItkImagePyramidComponent.hxx"
+#endif
+#endif // #define selxItkImagePyramidComponent_h
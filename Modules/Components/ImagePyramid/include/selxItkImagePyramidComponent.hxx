@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxItkImagePyramidComponent.h"
+#include "selxCheckTemplateProperties.h"
+
+#include <stdexcept>
+
+namespace selx
+{
+template< int Dimensionality, class TPixel >
+ItkImagePyramidComponent< Dimensionality, TPixel >::ItkImagePyramidComponent(
+  const std::string & name, LoggerImpl & logger ) : Superclass( name, logger )
+{
+}
+
+
+template< int Dimensionality, class TPixel >
+ItkImagePyramidComponent< Dimensionality, TPixel >::~ItkImagePyramidComponent()
+{
+}
+
+
+template< int Dimensionality, class TPixel >
+int
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::Accept( typename itkImageInterface< Dimensionality, TPixel >::Pointer component )
+{
+  this->m_Image = component->GetItkImage();
+  return 0;
+}
+
+
+template< int Dimensionality, class TPixel >
+unsigned int
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::GetNumberOfLevels()
+{
+  // Either setting implies the number of levels, MeetsCriterion rejects conflicting numbers
+  return static_cast< unsigned int >( std::max( this->m_ShrinkFactorsPerLevel.size(), this->m_SmoothingSigmasPerLevel.size() ) );
+}
+
+
+template< int Dimensionality, class TPixel >
+unsigned int
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::GetShrinkFactorAtLevel( unsigned int level )
+{
+  this->CheckLevel( level );
+  return this->m_ShrinkFactorsPerLevel.empty() ? 1 : this->m_ShrinkFactorsPerLevel[ level ];
+}
+
+
+template< int Dimensionality, class TPixel >
+double
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::GetSmoothingSigmaAtLevel( unsigned int level )
+{
+  this->CheckLevel( level );
+  return this->m_SmoothingSigmasPerLevel.empty() ? 0.0 : this->m_SmoothingSigmasPerLevel[ level ];
+}
+
+
+template< int Dimensionality, class TPixel >
+typename ItkImagePyramidComponent< Dimensionality, TPixel >::ItkImageDomainPointer
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::GetItkImageDomainAtLevel( unsigned int level )
+{
+  itk::FixedArray< unsigned int, Dimensionality > shrinkFactors;
+  shrinkFactors.Fill( this->GetShrinkFactorAtLevel( level ) );
+
+  this->m_Image->UpdateOutputInformation();
+  return ShrinkImageDomain< Dimensionality >( this->m_Image.GetPointer(), shrinkFactors );
+}
+
+
+template< int Dimensionality, class TPixel >
+void
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::CheckLevel( unsigned int level ) const
+{
+  const std::size_t numberOfLevels = std::max( this->m_ShrinkFactorsPerLevel.size(), this->m_SmoothingSigmasPerLevel.size() );
+  if( level >= numberOfLevels )
+  {
+    throw std::runtime_error( this->m_Name + ": level " + std::to_string( level ) + " requested from a pyramid of "
+      + std::to_string( numberOfLevels ) + " levels." );
+  }
+}
+
+
+template< int Dimensionality, class TPixel >
+bool
+ItkImagePyramidComponent< Dimensionality, TPixel >
+::MeetsCriterion( const ComponentBase::CriterionType & criterion )
+{
+  auto status = CheckTemplateProperties( this->TemplateProperties(), criterion );
+  if( status == CriterionStatus::Satisfied )
+  {
+    return true;
+  }
+  else if( status == CriterionStatus::Failed )
+  {
+    return false;
+  } // else: CriterionStatus::Unknown
+
+  try
+  {
+    if( criterion.first == "ShrinkFactorsPerLevel" )
+    {
+      if( !this->m_SmoothingSigmasPerLevel.empty() && this->m_SmoothingSigmasPerLevel.size() != criterion.second.size() )
+      {
+        this->m_Logger.Log( LogLevel::ERR, "{0}: ShrinkFactorsPerLevel and SmoothingSigmasPerLevel imply different numbers of levels.", this->m_Name );
+        return false;
+      }
+      this->m_ShrinkFactorsPerLevel.clear();
+      for( const auto & criterionValue : criterion.second )
+      {
+        const int shrinkFactor = std::stoi( criterionValue );
+        if( shrinkFactor < 1 )
+        {
+          this->m_Logger.Log( LogLevel::ERR, "{0}: Shrink factors must be at least 1, got {1}.", this->m_Name, criterionValue );
+          return false;
+        }
+        this->m_ShrinkFactorsPerLevel.push_back( static_cast< unsigned int >( shrinkFactor ) );
+      }
+      return true;
+    }
+    else if( criterion.first == "SmoothingSigmasPerLevel" )
+    {
+      if( !this->m_ShrinkFactorsPerLevel.empty() && this->m_ShrinkFactorsPerLevel.size() != criterion.second.size() )
+      {
+        this->m_Logger.Log( LogLevel::ERR, "{0}: ShrinkFactorsPerLevel and SmoothingSigmasPerLevel imply different numbers of levels.", this->m_Name );
+        return false;
+      }
+      this->m_SmoothingSigmasPerLevel.clear();
+      for( const auto & criterionValue : criterion.second )
+      {
+        this->m_SmoothingSigmasPerLevel.push_back( std::stod( criterionValue ) );
+      }
+      return true;
+    }
+  }
+  catch( std::logic_error & )
+  {
+    // std::stoi and std::stod throw std::invalid_argument or std::out_of_range
+    this->m_Logger.Log( LogLevel::ERR, "{0}: Expected numbers for {1}.", this->m_Name, criterion.first );
+  }
+  return false;
+}
+} //end namespace selx
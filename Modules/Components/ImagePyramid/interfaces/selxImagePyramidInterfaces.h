@@ -0,0 +1,63 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxImagePyramidInterfaces_h
+#define selxImagePyramidInterfaces_h
+
+#include "selxInterfaceTraits.h"
+#include "itkImageBase.h"
+
+namespace selx
+{
+template< int Dimensionality >
+class itkImagePyramidInterface
+{
+  // An interface that provides the schedule and the geometry of the levels of a multi-resolution pyramid of an
+  // image. Level 0 is the coarsest level. Registration methods smooth and shrink internally by this schedule,
+  // the geometry is what their transform parameters adaptors need.
+
+public:
+
+  using Type    = itkImagePyramidInterface< Dimensionality >;
+  using Pointer = std::shared_ptr< Type >;
+  typedef typename itk::ImageBase< Dimensionality > ItkImageDomainType;
+
+  virtual unsigned int GetNumberOfLevels() = 0;
+
+  // The isotropic shrink factor and the smoothing standard deviation in physical units of a level
+  virtual unsigned int GetShrinkFactorAtLevel( unsigned int level ) = 0;
+
+  virtual double GetSmoothingSigmaAtLevel( unsigned int level ) = 0;
+
+  // The origin, spacing, direction and region of a level, derived without computing its pixels
+  virtual typename ItkImageDomainType::Pointer GetItkImageDomainAtLevel( unsigned int level ) = 0;
+};
+
+template< int D >
+struct Properties< itkImagePyramidInterface< D >>
+{
+  static const std::map< std::string, std::string > Get()
+  {
+    return { { keys::NameOfInterface, "itkImagePyramidInterface" }, { keys::Dimensionality, std::to_string( D ) } };
+  }
+};
+} // end namespace selx
+
+#endif // #define selxImagePyramidInterfaces_h
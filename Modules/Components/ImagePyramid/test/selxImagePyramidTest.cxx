@@ -0,0 +1,126 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxImagePyramid.h"
+#include "selxItkImagePyramidComponent.h"
+
+#include "itkShrinkImageFilter.h"
+
+#include "gtest/gtest.h"
+
+namespace selx
+{
+class ImagePyramidTest : public ::testing::Test
+{
+public:
+
+  typedef itk::Image< float, 3 > ImageType;
+  typedef itk::Image< float, 2 > Image2DType;
+
+  class ImageProvider : public itkImageInterface< 2, float >
+  {
+  public:
+
+    Image2DType::Pointer GetItkImage() override { return this->image; }
+    Image2DType::Pointer image;
+  };
+
+  static void ExpectEqualDomains( const itk::ImageBase< 3 > * expected, const itk::ImageBase< 3 > * domain )
+  {
+    EXPECT_EQ( expected->GetLargestPossibleRegion(), domain->GetLargestPossibleRegion() );
+    for( unsigned int d = 0; d < 3; ++d )
+    {
+      EXPECT_DOUBLE_EQ( expected->GetSpacing()[ d ], domain->GetSpacing()[ d ] );
+      EXPECT_NEAR( expected->GetOrigin()[ d ], domain->GetOrigin()[ d ], 1e-9 );
+    }
+    EXPECT_EQ( expected->GetDirection(), domain->GetDirection() );
+  }
+};
+
+TEST_F( ImagePyramidTest, ShrinkImageDomain )
+{
+  ImageType::IndexType index = { { 3, -5, 0 } };
+  ImageType::SizeType  size  = { { 17, 32, 9 } };
+  ImageType::SpacingType spacing;
+  spacing[ 0 ] = 0.8; spacing[ 1 ] = 1.0; spacing[ 2 ] = 2.5;
+  ImageType::PointType origin;
+  origin[ 0 ] = -12.0; origin[ 1 ] = 4.5; origin[ 2 ] = 100.0;
+  ImageType::DirectionType direction;
+  direction.Fill( 0.0 );
+  direction[ 0 ][ 1 ] = 1.0; direction[ 1 ][ 0 ] = -1.0; direction[ 2 ][ 2 ] = 1.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( index, size ) );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->SetDirection( direction );
+
+  typedef itk::ShrinkImageFilter< ImageType, ImageType > ShrinkFilterType;
+  for( unsigned int factor : { 1, 2, 3, 4, 16 } )
+  {
+    ShrinkFilterType::ShrinkFactorsType shrinkFactors;
+    shrinkFactors.Fill( factor );
+    shrinkFactors[ 2 ] = std::min( factor, 2u );
+
+    ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors( shrinkFactors );
+    shrinkFilter->SetInput( image );
+    shrinkFilter->UpdateOutputInformation();
+
+    ExpectEqualDomains( shrinkFilter->GetOutput(), ShrinkImageDomain< 3 >( image.GetPointer(), shrinkFactors ) );
+  }
+}
+
+TEST_F( ImagePyramidTest, LevelDomains )
+{
+  auto imageProvider = std::make_shared< ImageProvider >();
+  Image2DType::SizeType size = { { 64, 48 } };
+  imageProvider->image = Image2DType::New();
+  imageProvider->image->SetRegions( size );
+
+  LoggerImpl logger;
+  ItkImagePyramidComponent< 2, float > pyramid( "Pyramid", logger );
+  EXPECT_TRUE( pyramid.MeetsCriterion( { "ShrinkFactorsPerLevel", { "4", "2", "1" } } ) );
+  EXPECT_FALSE( pyramid.MeetsCriterion( { "SmoothingSigmasPerLevel", { "2", "1" } } ) );
+  EXPECT_TRUE( pyramid.MeetsCriterion( { "SmoothingSigmasPerLevel", { "2", "1", "0" } } ) );
+  EXPECT_EQ( 0, pyramid.Accept( imageProvider ) );
+  EXPECT_EQ( 3u, pyramid.GetNumberOfLevels() );
+  EXPECT_EQ( 4u, pyramid.GetShrinkFactorAtLevel( 0 ) );
+  EXPECT_EQ( 0.0, pyramid.GetSmoothingSigmaAtLevel( 2 ) );
+  EXPECT_THROW( pyramid.GetItkImageDomainAtLevel( 3 ), std::runtime_error );
+
+  // The image is not allocated, the domains of the levels are derived from its meta data only
+  typedef itk::ShrinkImageFilter< Image2DType, Image2DType > ShrinkFilterType;
+  for( unsigned int level = 0; level < 3; ++level )
+  {
+    ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors( pyramid.GetShrinkFactorAtLevel( level ) );
+    shrinkFilter->SetInput( imageProvider->image );
+    shrinkFilter->UpdateOutputInformation();
+
+    auto domain = pyramid.GetItkImageDomainAtLevel( level );
+    EXPECT_EQ( shrinkFilter->GetOutput()->GetLargestPossibleRegion(), domain->GetLargestPossibleRegion() );
+    EXPECT_EQ( shrinkFilter->GetOutput()->GetSpacing(), domain->GetSpacing() );
+    EXPECT_EQ( shrinkFilter->GetOutput()->GetOrigin(), domain->GetOrigin() );
+  }
+  EXPECT_EQ( 16u, pyramid.GetItkImageDomainAtLevel( 0 )->GetLargestPossibleRegion().GetSize()[ 0 ] );
+  EXPECT_EQ( nullptr, imageProvider->image->GetBufferPointer() );
+}
+} // namespace selx
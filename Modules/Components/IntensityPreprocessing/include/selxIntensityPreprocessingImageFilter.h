@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxIntensityPreprocessingImageFilter_h
+#define selxIntensityPreprocessingImageFilter_h
+
+#include "itkImage.h"
+#include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
+
+#include <type_traits>
+
+namespace selx
+{
+/** \class IntensityPreprocessingImageFilter
+ * \brief Rescales, inverts, clamps, casts and optionally smooths the intensities of an image in a single pass.
+ *
+ * The operations are applied in the order smooth, rescale, invert, clamp, cast, which is the order in which
+ * the registration components used to chain the separate ITK filters. Rescaling and inverting are composed
+ * into one affine map of the intensities, from the minimum and maximum of the (smoothed) input, so the pixels
+ * are visited only once and only one image sized buffer is allocated for the output.
+ *
+ * Rescaling follows itk::RescaleIntensityImageFilter and inverting follows itk::InvertIntensityImageFilter,
+ * with the maximum of the rescaled intensities as the maximum.
+ *
+ * When Sigma is positive the input is smoothed by itk::SmoothingRecursiveGaussianImageFilter directly into
+ * the output buffer, which is then adjusted in place. Only for integer output pixel types the smoothed image
+ * needs a buffer of its own, otherwise it would be truncated before it is rescaled.
+ */
+template< class TInputImage, class TOutputImage = TInputImage >
+class IntensityPreprocessingImageFilter :
+  public itk::ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+
+  /** Standard class typedefs. */
+  typedef IntensityPreprocessingImageFilter                    Self;
+  typedef itk::ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef itk::SmartPointer< Self >                            Pointer;
+  typedef itk::SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( IntensityPreprocessingImageFilter, ImageToImageFilter );
+
+  typedef TInputImage                                InputImageType;
+  typedef TOutputImage                               OutputImageType;
+  typedef typename InputImageType::PixelType         InputPixelType;
+  typedef typename OutputImageType::PixelType        OutputPixelType;
+  typedef typename OutputImageType::RegionType       OutputImageRegionType;
+  typedef typename itk::NumericTraits< OutputPixelType >::RealType RealType;
+
+  /** The image that is smoothed into, the output image unless its pixels cannot hold the smoothed intensities */
+  typedef typename std::conditional< itk::NumericTraits< OutputPixelType >::is_integer,
+    itk::Image< float, OutputImageType::ImageDimension >, OutputImageType >::type SmoothedImageType;
+
+  /** Rescale the intensities linearly to [OutputMinimum, OutputMaximum] */
+  itkSetMacro( Rescale, bool );
+  itkGetConstMacro( Rescale, bool );
+  itkBooleanMacro( Rescale );
+  itkSetMacro( OutputMinimum, OutputPixelType );
+  itkGetConstMacro( OutputMinimum, OutputPixelType );
+  itkSetMacro( OutputMaximum, OutputPixelType );
+  itkGetConstMacro( OutputMaximum, OutputPixelType );
+
+  /** Subtract the intensities from their maximum */
+  itkSetMacro( Invert, bool );
+  itkGetConstMacro( Invert, bool );
+  itkBooleanMacro( Invert );
+
+  /** Clamp the intensities to [ClampMinimum, ClampMaximum]. Intensities are always clamped to the range of the
+   * output pixel type. */
+  itkSetMacro( Clamp, bool );
+  itkGetConstMacro( Clamp, bool );
+  itkBooleanMacro( Clamp );
+  itkSetMacro( ClampMinimum, OutputPixelType );
+  itkGetConstMacro( ClampMinimum, OutputPixelType );
+  itkSetMacro( ClampMaximum, OutputPixelType );
+  itkGetConstMacro( ClampMaximum, OutputPixelType );
+
+  /** Standard deviation of the Gaussian in physical units, 0 disables smoothing */
+  itkSetMacro( Sigma, double );
+  itkGetConstMacro( Sigma, double );
+
+protected:
+
+  IntensityPreprocessingImageFilter();
+  ~IntensityPreprocessingImageFilter() {}
+
+  void PrintSelf( std::ostream & os, itk::Indent indent ) const ITK_OVERRIDE;
+
+  /** The minimum, maximum and smoothing need the whole image */
+  void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  void EnlargeOutputRequestedRegion( itk::DataObject * output ) ITK_OVERRIDE;
+
+  /** Smooths the input and composes the affine map of the intensities */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  void ThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId ) ITK_OVERRIDE;
+
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+private:
+
+  ITK_DISALLOW_COPY_AND_ASSIGN( IntensityPreprocessingImageFilter );
+
+  template< class TSourceImage >
+  void ComputeIntensityMap( const TSourceImage * source );
+
+  template< class TSourceImage >
+  void MapIntensities( const TSourceImage * source, const OutputImageRegionType & region );
+
+  bool            m_Rescale;
+  OutputPixelType m_OutputMinimum;
+  OutputPixelType m_OutputMaximum;
+  bool            m_Invert;
+  bool            m_Clamp;
+  OutputPixelType m_ClampMinimum;
+  OutputPixelType m_ClampMaximum;
+  double          m_Sigma;
+
+  // The intensities are mapped to Clamp( m_Scale * intensity + m_Shift, m_Lower, m_Upper )
+  RealType m_Scale;
+  RealType m_Shift;
+  RealType m_Lower;
+  RealType m_Upper;
+
+  typename SmoothedImageType::ConstPointer m_SmoothedImage;
+};
+} // end namespace selx
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxIntensityPreprocessingImageFilter.hxx"
+#endif
+#endif // selxIntensityPreprocessingImageFilter_h
@@ -0,0 +1,243 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxIntensityPreprocessingImageFilter_hxx
+#define selxIntensityPreprocessingImageFilter_hxx
+
+#include "selxIntensityPreprocessingImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+
+#include <algorithm>
+
+namespace selx
+{
+template< class TInputImage, class TOutputImage >
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::IntensityPreprocessingImageFilter() :
+  m_Rescale( false ),
+  m_OutputMinimum( itk::NumericTraits< OutputPixelType >::NonpositiveMin() ),
+  m_OutputMaximum( itk::NumericTraits< OutputPixelType >::max() ),
+  m_Invert( false ),
+  m_Clamp( false ),
+  m_ClampMinimum( itk::NumericTraits< OutputPixelType >::NonpositiveMin() ),
+  m_ClampMaximum( itk::NumericTraits< OutputPixelType >::max() ),
+  m_Sigma( 0.0 ),
+  m_Scale( 1.0 ),
+  m_Shift( 0.0 ),
+  m_Lower( itk::NumericTraits< RealType >::NonpositiveMin() ),
+  m_Upper( itk::NumericTraits< RealType >::max() )
+{
+}
+
+
+template< class TInputImage, class TOutputImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType * input = const_cast< InputImageType * >( this->GetInput() );
+  if( input )
+  {
+    input->SetRequestedRegionToLargestPossibleRegion();
+  }
+}
+
+
+template< class TInputImage, class TOutputImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion( itk::DataObject * output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+template< class TInputImage, class TOutputImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  if( this->m_Sigma > 0.0 )
+  {
+    typedef itk::SmoothingRecursiveGaussianImageFilter< InputImageType, SmoothedImageType > SmoothingFilterType;
+    typename SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+    smoothingFilter->SetInput( this->GetInput() );
+    smoothingFilter->SetSigma( this->m_Sigma );
+    smoothingFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+    smoothingFilter->InPlaceOff();
+    if( std::is_same< SmoothedImageType, OutputImageType >::value )
+    {
+      // Smooth into the buffer that was just allocated for the output, the intensities are then mapped in place
+      smoothingFilter->GraftOutput( this->GetOutput() );
+    }
+    smoothingFilter->Update();
+    this->m_SmoothedImage = smoothingFilter->GetOutput();
+    this->ComputeIntensityMap( this->m_SmoothedImage.GetPointer() );
+  }
+  else
+  {
+    this->ComputeIntensityMap( this->GetInput() );
+  }
+}
+
+
+template< class TInputImage, class TOutputImage >
+template< class TSourceImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::ComputeIntensityMap( const TSourceImage * source )
+{
+  this->m_Scale = 1.0;
+  this->m_Shift = 0.0;
+  this->m_Lower = itk::NumericTraits< RealType >::NonpositiveMin();
+  this->m_Upper = itk::NumericTraits< RealType >::max();
+
+  if( this->m_Rescale || this->m_Invert )
+  {
+    typedef itk::MinimumMaximumImageCalculator< TSourceImage > CalculatorType;
+    typename CalculatorType::Pointer calculator = CalculatorType::New();
+    calculator->SetImage( source );
+    calculator->SetRegion( source->GetBufferedRegion() );
+    calculator->Compute();
+    const RealType minimum = static_cast< RealType >( calculator->GetMinimum() );
+    RealType       maximum = static_cast< RealType >( calculator->GetMaximum() );
+
+    if( this->m_Rescale )
+    {
+      // As itk::RescaleIntensityImageFilter, including its treatment of constant images
+      const RealType outputMinimum = static_cast< RealType >( this->m_OutputMinimum );
+      const RealType outputMaximum = static_cast< RealType >( this->m_OutputMaximum );
+      if( minimum != maximum )
+      {
+        this->m_Scale = ( outputMaximum - outputMinimum ) / ( maximum - minimum );
+      }
+      else if( maximum != 0.0 )
+      {
+        this->m_Scale = ( outputMaximum - outputMinimum ) / maximum;
+      }
+      else
+      {
+        this->m_Scale = 0.0;
+      }
+      this->m_Shift = outputMinimum - minimum * this->m_Scale;
+      this->m_Lower = std::min( outputMinimum, outputMaximum );
+      this->m_Upper = std::max( outputMinimum, outputMaximum );
+      maximum       = std::max( this->m_Scale * minimum, this->m_Scale * maximum ) + this->m_Shift;
+      maximum       = std::min( std::max( maximum, this->m_Lower ), this->m_Upper );
+    }
+
+    if( this->m_Invert )
+    {
+      // As itk::InvertIntensityImageFilter with the maximum of the rescaled intensities
+      const RealType lower = this->m_Lower;
+      this->m_Scale = -this->m_Scale;
+      this->m_Shift = maximum - this->m_Shift;
+      this->m_Lower = this->m_Rescale ? maximum - this->m_Upper : itk::NumericTraits< RealType >::NonpositiveMin();
+      this->m_Upper = this->m_Rescale ? maximum - lower : itk::NumericTraits< RealType >::max();
+    }
+  }
+
+  if( this->m_Clamp )
+  {
+    this->m_Lower = std::max( this->m_Lower, static_cast< RealType >( this->m_ClampMinimum ) );
+    this->m_Upper = std::min( this->m_Upper, static_cast< RealType >( this->m_ClampMaximum ) );
+  }
+
+  // Casting intensities that do not fit in the output pixel type is undefined
+  this->m_Lower = std::max( this->m_Lower, static_cast< RealType >( itk::NumericTraits< OutputPixelType >::NonpositiveMin() ) );
+  this->m_Upper = std::min( this->m_Upper, static_cast< RealType >( itk::NumericTraits< OutputPixelType >::max() ) );
+}
+
+
+template< class TInputImage, class TOutputImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType itkNotUsed( threadId ) )
+{
+  if( this->m_SmoothedImage )
+  {
+    this->MapIntensities( this->m_SmoothedImage.GetPointer(), outputRegionForThread );
+  }
+  else
+  {
+    this->MapIntensities( this->GetInput(), outputRegionForThread );
+  }
+}
+
+
+template< class TInputImage, class TOutputImage >
+template< class TSourceImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::MapIntensities( const TSourceImage * source, const OutputImageRegionType & region )
+{
+  // The source may share its buffer with the output, every pixel is read before it is written
+  itk::ImageRegionConstIterator< TSourceImage > sourceIterator( source, region );
+  itk::ImageRegionIterator< OutputImageType >   outputIterator( this->GetOutput(), region );
+
+  const RealType scale = this->m_Scale;
+  const RealType shift = this->m_Shift;
+  const RealType lower = this->m_Lower;
+  const RealType upper = this->m_Upper;
+
+  for( ; !outputIterator.IsAtEnd(); ++sourceIterator, ++outputIterator )
+  {
+    const RealType intensity = scale * static_cast< RealType >( sourceIterator.Get() ) + shift;
+    outputIterator.Set( static_cast< OutputPixelType >( std::min( std::max( intensity, lower ), upper ) ) );
+  }
+}
+
+
+template< class TInputImage, class TOutputImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  // Frees the smoothed image if it had a buffer of its own
+  this->m_SmoothedImage = nullptr;
+}
+
+
+template< class TInputImage, class TOutputImage >
+void
+IntensityPreprocessingImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Rescale: " << this->m_Rescale << std::endl;
+  os << indent << "OutputMinimum: " << static_cast< RealType >( this->m_OutputMinimum ) << std::endl;
+  os << indent << "OutputMaximum: " << static_cast< RealType >( this->m_OutputMaximum ) << std::endl;
+  os << indent << "Invert: " << this->m_Invert << std::endl;
+  os << indent << "Clamp: " << this->m_Clamp << std::endl;
+  os << indent << "ClampMinimum: " << static_cast< RealType >( this->m_ClampMinimum ) << std::endl;
+  os << indent << "ClampMaximum: " << static_cast< RealType >( this->m_ClampMaximum ) << std::endl;
+  os << indent << "Sigma: " << this->m_Sigma << std::endl;
+}
+} // end namespace selx
+
+#endif // selxIntensityPreprocessingImageFilter_hxx
@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxItkIntensityPreprocessingComponent_h
+#define selxItkIntensityPreprocessingComponent_h
+
+#include "selxSuperElastixComponent.h"
+
+#include "selxSinksAndSourcesInterfaces.h"
+#include "selxItkObjectInterfaces.h"
+
+#include "selxIntensityPreprocessingImageFilter.h"
+
+namespace selx
+{
+/** Rescales, inverts, clamps and smooths an image in one pass, see IntensityPreprocessingImageFilter.
+ * The result can be connected as an image, or as the fixed or moving image of a registration component.
+ * The input pixels are cast to TOutputPixel, e.g. to register short images in float. The filter runs on the
+ * share of the ThreadBudget of the component.
+ *
+ * Settings:
+ *   RescaleIntensity: minimum maximum
+ *   InvertIntensity: True or False
+ *   ClampIntensity: minimum maximum
+ *   Sigma: standard deviation of the Gaussian smoothing in physical units, 0 (default) for no smoothing
+ *
+ * The settings are in the intensities of the output.
+ */
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+class ItkIntensityPreprocessingComponent :
+  public SuperElastixComponent<
+  Accepting< itkImageInterface< Dimensionality, TInputPixel >>,
+  Providing< itkImageInterface< Dimensionality, TOutputPixel >,
+  itkImageFixedInterface< Dimensionality, TOutputPixel >,
+  itkImageMovingInterface< Dimensionality, TOutputPixel >,
+  UpdateInterface >
+  >
+{
+public:
+
+  /** Standard typedefs. */
+  typedef ItkIntensityPreprocessingComponent<
+    Dimensionality, TInputPixel, TOutputPixel
+    >                                      Self;
+  typedef SuperElastixComponent<
+    Accepting< itkImageInterface< Dimensionality, TInputPixel >>,
+    Providing< itkImageInterface< Dimensionality, TOutputPixel >,
+    itkImageFixedInterface< Dimensionality, TOutputPixel >,
+    itkImageMovingInterface< Dimensionality, TOutputPixel >,
+    UpdateInterface >
+    >                                      Superclass;
+  typedef std::shared_ptr< Self >       Pointer;
+  typedef std::shared_ptr< const Self > ConstPointer;
+
+  ItkIntensityPreprocessingComponent( const std::string & name, LoggerImpl & logger );
+  virtual ~ItkIntensityPreprocessingComponent();
+
+  typedef TInputPixel                                  InputPixelType;
+  typedef TOutputPixel                                 PixelType;
+  typedef itk::Image< InputPixelType, Dimensionality > ItkInputImageType;
+  typedef itk::Image< PixelType, Dimensionality >      ItkImageType;
+  typedef typename ItkImageType::Pointer               ItkImagePointer;
+  typedef IntensityPreprocessingImageFilter< ItkInputImageType, ItkImageType > TheItkFilterType;
+
+  virtual int Accept( typename itkImageInterface< Dimensionality, TInputPixel >::Pointer ) override;
+
+  virtual ItkImagePointer GetItkImage() override;
+
+  virtual ItkImagePointer GetItkImageFixed() override;
+
+  virtual ItkImagePointer GetItkImageMoving() override;
+
+  virtual void Update() override;
+
+  virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
+
+  static const char * GetDescription() { return "ItkIntensityPreprocessing Component"; }
+
+private:
+
+  typename TheItkFilterType::Pointer m_theItkFilter;
+
+protected:
+
+  // return the class name and the template arguments to uniquely identify this component.
+  static inline const std::map< std::string, std::string > TemplateProperties()
+  {
+    return { { keys::NameOfClass, "ItkIntensityPreprocessingComponent" }, { keys::InputPixelType, PodString< TInputPixel >::Get() }, { keys::PixelType, PodString< TOutputPixel >::Get() }, { keys::Dimensionality, std::to_string( Dimensionality ) } };
+  }
+};
+} //end namespace selx
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxItkIntensityPreprocessingComponent.hxx"
+#endif
+#endif // #define selxItkIntensityPreprocessingComponent_h
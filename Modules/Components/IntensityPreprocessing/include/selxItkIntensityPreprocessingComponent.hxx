@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxItkIntensityPreprocessingComponent.h"
+#include "selxCheckTemplateProperties.h"
+#include "selxStringConverter.h"
+
+namespace selx
+{
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >::ItkIntensityPreprocessingComponent(
+  const std::string & name, LoggerImpl & logger ) : Superclass( name, logger )
+{
+  m_theItkFilter = TheItkFilterType::New();
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >::~ItkIntensityPreprocessingComponent()
+{
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+int
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >
+::Accept( typename itkImageInterface< Dimensionality, TInputPixel >::Pointer component )
+{
+  auto image = component->GetItkImage();
+  // connect the itk pipeline
+  this->m_theItkFilter->SetInput( image );
+  return 0;
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+typename ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >::ItkImagePointer
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >
+::GetItkImage()
+{
+  return m_theItkFilter->GetOutput();
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+typename ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >::ItkImagePointer
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >
+::GetItkImageFixed()
+{
+  return m_theItkFilter->GetOutput();
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+typename ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >::ItkImagePointer
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >
+::GetItkImageMoving()
+{
+  return m_theItkFilter->GetOutput();
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+void
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >
+::Update()
+{
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    this->m_theItkFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+  }
+}
+
+
+template< int Dimensionality, class TInputPixel, class TOutputPixel >
+bool
+ItkIntensityPreprocessingComponent< Dimensionality, TInputPixel, TOutputPixel >
+::MeetsCriterion( const ComponentBase::CriterionType & criterion )
+{
+  auto status = CheckTemplateProperties( this->TemplateProperties(), criterion );
+  if( status == CriterionStatus::Satisfied )
+  {
+    return true;
+  }
+  else if( status == CriterionStatus::Failed )
+  {
+    return false;
+  } // else: CriterionStatus::Unknown
+
+  try
+  {
+    if( criterion.first == "RescaleIntensity" )
+    {
+      if( criterion.second.size() != 2 )
+      {
+        this->m_Logger.Log( LogLevel::ERR, "Expected two values for RescaleIntensity (min, max), got {0}.", criterion.second.size() );
+        return false;
+      }
+      this->m_theItkFilter->RescaleOn();
+      this->m_theItkFilter->SetOutputMinimum( static_cast< PixelType >( std::stod( criterion.second[ 0 ] ) ) );
+      this->m_theItkFilter->SetOutputMaximum( static_cast< PixelType >( std::stod( criterion.second[ 1 ] ) ) );
+      return true;
+    }
+    else if( criterion.first == "InvertIntensity" )
+    {
+      bool invert;
+      if( criterion.second.size() != 1 || !StringConverter::Convert( criterion.second[ 0 ], invert ) )
+      {
+        this->m_Logger.Log( LogLevel::ERR, "Expected one value for InvertIntensity (True or False)." );
+        return false;
+      }
+      this->m_theItkFilter->SetInvert( invert );
+      return true;
+    }
+    else if( criterion.first == "ClampIntensity" )
+    {
+      if( criterion.second.size() != 2 )
+      {
+        this->m_Logger.Log( LogLevel::ERR, "Expected two values for ClampIntensity (min, max), got {0}.", criterion.second.size() );
+        return false;
+      }
+      this->m_theItkFilter->ClampOn();
+      this->m_theItkFilter->SetClampMinimum( static_cast< PixelType >( std::stod( criterion.second[ 0 ] ) ) );
+      this->m_theItkFilter->SetClampMaximum( static_cast< PixelType >( std::stod( criterion.second[ 1 ] ) ) );
+      return true;
+    }
+    else if( criterion.first == "Sigma" )
+    {
+      if( criterion.second.size() != 1 )
+      {
+        this->m_Logger.Log( LogLevel::ERR, "Expected one value for Sigma, got {0}.", criterion.second.size() );
+        return false;
+      }
+      this->m_theItkFilter->SetSigma( std::stod( criterion.second[ 0 ] ) );
+      return true;
+    }
+  }
+  catch( std::logic_error & )
+  {
+    // std::stod throws std::invalid_argument or std::out_of_range
+    this->m_Logger.Log( LogLevel::ERR, "Expected numbers for {0}.", criterion.first );
+  }
+  return false;
+}
+} //end namespace selx
@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxIntensityPreprocessingImageFilter.h"
+#include "selxItkIntensityPreprocessingComponent.h"
+#include "selxItkImageSinkComponent.h"
+#include "selxItkImageSourceComponent.h"
+#include "selxSuperElastixFilterCustomComponents.h"
+
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkInvertIntensityImageFilter.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include "itkRescaleIntensityImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+namespace selx
+{
+class IntensityPreprocessingImageFilterTest : public ::testing::Test
+{
+public:
+
+  typedef itk::Image< float, 2 >         ImageType;
+  typedef itk::Image< unsigned char, 2 > UnsignedCharImageType;
+  typedef IntensityPreprocessingImageFilter< ImageType, ImageType > FilterType;
+
+  virtual void SetUp()
+  {
+    ImageType::SizeType size;
+    size.Fill( 32 );
+    image = ImageType::New();
+    image->SetRegions( ImageType::RegionType( size ) );
+    image->Allocate();
+    for( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() ); !it.IsAtEnd(); ++it )
+    {
+      it.Set( 3.0f * it.GetIndex()[ 0 ] - 2.0f * it.GetIndex()[ 1 ] + 7.0f );
+    }
+  }
+
+
+  template< class TExpectedImage, class TResultImage >
+  static void ExpectNearImages( TExpectedImage * expected, TResultImage * result, double tolerance )
+  {
+    ASSERT_EQ( expected->GetBufferedRegion(), result->GetBufferedRegion() );
+    itk::ImageRegionConstIterator< TExpectedImage > expectedIterator( expected, expected->GetBufferedRegion() );
+    itk::ImageRegionConstIterator< TResultImage >   resultIterator( result, result->GetBufferedRegion() );
+    for( ; !expectedIterator.IsAtEnd(); ++expectedIterator, ++resultIterator )
+    {
+      ASSERT_NEAR( expectedIterator.Get(), resultIterator.Get(), tolerance );
+    }
+  }
+
+
+  ImageType::Pointer image;
+};
+
+TEST_F( IntensityPreprocessingImageFilterTest, RescaleAndInvertAsItkFilters )
+{
+  typedef itk::RescaleIntensityImageFilter< ImageType, ImageType > RescaleFilterType;
+  RescaleFilterType::Pointer rescaleFilter = RescaleFilterType::New();
+  rescaleFilter->SetInput( image );
+  rescaleFilter->SetOutputMinimum( 0.0f );
+  rescaleFilter->SetOutputMaximum( 1.0f );
+  rescaleFilter->Update();
+
+  typedef itk::MinimumMaximumImageCalculator< ImageType > CalculatorType;
+  CalculatorType::Pointer calculator = CalculatorType::New();
+  calculator->SetImage( rescaleFilter->GetOutput() );
+  calculator->ComputeMaximum();
+
+  typedef itk::InvertIntensityImageFilter< ImageType, ImageType > InvertFilterType;
+  InvertFilterType::Pointer invertFilter = InvertFilterType::New();
+  invertFilter->SetInput( rescaleFilter->GetOutput() );
+  invertFilter->SetMaximum( calculator->GetMaximum() );
+  invertFilter->Update();
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->RescaleOn();
+  filter->SetOutputMinimum( 0.0f );
+  filter->SetOutputMaximum( 1.0f );
+  filter->InvertOn();
+  EXPECT_NO_THROW( filter->Update() );
+
+  ExpectNearImages( invertFilter->GetOutput(), filter->GetOutput(), 1e-6 );
+}
+
+TEST_F( IntensityPreprocessingImageFilterTest, SmoothInOutputBuffer )
+{
+  typedef itk::SmoothingRecursiveGaussianImageFilter< ImageType, ImageType > SmoothingFilterType;
+  SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+  smoothingFilter->SetInput( image );
+  smoothingFilter->SetSigma( 2.0 );
+  smoothingFilter->Update();
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetSigma( 2.0 );
+  EXPECT_NO_THROW( filter->Update() );
+
+  ExpectNearImages( smoothingFilter->GetOutput(), filter->GetOutput(), 1e-4 );
+
+  // The input is not smoothed in place
+  EXPECT_EQ( 7.0f, image->GetPixel( { { 0, 0 } } ) );
+}
+
+TEST_F( IntensityPreprocessingImageFilterTest, ClampAndCast )
+{
+  typedef IntensityPreprocessingImageFilter< ImageType, UnsignedCharImageType > CastFilterType;
+  CastFilterType::Pointer filter = CastFilterType::New();
+  filter->SetInput( image );
+  filter->ClampOn();
+  filter->SetClampMinimum( 10 );
+  filter->SetClampMaximum( 50 );
+  EXPECT_NO_THROW( filter->Update() );
+
+  itk::ImageRegionConstIterator< ImageType >             inputIterator( image, image->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< UnsignedCharImageType > outputIterator( filter->GetOutput(), image->GetBufferedRegion() );
+  for( ; !inputIterator.IsAtEnd(); ++inputIterator, ++outputIterator )
+  {
+    ASSERT_EQ( static_cast< unsigned char >( std::min( std::max( inputIterator.Get(), 10.0f ), 50.0f ) ), outputIterator.Get() );
+  }
+}
+
+TEST_F( IntensityPreprocessingImageFilterTest, ConstantImage )
+{
+  image->FillBuffer( 5.0f );
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->RescaleOn();
+  filter->SetOutputMinimum( -1.0f );
+  filter->SetOutputMaximum( 1.0f );
+  EXPECT_NO_THROW( filter->Update() );
+
+  // As itk::RescaleIntensityImageFilter, a constant image is mapped to the output minimum
+  EXPECT_EQ( -1.0f, filter->GetOutput()->GetPixel( { { 3, 4 } } ) );
+}
+
+TEST_F( IntensityPreprocessingImageFilterTest, ComponentCastsShortToFloat )
+{
+  typedef itk::Image< short, 2 > ShortImageType;
+  typedef TypeList<
+    ItkImageSourceComponent< 2, short >,
+    ItkIntensityPreprocessingComponent< 2, short, float >,
+    ItkIntensityPreprocessingComponent< 2, float, float >,
+    ItkImageSinkComponent< 2, float >
+    > RegisterComponents;
+
+  ShortImageType::Pointer shortImage = ShortImageType::New();
+  shortImage->SetRegions( image->GetBufferedRegion() );
+  shortImage->Allocate();
+  itk::ImageRegionConstIterator< ImageType >         inputIterator( image, image->GetBufferedRegion() );
+  itk::ImageRegionIteratorWithIndex< ShortImageType > shortIterator( shortImage, shortImage->GetBufferedRegion() );
+  for( ; !inputIterator.IsAtEnd(); ++inputIterator, ++shortIterator )
+  {
+    shortIterator.Set( static_cast< short >( inputIterator.Get() ) );
+  }
+
+  Logger::Pointer logger = Logger::New();
+  Blueprint::Pointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "Image", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "short" } } } );
+  blueprint->SetComponent( "Preprocessing", { { "NameOfClass", { "ItkIntensityPreprocessingComponent" } },
+                                              { "InputPixelType", { "short" } }, { "PixelType", { "float" } },
+                                              { "RescaleIntensity", { "0", "1" } }, { "NumberOfThreads", { "1" } } } );
+  blueprint->SetComponent( "PreprocessedImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "float" } } } );
+  blueprint->SetConnection( "Image", "Preprocessing", {} );
+  blueprint->SetConnection( "Preprocessing", "PreprocessedImage", {} );
+
+  auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+  superElastixFilter->SetLogger( logger );
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetInput( "Image", shortImage );
+  auto preprocessedImage = superElastixFilter->GetOutput< ImageType >( "PreprocessedImage" );
+  EXPECT_NO_THROW( preprocessedImage->Update() );
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->RescaleOn();
+  filter->SetOutputMinimum( 0.0f );
+  filter->SetOutputMaximum( 1.0f );
+  filter->Update();
+
+  ExpectNearImages( filter->GetOutput(), preprocessedImage.GetPointer(), 1e-6 );
+}
+} // namespace selx
@@ -53,6 +53,7 @@ set( ${MODULE}_TEST_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/test/selxNiftyregComponentTest.cxx
   ${${MODULE}_SOURCE_DIR}/test/selxNiftiItkConversionsTest.cxx
   ${${MODULE}_SOURCE_DIR}/test/selxNiftyregDisplacementTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxNiftiVectorLayoutTest.cxx
 )
 
 set( ${MODULE}_LIBRARIES 
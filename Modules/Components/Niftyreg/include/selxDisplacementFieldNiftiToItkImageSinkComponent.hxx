@@ -112,7 +112,7 @@ void
 DisplacementFieldNiftiToItkImageSinkComponent< Dimensionality, TPixel >::Update()
 {
   auto displacementFieldNiftiImage = this->m_DisplacementFieldInterface->GetDisplacementFieldNiftiImage();
-  auto displacementFieldItkImage   = NiftiToItkImage< ItkDisplacementFieldType, TPixel >::Convert( displacementFieldNiftiImage );
+  auto displacementFieldItkImage   = NiftiToItkImage< ItkDisplacementFieldType, TPixel >::Convert( displacementFieldNiftiImage, this->GetNumberOfThreads() );
   this->m_MiniPipelineOutputImage->Graft( displacementFieldItkImage );
 }
 
@@ -26,6 +26,7 @@
 #include "itkMacro.h"
 
 #include "itkImageIOBase.h"
+#include "itkMultiThreader.h"
 #include "selxItkImageProperties.h"
 
 // forward declaration of functions declared in ITK\Modules\IO\NIFTI\src\itkNiftiImageIO.cxx,
@@ -68,7 +69,8 @@ class ItkToNiftiImage
 {
 public:
 
-  static std::shared_ptr< nifti_image > Convert( typename ItkImageType::Pointer input );
+  /** numberOfThreads is used to transpose vector pixels to the planar nifti layout; 0 means the global default of itk. */
+  static std::shared_ptr< nifti_image > Convert( typename ItkImageType::Pointer input, unsigned int numberOfThreads = 0 );
 
 protected:
 
@@ -88,7 +90,7 @@ private:
   * that the IORegions has been set properly. */
   //static const void*  GetImageBuffer(typename ItkImageType::Pointer input);
 
-  static bool TransferImageData( typename ItkImageType::PixelType * buffer, nifti_image * output );
+  static bool TransferImageData( typename ItkImageType::PixelType * buffer, nifti_image * output, unsigned int numberOfThreads );
 
   static void  SetNIfTIOrientationFromImageIO( typename ItkImageType::Pointer input,
     nifti_image * output,
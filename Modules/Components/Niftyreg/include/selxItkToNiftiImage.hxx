@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "selxItkToNiftiImage.h"
+#include "selxNiftiVectorLayout.h"
 #include "itkMath.h"
 //#include "itkIOCommon.h"
 //#include "itkMetaDataObject.h"
@@ -26,7 +27,7 @@ namespace selx
 
 template< class ItkImageType, class NiftiPixelType >
 std::shared_ptr< nifti_image >
-ItkToNiftiImage< ItkImageType, NiftiPixelType >::Convert( typename ItkImageType::Pointer input )
+ItkToNiftiImage< ItkImageType, NiftiPixelType >::Convert( typename ItkImageType::Pointer input, unsigned int numberOfThreads )
 {
   nifti_set_debug_level( 0 ); // suppress error messages
 
@@ -67,7 +68,11 @@ ItkToNiftiImage< ItkImageType, NiftiPixelType >::Convert( typename ItkImageType:
     throw std::runtime_error( msg.str() );
   }
 
-  const bool wasCopied = TransferImageData(input->GetBufferPointer(), output );
+  if( numberOfThreads == 0 )
+  {
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  }
+  const bool wasCopied = TransferImageData(input->GetBufferPointer(), output, numberOfThreads );
 
   // If the data was not copied to the nifti_image, it is shared between the ITK image and the nifti_image. Therefore, in that case, 
   // the ITK image is captured by the deleter of the shared_ptr, to ensure the lifetime of the ITK Image is extended to the end of 
@@ -495,7 +500,7 @@ ItkToNiftiImage< ItkImageType, NiftiPixelType >::SetNIfTIOrientationFromImageIO(
 template< class ItkImageType, class NiftiPixelType >
 bool
 ItkToNiftiImage< ItkImageType, NiftiPixelType >
-::TransferImageData( typename ItkImageType::PixelType * buffer, nifti_image * output )
+::TransferImageData( typename ItkImageType::PixelType * buffer, nifti_image * output, unsigned int numberOfThreads )
 {
   // Adapted from void NiftiImageIO::Write(const void *buffer)
 
@@ -532,14 +537,10 @@ ItkToNiftiImage< ItkImageType, NiftiPixelType >
       * numComponents //Number of componenets
       * output->nbyper;
 
-    char *             nifti_buf = new char[ buffer_size ];
-    const char * const itkbuf    = (const char *)buffer;
+    // Allocate with malloc to be consistent with nifti_image_free
+    char * nifti_buf = static_cast< char * >( malloc( buffer_size ) );
     // Data must be rearranged to meet nifti organzation.
     // nifti_layout[vec][t][z][y][x] = itk_layout[t][z][y][z][vec]
-    const size_t rowdist    = output->dim[ 1 ];
-    const size_t slicedist  = rowdist * output->dim[ 2 ];
-    const size_t volumedist = slicedist * output->dim[ 3 ];
-    const size_t seriesdist = volumedist * output->dim[ 4 ];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -550,53 +551,15 @@ ItkToNiftiImage< ItkImageType, NiftiPixelType >
     // ITK stores it a b c d e f, but NIfTI is a b d c e f
     // so on read, step sequentially through the source vector, but
     // reverse the order of vec[2] and vec[3]
-    int * vecOrder;
+    int * vecOrder = nullptr;
     if( ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::DIFFUSIONTENSOR3D
       || ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::SYMMETRICSECONDRANKTENSOR )
     {
       vecOrder = UpperToLowerOrder( SymMatDim( numComponents ) );
     }
-    else
-    {
-      vecOrder = new int[ numComponents ];
-      for( unsigned i = 0; i < numComponents; i++ )
-      {
-        vecOrder[ i ] = i;
-      }
-    }
-    for( int t = 0; t < output->dim[ 4 ]; t++ )
-    {
-      for( int z = 0; z < output->dim[ 3 ]; z++ )
-      {
-        for( int y = 0; y < output->dim[ 2 ]; y++ )
-        {
-          for( int x = 0; x < output->dim[ 1 ]; x++ )
-          {
-            for( unsigned int c = 0; c < numComponents; c++ )
-            {
-              const size_t nifti_index
-                = ( c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x ) * output->nbyper;
-              const size_t itk_index
-                = ( ( volumedist * t + slicedist * z + rowdist * y
-                + x ) * numComponents + vecOrder[ c ] ) * output->nbyper;
-
-              for( int b = 0; b < output->nbyper; ++b )
-              {
-                nifti_buf[ nifti_index + b ] =  itkbuf[ itk_index + b ];
-              }
-            }
-          }
-        }
-      }
-    }
+    NiftiVectorLayout::InterleavedToPlanar( buffer, nifti_buf, numVoxels, numComponents, output->nbyper, vecOrder, numberOfThreads );
     delete[] vecOrder;
-    //dumpdata(buffer);
-    //Need a const cast here so that we don't have to copy the memory for
-    //writing.
     output->data = (void *)nifti_buf;
-    //nifti_image_write(output);
-    //output->data = ITK_NULLPTR; // if left pointing to data buffer
-    //delete[] nifti_buf;
     return true;
   }
 }
@@ -63,13 +63,11 @@ ItkToNiftiImageComponent< Dimensionality, TPixel >::GetReferenceNiftiImage()
 
   this->m_Image->Update();
 
-  // TODO memory management issue: the Convert function passes the ownership
-  // of the data buffer from the itk image to the nifti image. This means that
-  // as soon as the shared_ptr<nifti_image> goes out of scope the buffer is freed
-  // and the itk image is invalidated. However, subsequently destructing the itk
-  // image should be without memory leaks.
+  // For pixel types with the same memory layout in itk and nifti, the Convert function shares
+  // the data buffer of the itk image with the nifti image instead of copying it. The itk image
+  // is kept alive by the returned shared_ptr<nifti_image>.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -84,13 +82,11 @@ ItkToNiftiImageComponent< Dimensionality, TPixel >::GetFloatingNiftiImage()
 
   this->m_Image->Update();
 
-  // TODO memory management issue: the Convert function passes the ownership
-  // of the data buffer from the itk image to the nifti image. This means that
-  // as soon as the shared_ptr<nifti_image> goes out of scope the buffer is freed
-  // and the itk image is invalidated. However, subsequently destructing the itk
-  // image should be without memory leaks.
+  // For pixel types with the same memory layout in itk and nifti, the Convert function shares
+  // the data buffer of the itk image with the nifti image instead of copying it. The itk image
+  // is kept alive by the returned shared_ptr<nifti_image>.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -105,13 +101,11 @@ ItkToNiftiImageComponent< Dimensionality, TPixel >::GetWarpedNiftiImage()
 
   this->m_Image->Update();
 
-  // TODO memory management issue: the Convert function passes the ownership
-  // of the data buffer from the itk image to the nifti image. This means that
-  // as soon as the shared_ptr<nifti_image> goes out of scope the buffer is freed
-  // and the itk image is invalidated. However, subsequently destructing the itk
-  // image should be without memory leaks.
+  // For pixel types with the same memory layout in itk and nifti, the Convert function shares
+  // the data buffer of the itk image with the nifti image instead of copying it. The itk image
+  // is kept alive by the returned shared_ptr<nifti_image>.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -126,13 +120,11 @@ ItkToNiftiImageComponent< Dimensionality, TPixel >::GetInputMask()
 
   this->m_Image->Update();
 
-  // TODO memory management issue: the Convert function passes the ownership
-  // of the data buffer from the itk image to the nifti image. This means that
-  // as soon as the shared_ptr<nifti_image> goes out of scope the buffer is freed
-  // and the itk image is invalidated. However, subsequently destructing the itk
-  // image should be without memory leaks.
+  // For pixel types with the same memory layout in itk and nifti, the Convert function shares
+  // the data buffer of the itk image with the nifti image instead of copying it. The itk image
+  // is kept alive by the returned shared_ptr<nifti_image>.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 template< int Dimensionality, class TPixel >
@@ -146,13 +138,11 @@ ItkToNiftiImageComponent< Dimensionality, TPixel >::GetInputFloatingMask()
 
   this->m_Image->Update();
 
-  // TODO memory management issue: the Convert function passes the ownership
-  // of the data buffer from the itk image to the nifti image. This means that
-  // as soon as the shared_ptr<nifti_image> goes out of scope the buffer is freed
-  // and the itk image is invalidated. However, subsequently destructing the itk
-  // image should be without memory leaks.
+  // For pixel types with the same memory layout in itk and nifti, the Convert function shares
+  // the data buffer of the itk image with the nifti image instead of copying it. The itk image
+  // is kept alive by the returned shared_ptr<nifti_image>.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
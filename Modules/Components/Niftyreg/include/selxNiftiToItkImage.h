@@ -44,10 +44,13 @@
 #include "itkMacro.h"
 
 #include "itkImageIOBase.h"
+#include "itkMultiThreader.h"
 #include "selxItkImageProperties.h"
 
 #include "itkMetaDataDictionary.h"
+#include "itkImportImageContainer.h"
 
+#include <memory>
 #include <tuple>
 
 namespace selx
@@ -76,6 +79,41 @@ struct DataFromNifti
   PixelType * buffer;
   size_t      numberOfElements;
 };
+/** \class NiftiImageContainer
+ * Pixel container that refers to the data buffer of a nifti_image instead of holding a copy of it.
+ * The container co-owns the nifti_image, such that the buffer stays valid for as long as any itk image uses it.
+ */
+template< typename TElementIdentifier, typename TElement >
+class NiftiImageContainer : public itk::ImportImageContainer< TElementIdentifier, TElement >
+{
+public:
+
+  typedef NiftiImageContainer                                       Self;
+  typedef itk::ImportImageContainer< TElementIdentifier, TElement > Superclass;
+  typedef itk::SmartPointer< Self >                                 Pointer;
+  typedef itk::SmartPointer< const Self >                           ConstPointer;
+
+  itkNewMacro( Self );
+  itkTypeMacro( NiftiImageContainer, ImportImageContainer );
+
+  void SetNiftiImage( std::shared_ptr< nifti_image > niftiImage, TElementIdentifier numberOfElements )
+  {
+    // The nifti_image keeps ownership of its data, which is released by nifti_image_free
+    this->SetImportPointer( static_cast< TElement * >( niftiImage->data ), numberOfElements, false );
+    this->m_NiftiImage = niftiImage;
+  }
+
+
+protected:
+
+  NiftiImageContainer() {}
+  ~NiftiImageContainer() {}
+
+private:
+
+  std::shared_ptr< nifti_image > m_NiftiImage;
+};
+
 /** \class NiftiToItkImage
  * Convert a nifti image to an itk image object.
  * Adapted from itkNiftiImageIO that is originally by Hans J. Johnson, The University of Iowa 2002
@@ -85,7 +123,8 @@ class NiftiToItkImage
 {
 public:
 
-  static typename ItkImageType::Pointer Convert( std::shared_ptr< nifti_image > input );
+  /** numberOfThreads is used to transpose vector pixels to the interleaved itk layout; 0 means the global default of itk. */
+  static typename ItkImageType::Pointer Convert( std::shared_ptr< nifti_image > input, unsigned int numberOfThreads = 0 );
 
 protected:
 
@@ -118,10 +157,15 @@ private:
 
   /** Reads the data from disk into the memory buffer provided. */
   static DataFromNifti< typename ItkImageType::PixelType > Read( std::shared_ptr< nifti_image > input_image,
-    ImageInformationFromNifti const & imageInformationFromNifti );
+    ImageInformationFromNifti const & imageInformationFromNifti, unsigned int numberOfThreads );
 
   static bool MustRescale( double rescaleSlope, double rescaleIntercept );
 
+  /** Returns true if the data of the nifti image can be used by the itk image as is, i.e. without rescaling
+  * and with the same component type and memory layout. */
+  static bool CanShareData( std::shared_ptr< nifti_image > input_image, ImageInformationFromNifti const & imageInformationFromNifti,
+    size_t numberOfPixels );
+
   //void  DefineHeaderObjectDataType();
 
   static OrientationFromNifti GetImageIOOrientationFromNIfTI( unsigned short int dims, std::shared_ptr< nifti_image > input );
@@ -34,6 +34,7 @@
  *
  *=========================================================================*/
 #include "selxNiftiToItkImage.h"
+#include "selxNiftiVectorLayout.h"
 #include "itkMath.h"
 //#include "itkIOCommon.h"
 #include "itkMetaDataObject.h"
@@ -46,7 +47,7 @@ namespace selx
 template< class ItkImageType, class NiftiPixelType >
 typename ItkImageType::Pointer
 NiftiToItkImage< ItkImageType, NiftiPixelType >
-::Convert( std::shared_ptr< nifti_image > input_image )
+::Convert( std::shared_ptr< nifti_image > input_image, unsigned int numberOfThreads )
 {
   auto imageInformationFromNifti = NiftiToItkImage< ItkImageType, NiftiPixelType >::ReadImageInformation( input_image );
   //TODO: check if the nifti image properties found are compatible with the template arguments of itkImageType.
@@ -56,11 +57,6 @@ NiftiToItkImage< ItkImageType, NiftiPixelType >
     imageInformationFromNifti.numberOfDimensions,
     input_image );
 
-  // Get data pointer
-  auto dataFromNifti = NiftiToItkImage< ItkImageType, NiftiPixelType >::Read( input_image, imageInformationFromNifti );
-
-  auto importImageFilter = itk::ImportImageFilter< typename ItkImageType::PixelType, ItkImageType::ImageDimension >::New();
-
   typename ItkImageType::RegionType region;
   typename ItkImageType::IndexType index;
   typename ItkImageType::SizeType size;
@@ -82,6 +78,32 @@ NiftiToItkImage< ItkImageType, NiftiPixelType >
   index.Fill( 0 );
   region.SetIndex( index );
   region.SetSize( size );
+
+  if( NiftiToItkImage< ItkImageType, NiftiPixelType >::CanShareData( input_image, imageInformationFromNifti, region.GetNumberOfPixels() ) )
+  {
+    // Zero-copy: the itk image uses the nifti data buffer and keeps the nifti_image alive via its pixel container
+    typedef NiftiImageContainer< typename ItkImageType::PixelContainer::ElementIdentifier, typename ItkImageType::PixelType >
+      NiftiImageContainerType;
+    auto pixelContainer = NiftiImageContainerType::New();
+    pixelContainer->SetNiftiImage( input_image, region.GetNumberOfPixels() );
+
+    auto resultImage = ItkImageType::New();
+    resultImage->SetRegions( region );
+    resultImage->SetOrigin( origin );
+    resultImage->SetSpacing( spacing );
+    resultImage->SetDirection( direction );
+    resultImage->SetPixelContainer( pixelContainer );
+    return resultImage;
+  }
+
+  // Get data pointer
+  if( numberOfThreads == 0 )
+  {
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  }
+  auto dataFromNifti = NiftiToItkImage< ItkImageType, NiftiPixelType >::Read( input_image, imageInformationFromNifti, numberOfThreads );
+
+  auto importImageFilter = itk::ImportImageFilter< typename ItkImageType::PixelType, ItkImageType::ImageDimension >::New();
   importImageFilter->SetRegion( region );
   importImageFilter->SetOrigin( origin );
   importImageFilter->SetSpacing( spacing );
@@ -107,6 +129,35 @@ NiftiToItkImage< ItkImageType, NiftiPixelType >
 }
 
 
+template< class ItkImageType, class NiftiPixelType >
+bool
+NiftiToItkImage< ItkImageType, NiftiPixelType >
+::CanShareData( std::shared_ptr< nifti_image > input_image, ImageInformationFromNifti const & imageInformationFromNifti,
+  size_t numberOfPixels )
+{
+  if( input_image->data == nullptr
+    || MustRescale( imageInformationFromNifti.rescaleSlope, imageInformationFromNifti.rescaleIntercept )
+    || ItkImageProperties< ItkImageType >::GetComponentType() != imageInformationFromNifti.componentType )
+  {
+    return false;
+  }
+
+  // if single or complex, nifti layout == itk layout
+  const unsigned int numComponents = ItkImageProperties< ItkImageType >::GetNumberOfComponents();
+  if( !( numComponents == 1
+    || ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::COMPLEX
+    || ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::RGB
+    || ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::RGBA ) )
+  {
+    return false;
+  }
+
+  // the buffer must hold exactly the pixels of the itk image
+  return static_cast< size_t >( input_image->nvox ) * static_cast< size_t >( input_image->nbyper )
+         == numberOfPixels * sizeof( typename ItkImageType::PixelType );
+}
+
+
 // Internal function to rescale pixel according to Rescale Slope/Intercept
 template< typename TBuffer >
 void
@@ -157,7 +208,7 @@ CastCopy( float * to, void * from, size_t pixelcount )
 template< class ItkImageType, class NiftiPixelType >
 DataFromNifti< typename ItkImageType::PixelType >
 NiftiToItkImage< ItkImageType, NiftiPixelType >
-::Read( std::shared_ptr< nifti_image > input_image, ImageInformationFromNifti const & imageInformationFromNifti )
+::Read( std::shared_ptr< nifti_image > input_image, ImageInformationFromNifti const & imageInformationFromNifti, unsigned int numberOfThreads )
 {
   size_t imageSizeInComponents = 1;
   for( size_t dimsize : imageInformationFromNifti.dimensions )
@@ -282,53 +333,24 @@ NiftiToItkImage< ItkImageType, NiftiPixelType >
   {
     // otherwise nifti is x y z t vec l m 0, itk is
     // vec x y z t l m o
-    const char * niftibuf   = (const char *)data;
-    char *       itkbuf     = (char *)buffer;
-    const size_t rowdist    = input_image->dim[ 1 ];
-    const size_t slicedist  = rowdist * input_image->dim[ 2 ];
-    const size_t volumedist = slicedist * input_image->dim[ 3 ];
-    const size_t seriesdist = volumedist * input_image->dim[ 4 ];
+    const size_t numVoxels
+      = size_t( input_image->dim[ 1 ] )
+      * size_t( input_image->dim[ 2 ] )
+      * size_t( input_image->dim[ 3 ] )
+      * size_t( input_image->dim[ 4 ] );
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
-    int * vecOrder;
+    int * vecOrder = nullptr;
     if( ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::DIFFUSIONTENSOR3D
       || ItkImageProperties< ItkImageType >::GetPixelType() == IOPixelType::SYMMETRICSECONDRANKTENSOR )
     {
       //      vecOrder = LowerToUpperOrder(SymMatDim(numComponents));
       vecOrder = UpperToLowerOrder( SymMatDim( numComponents ) );
     }
-    else
-    {
-      vecOrder = new int[ numComponents ];
-      for( unsigned int i = 0; i < numComponents; i++ )
-      {
-        vecOrder[ i ] = i;
-      }
-    }
-    for( int t = 0; t < input_image->dim[ 4 ]; t++ )
-    {
-      for( int z = 0; z < input_image->dim[ 3 ]; z++ )
-      {
-        for( int y = 0; y < input_image->dim[ 2 ]; y++ )
-        {
-          for( int x = 0; x < input_image->dim[ 1 ]; x++ )
-          {
-            for( unsigned int c = 0; c < numComponents; c++ )
-            {
-              const size_t nifti_index
-                = ( c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x ) * pixelSize;
-              const size_t itk_index
-                = ( ( volumedist * t + slicedist * z + rowdist * y + x ) * numComponents + vecOrder[ c ] ) * pixelSize;
-              for( unsigned int b = 0; b < pixelSize; ++b )
-              {
-                itkbuf[ itk_index + b ] = niftibuf[ nifti_index + b ];
-              }
-            }
-          }
-        }
-      }
-    }
+    // components are promoted to float if they had to be cast before rescaling
+    const unsigned int componentSize = data != input_image->data ? sizeof( float ) : input_image->nbyper;
+    NiftiVectorLayout::PlanarToInterleaved( data, buffer, numVoxels, numComponents, componentSize, vecOrder, numberOfThreads );
     delete[] vecOrder;
     if( data != input_image->data )
     {
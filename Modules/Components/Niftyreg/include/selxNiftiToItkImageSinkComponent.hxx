@@ -109,7 +109,7 @@ void
 NiftiToItkImageSinkComponent< Dimensionality, TPixel >::Update()
 {
   auto warpedNiftiImage = this->m_WarpedImageInterface->GetWarpedNiftiImage();
-  auto warpedItkImage   = NiftiToItkImage< ItkImageType, TPixel >::Convert( warpedNiftiImage );
+  auto warpedItkImage   = NiftiToItkImage< ItkImageType, TPixel >::Convert( warpedNiftiImage, this->GetNumberOfThreads() );
   //TPixel *    ptr;
   //SizeValueType  num;
   //std:tie(ptr,num) = NiftiToItkImage<ItkImageType, TPixel>::Convert(warpedNiftiImage);
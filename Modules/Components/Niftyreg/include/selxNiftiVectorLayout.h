@@ -0,0 +1,267 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxNiftiVectorLayout_h
+#define selxNiftiVectorLayout_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace selx
+{
+/** \class NiftiVectorLayout
+ * \brief Transposes vector pixel data between the interleaved layout of itk ([voxel][component])
+ * and the planar layout of nifti ([component][voxel]).
+ *
+ * Components are moved as words of the component size, by kernels that are specialized on the
+ * number of components (2 and 3, as in 2D and 3D displacement fields) and fall back on a run-time
+ * number of components otherwise. The voxels are split into contiguous ranges that are transposed
+ * by separate threads. The number of threads is up to the caller, e.g. the share of the ThreadBudget
+ * of the converting component; the kernels do not claim the cores of the machine by themselves.
+ *
+ * The optional componentOrder maps nifti component c to itk component componentOrder[ c ], e.g. to
+ * convert between the lower and upper triangular storage of symmetric tensors. nullptr means identity.
+ */
+class NiftiVectorLayout
+{
+public:
+
+  static void InterleavedToPlanar( const void * interleaved, void * planar, std::size_t numberOfVoxels,
+    unsigned int numberOfComponents, unsigned int componentSize, const int * componentOrder = nullptr,
+    unsigned int numberOfThreads = 1 )
+  {
+    Dispatch< ToPlanar >( interleaved, planar, numberOfVoxels, numberOfComponents, componentSize, componentOrder, numberOfThreads );
+  }
+
+
+  static void PlanarToInterleaved( const void * planar, void * interleaved, std::size_t numberOfVoxels,
+    unsigned int numberOfComponents, unsigned int componentSize, const int * componentOrder = nullptr,
+    unsigned int numberOfThreads = 1 )
+  {
+    Dispatch< ToInterleaved >( planar, interleaved, numberOfVoxels, numberOfComponents, componentSize, componentOrder, numberOfThreads );
+  }
+
+
+  /** Below this number of voxels per thread, splitting the work does not pay off */
+  static const std::size_t MinimumNumberOfVoxelsPerThread = 1 << 16;
+
+private:
+
+  // Component words are copied bitwise, so only their size matters
+  template< std::size_t VSize >
+  struct Word
+  {
+    unsigned char bytes[ VSize ];
+  };
+
+  // Compile-time number of components with identity order. The inner loop over the components is
+  // unrolled, such that each voxel is read (or written) once as a contiguous vector.
+  template< typename TWord, unsigned int VNumberOfComponents >
+  struct Kernel
+  {
+    static void ToPlanar( const TWord * interleaved, TWord * planar, std::size_t numberOfVoxels, std::size_t begin, std::size_t end,
+      unsigned int, const int * )
+    {
+      for( std::size_t voxel = begin; voxel < end; ++voxel )
+      {
+        const TWord * vector = interleaved + voxel * VNumberOfComponents;
+        for( unsigned int c = 0; c < VNumberOfComponents; ++c )
+        {
+          planar[ c * numberOfVoxels + voxel ] = vector[ c ];
+        }
+      }
+    }
+
+
+    static void ToInterleaved( const TWord * planar, TWord * interleaved, std::size_t numberOfVoxels, std::size_t begin, std::size_t end,
+      unsigned int, const int * )
+    {
+      for( std::size_t voxel = begin; voxel < end; ++voxel )
+      {
+        TWord * vector = interleaved + voxel * VNumberOfComponents;
+        for( unsigned int c = 0; c < VNumberOfComponents; ++c )
+        {
+          vector[ c ] = planar[ c * numberOfVoxels + voxel ];
+        }
+      }
+    }
+  };
+
+  // Run-time number of components and component order. Each component plane is written (or read) contiguously.
+  template< typename TWord >
+  struct Kernel< TWord, 0 >
+  {
+    static void ToPlanar( const TWord * interleaved, TWord * planar, std::size_t numberOfVoxels, std::size_t begin, std::size_t end,
+      unsigned int numberOfComponents, const int * componentOrder )
+    {
+      for( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+        const TWord * in  = interleaved + ( componentOrder ? componentOrder[ c ] : c );
+        TWord *       out = planar + c * numberOfVoxels;
+        for( std::size_t voxel = begin; voxel < end; ++voxel )
+        {
+          out[ voxel ] = in[ voxel * numberOfComponents ];
+        }
+      }
+    }
+
+
+    static void ToInterleaved( const TWord * planar, TWord * interleaved, std::size_t numberOfVoxels, std::size_t begin, std::size_t end,
+      unsigned int numberOfComponents, const int * componentOrder )
+    {
+      for( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+        const TWord * in  = planar + c * numberOfVoxels;
+        TWord *       out = interleaved + ( componentOrder ? componentOrder[ c ] : c );
+        for( std::size_t voxel = begin; voxel < end; ++voxel )
+        {
+          out[ voxel * numberOfComponents ] = in[ voxel ];
+        }
+      }
+    }
+  };
+
+  struct ToPlanar
+  {
+    template< typename TKernel, typename TWord >
+    static void Run( const TWord * from, TWord * to, std::size_t numberOfVoxels, std::size_t begin, std::size_t end,
+      unsigned int numberOfComponents, const int * componentOrder )
+    {
+      TKernel::ToPlanar( from, to, numberOfVoxels, begin, end, numberOfComponents, componentOrder );
+    }
+  };
+
+  struct ToInterleaved
+  {
+    template< typename TKernel, typename TWord >
+    static void Run( const TWord * from, TWord * to, std::size_t numberOfVoxels, std::size_t begin, std::size_t end,
+      unsigned int numberOfComponents, const int * componentOrder )
+    {
+      TKernel::ToInterleaved( from, to, numberOfVoxels, begin, end, numberOfComponents, componentOrder );
+    }
+  };
+
+  static bool IsIdentity( const int * componentOrder, unsigned int numberOfComponents )
+  {
+    for( unsigned int c = 0; componentOrder && c < numberOfComponents; ++c )
+    {
+      if( componentOrder[ c ] != static_cast< int >( c ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+
+  template< typename TDirection, typename TKernel, typename TWord >
+  static void Run( const void * from, void * to, std::size_t numberOfVoxels, unsigned int numberOfComponents,
+    const int * componentOrder, unsigned int numberOfThreads )
+  {
+    const TWord * typedFrom = static_cast< const TWord * >( from );
+    TWord *       typedTo   = static_cast< TWord * >( to );
+
+    const std::size_t maximumNumberOfThreads = std::max( std::size_t( 1 ), numberOfVoxels / MinimumNumberOfVoxelsPerThread );
+    numberOfThreads = static_cast< unsigned int >( std::min( std::size_t( std::max( 1u, numberOfThreads ) ), maximumNumberOfThreads ) );
+
+    if( numberOfThreads == 1 )
+    {
+      TDirection::template Run< TKernel >( typedFrom, typedTo, numberOfVoxels, 0, numberOfVoxels, numberOfComponents, componentOrder );
+      return;
+    }
+
+    // Threads write to disjoint voxel ranges of the output
+    const std::size_t        voxelsPerThread = ( numberOfVoxels + numberOfThreads - 1 ) / numberOfThreads;
+    std::vector< std::thread > threads;
+    for( unsigned int thread = 1; thread < numberOfThreads; ++thread )
+    {
+      const std::size_t begin = std::min( numberOfVoxels, thread * voxelsPerThread );
+      const std::size_t end   = std::min( numberOfVoxels, begin + voxelsPerThread );
+      threads.emplace_back( [ = ]() {
+        TDirection::template Run< TKernel >( typedFrom, typedTo, numberOfVoxels, begin, end, numberOfComponents, componentOrder );
+      } );
+    }
+    TDirection::template Run< TKernel >( typedFrom, typedTo, numberOfVoxels, 0, std::min( numberOfVoxels, voxelsPerThread ),
+      numberOfComponents, componentOrder );
+    for( auto & thread : threads )
+    {
+      thread.join();
+    }
+  }
+
+
+  template< typename TDirection, typename TWord >
+  static void DispatchNumberOfComponents( const void * from, void * to, std::size_t numberOfVoxels, unsigned int numberOfComponents,
+    const int * componentOrder, unsigned int numberOfThreads )
+  {
+    if( IsIdentity( componentOrder, numberOfComponents ) )
+    {
+      switch( numberOfComponents )
+      {
+        case 2:
+          Run< TDirection, Kernel< TWord, 2 >, TWord >( from, to, numberOfVoxels, numberOfComponents, nullptr, numberOfThreads );
+          return;
+        case 3:
+          Run< TDirection, Kernel< TWord, 3 >, TWord >( from, to, numberOfVoxels, numberOfComponents, nullptr, numberOfThreads );
+          return;
+        case 4:
+          Run< TDirection, Kernel< TWord, 4 >, TWord >( from, to, numberOfVoxels, numberOfComponents, nullptr, numberOfThreads );
+          return;
+        default:
+          break;
+      }
+    }
+    Run< TDirection, Kernel< TWord, 0 >, TWord >( from, to, numberOfVoxels, numberOfComponents, componentOrder, numberOfThreads );
+  }
+
+
+  template< typename TDirection >
+  static void Dispatch( const void * from, void * to, std::size_t numberOfVoxels, unsigned int numberOfComponents,
+    unsigned int componentSize, const int * componentOrder, unsigned int numberOfThreads )
+  {
+    switch( componentSize )
+    {
+      case 1:
+        DispatchNumberOfComponents< TDirection, std::uint8_t >( from, to, numberOfVoxels, numberOfComponents, componentOrder, numberOfThreads );
+        break;
+      case 2:
+        DispatchNumberOfComponents< TDirection, std::uint16_t >( from, to, numberOfVoxels, numberOfComponents, componentOrder, numberOfThreads );
+        break;
+      case 4:
+        DispatchNumberOfComponents< TDirection, std::uint32_t >( from, to, numberOfVoxels, numberOfComponents, componentOrder, numberOfThreads );
+        break;
+      case 8:
+        DispatchNumberOfComponents< TDirection, std::uint64_t >( from, to, numberOfVoxels, numberOfComponents, componentOrder, numberOfThreads );
+        break;
+      case 16:
+        DispatchNumberOfComponents< TDirection, Word< 16 >>( from, to, numberOfVoxels, numberOfComponents, componentOrder, numberOfThreads );
+        break;
+      default:
+        throw std::runtime_error( "NiftiVectorLayout does not support components of " + std::to_string( componentSize ) + " bytes" );
+    }
+  }
+};
+} // end namespace selx
+
+#endif // selxNiftiVectorLayout_h
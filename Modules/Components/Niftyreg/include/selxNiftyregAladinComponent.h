@@ -24,9 +24,12 @@
 #include "selxInterfaces.h"
 #include "selxNiftyregInterfaces.h"
 #include "_reg_aladin.h"
+#include "_reg_ReadWriteImage.h"
+#include "_reg_ReadWriteMatrix.h"
 
 #include <string.h>
 #include <array>
+#include <fstream>
 
 namespace selx
 {
@@ -62,6 +65,9 @@ public:
   mat44 * GetAffineNiftiMatrix() override;
 
   void Update() override;
+  void ReleaseData() override;
+  bool WriteResults( const std::string & directory ) override;
+  bool ReadResults( const std::string & directory ) override;
   bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
   static const char * GetDescription() { return "NiftyregAladin Component"; }
 
@@ -74,6 +80,10 @@ private:
   std::shared_ptr< nifti_image > m_floating_image;
   std::shared_ptr< nifti_image > m_warped_image;
   std::shared_ptr< nifti_image > m_input_mask;
+  std::unique_ptr< mat44 >       m_read_affine_matrix; // set by ReadResults instead of running the registration
+  typename NiftyregReferenceImageInterface< TPixel >::Pointer m_NiftyregReferenceImageInterface;
+  typename NiftyregFloatingImageInterface< TPixel >::Pointer m_NiftyregFloatingImageInterface;
+  typename NiftyregInputMaskInterface< unsigned char >::Pointer m_NiftyregInputMaskInterface;
 
 protected:
 
@@ -20,6 +20,10 @@
 #include "selxNiftyregAladinComponent.h"
 #include "selxCheckTemplateProperties.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace selx
 {
 template< class TPixel >
@@ -42,10 +46,8 @@ int
 NiftyregAladinComponent< TPixel >
 ::Accept(typename NiftyregReferenceImageInterface< TPixel >::Pointer component)
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_reference_image = component->GetReferenceNiftiImage();
-  // connect the itk pipeline
-  this->m_reg_aladin->SetInputReference( this->m_reference_image.get() );
+  // The image data is requested in Update, when the providing component has been updated
+  this->m_NiftyregReferenceImageInterface = component;
   return 0;
 }
 
@@ -55,10 +57,7 @@ int
 NiftyregAladinComponent< TPixel >
 ::Accept(typename NiftyregFloatingImageInterface< TPixel >::Pointer component)
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_floating_image = component->GetFloatingNiftiImage();
-  // connect the itk pipeline
-  this->m_reg_aladin->SetInputFloating(this->m_floating_image.get());
+  this->m_NiftyregFloatingImageInterface = component;
   return 0;
 }
 
@@ -68,10 +67,7 @@ int
 NiftyregAladinComponent< TPixel >
 ::Accept(typename NiftyregInputMaskInterface<  unsigned char  >::Pointer component)
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_input_mask = component->GetInputMask();
-  // connect the itk pipeline
-  this->m_reg_aladin->SetInputMask( this->m_input_mask.get() );
+  this->m_NiftyregInputMaskInterface = component;
   return 0;
 }
 
@@ -89,6 +85,10 @@ mat44 *
 NiftyregAladinComponent< TPixel >
 ::GetAffineNiftiMatrix()
 {
+  if( this->m_read_affine_matrix )
+  {
+    return this->m_read_affine_matrix.get();
+  }
   return this->m_reg_aladin->GetTransformationMatrix();
 }
 
@@ -98,6 +98,27 @@ NiftyregAladinComponent<  TPixel >
 ::Update()
 {
   this->m_Logger.Log(LogLevel::TRC, "Update: run registration");
+  this->m_read_affine_matrix = nullptr;
+
+#ifdef _OPENMP
+  // The number of OpenMP threads is a setting of the calling thread, so components that are updated concurrently do not interfere
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    omp_set_num_threads( static_cast< int >( this->GetNumberOfThreads() ) );
+  }
+#endif
+
+  // store the shared_ptr to the data, otherwise it gets freed
+  this->m_reference_image = this->m_NiftyregReferenceImageInterface->GetReferenceNiftiImage();
+  this->m_reg_aladin->SetInputReference( this->m_reference_image.get() );
+  this->m_floating_image = this->m_NiftyregFloatingImageInterface->GetFloatingNiftiImage();
+  this->m_reg_aladin->SetInputFloating( this->m_floating_image.get() );
+  if( this->m_NiftyregInputMaskInterface )
+  {
+    this->m_input_mask = this->m_NiftyregInputMaskInterface->GetInputMask();
+    this->m_reg_aladin->SetInputMask( this->m_input_mask.get() );
+  }
+
   this->m_reg_aladin->Run();
   nifti_image * outputWarpedImage = m_reg_aladin->GetFinalWarpedImage();
   memset( outputWarpedImage->descrip, 0, 80 );
@@ -109,6 +130,50 @@ NiftyregAladinComponent<  TPixel >
 }
 
 
+template< class TPixel >
+void
+NiftyregAladinComponent<  TPixel >
+::ReleaseData()
+{
+  // See Niftyregf3dComponent::ReleaseData. The warped image and the transformation matrix are kept.
+  this->m_reference_image = nullptr;
+  this->m_floating_image  = nullptr;
+  this->m_input_mask      = nullptr;
+}
+
+
+template< class TPixel >
+bool
+NiftyregAladinComponent<  TPixel >
+::WriteResults( const std::string & directory )
+{
+  std::string affineFileName = directory + "/AffineMatrix.txt";
+  reg_tool_WriteAffineFile( this->m_reg_aladin->GetTransformationMatrix(), &affineFileName[ 0 ] );
+  reg_io_WriteImageFile( this->m_warped_image.get(), ( directory + "/WarpedImage.nii.gz" ).c_str() );
+  return true;
+}
+
+
+template< class TPixel >
+bool
+NiftyregAladinComponent<  TPixel >
+::ReadResults( const std::string & directory )
+{
+  // NiftyReg exits the process on files that cannot be read
+  std::string       affineFileName = directory + "/AffineMatrix.txt";
+  const std::string warpedFileName = directory + "/WarpedImage.nii.gz";
+  if( !std::ifstream( affineFileName ) || !std::ifstream( warpedFileName ) )
+  {
+    return false;
+  }
+
+  this->m_read_affine_matrix = std::unique_ptr< mat44 >( new mat44 );
+  reg_tool_ReadAffineFile( this->m_read_affine_matrix.get(), &affineFileName[ 0 ] );
+  this->m_warped_image = std::shared_ptr< nifti_image >( reg_io_ReadImageFile( warpedFileName.c_str() ), nifti_image_free );
+  return true;
+}
+
+
 template< class TPixel >
 bool
 NiftyregAladinComponent<  TPixel >
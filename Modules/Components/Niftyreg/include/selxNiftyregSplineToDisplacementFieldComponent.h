@@ -62,12 +62,15 @@ public:
   // Providing UpdateInterface
   virtual void Update() override;
 
+  virtual void ReleaseData() override;
+
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
   static const char * GetDescription() { return "NiftyregSplineToDisplacementField Component"; }
 
 private:
   typename NiftyregControlPointPositionImageInterface< TPixel >::Pointer m_NiftyregControlPointPositionImageInterface;
+  typename NiftyregReferenceImageInterface< TPixel >::Pointer m_NiftyregReferenceImageInterface;
   std::shared_ptr< nifti_image > m_reference_image;
   std::shared_ptr< nifti_image > m_cpp_image;
   std::shared_ptr< nifti_image > m_displacement_image;
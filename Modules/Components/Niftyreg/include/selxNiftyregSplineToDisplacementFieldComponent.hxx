@@ -39,8 +39,8 @@ int
 NiftyregSplineToDisplacementFieldComponent< TPixel >
 ::Accept( typename NiftyregReferenceImageInterface< TPixel >::Pointer component )
 {
-  // store the shared_ptr, otherwise the data might get freed
-  this->m_reference_image = component->GetReferenceNiftiImage();
+  // The image data is requested in Update, when the providing component has been updated
+  this->m_NiftyregReferenceImageInterface = component;
   return 0;
 }
 
@@ -59,7 +59,9 @@ void
 NiftyregSplineToDisplacementFieldComponent<  TPixel >
 ::Update()
 {
-  
+  // store the shared_ptr, otherwise the data might get freed
+  this->m_reference_image = this->m_NiftyregReferenceImageInterface->GetReferenceNiftiImage();
+
   nifti_image * inputTransformationImage = this->m_NiftyregControlPointPositionImageInterface->GetControlPointPositionImage().get();
   
   // Create a dense field
@@ -112,6 +114,15 @@ NiftyregSplineToDisplacementFieldComponent<  TPixel >
   return;
 }
 
+template< class TPixel >
+void
+NiftyregSplineToDisplacementFieldComponent< TPixel >
+::ReleaseData()
+{
+  // The nifti copy of the reference image only provides the geometry of the displacement field, which is kept
+  this->m_reference_image = nullptr;
+}
+
 template< class TPixel >
 std::shared_ptr< nifti_image >
 NiftyregSplineToDisplacementFieldComponent< TPixel >
@@ -24,9 +24,11 @@
 #include "selxInterfaces.h"
 #include "selxNiftyregInterfaces.h"
 #include "_reg_f3d.h"
+#include "_reg_ReadWriteImage.h"
 
 #include <string.h>
 #include <array>
+#include <fstream>
 
 namespace selx
 {
@@ -61,6 +63,9 @@ public:
   std::shared_ptr< nifti_image > GetWarpedNiftiImage() override;
   std::shared_ptr< nifti_image > GetControlPointPositionImage() override;
   void Update() override;
+  void ReleaseData() override;
+  bool WriteResults( const std::string & directory ) override;
+  bool ReadResults( const std::string & directory ) override;
 
   bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
   bool ConnectionsSatisfied() override;
@@ -76,7 +81,11 @@ private:
   // m_warped_images is an array of 2 nifti images. Depending on the use case, typically only [0] is a valid image
   std::unique_ptr< std::array< std::shared_ptr< nifti_image >, 2 >> m_warped_images;
   std::shared_ptr< nifti_image > m_cpp_image;
+  typename NiftyregReferenceImageInterface< TPixel >::Pointer m_NiftyregReferenceImageInterface;
+  typename NiftyregFloatingImageInterface< TPixel >::Pointer m_NiftyregFloatingImageInterface;
   typename NiftyregAffineMatrixInterface::Pointer m_NiftyregAffineMatrixInterface;
+  typename NiftyregControlPointPositionImageInterface< TPixel >::Pointer m_NiftyregControlPointPositionImageInterface;
+  typename NiftyregInputMaskInterface< unsigned char >::Pointer m_NiftyregInputMaskInterface;
 
 protected:
 
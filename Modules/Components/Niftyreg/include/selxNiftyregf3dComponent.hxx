@@ -21,6 +21,10 @@
 #include "selxNiftyregf3dComponent.h"
 #include "selxCheckTemplateProperties.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace selx
 {
 template< class TPixel >
@@ -49,9 +53,8 @@ int
 Niftyregf3dComponent< TPixel >
 ::Accept( typename NiftyregReferenceImageInterface< TPixel >::Pointer component )
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_reference_image = component->GetReferenceNiftiImage();
-  this->m_reg_f3d->SetReferenceImage( this->m_reference_image.get() );
+  // The image data is requested in Update, when the providing component has been updated
+  this->m_NiftyregReferenceImageInterface = component;
   return 0;
 }
 
@@ -61,9 +64,7 @@ int
 Niftyregf3dComponent< TPixel >
 ::Accept( typename NiftyregFloatingImageInterface< TPixel >::Pointer component )
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_floating_image = component->GetFloatingNiftiImage();
-  this->m_reg_f3d->SetFloatingImage( this->m_floating_image.get() );
+  this->m_NiftyregFloatingImageInterface = component;
   return 0;
 }
 
@@ -81,7 +82,7 @@ int
 Niftyregf3dComponent< TPixel >
 ::Accept( typename NiftyregControlPointPositionImageInterface< TPixel >::Pointer component )
 {
-  this->m_reg_f3d->SetControlPointGridImage(component->GetControlPointPositionImage().get());
+  this->m_NiftyregControlPointPositionImageInterface = component;
   return 0;
 }
 
@@ -91,10 +92,7 @@ int
 Niftyregf3dComponent< TPixel >
 ::Accept(typename NiftyregInputMaskInterface<  unsigned char  >::Pointer component)
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_input_mask = component->GetInputMask();
-  // connect the itk pipeline
-  this->m_reg_f3d->SetReferenceMask( this->m_input_mask.get() );
+  this->m_NiftyregInputMaskInterface = component;
   return 0;
 }
 
@@ -121,8 +119,32 @@ Niftyregf3dComponent< TPixel >
 ::Update()
 {
   this->m_Logger.Log(LogLevel::TRC, "Update: run registration");
+
+#ifdef _OPENMP
+  // Only affects the OpenMP regions of reg_f3d started from this thread
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    omp_set_num_threads( static_cast< int >( this->GetNumberOfThreads() ) );
+  }
+#endif
+
   //this->m_reg_f3d->UseSSD( 0, true );
   //this->m_reg_f3d->UseCubicSplineInterpolation();
+
+  // store the shared_ptr to the data, otherwise it gets freed
+  this->m_reference_image = this->m_NiftyregReferenceImageInterface->GetReferenceNiftiImage();
+  this->m_reg_f3d->SetReferenceImage( this->m_reference_image.get() );
+  this->m_floating_image = this->m_NiftyregFloatingImageInterface->GetFloatingNiftiImage();
+  this->m_reg_f3d->SetFloatingImage( this->m_floating_image.get() );
+  if( this->m_NiftyregInputMaskInterface )
+  {
+    this->m_input_mask = this->m_NiftyregInputMaskInterface->GetInputMask();
+    this->m_reg_f3d->SetReferenceMask( this->m_input_mask.get() );
+  }
+  if( this->m_NiftyregControlPointPositionImageInterface )
+  {
+    this->m_reg_f3d->SetControlPointGridImage( this->m_NiftyregControlPointPositionImageInterface->GetControlPointPositionImage().get() );
+  }
   if (this->m_NiftyregAffineMatrixInterface)
   {
     this->m_reg_f3d->SetAffineTransformation(this->m_NiftyregAffineMatrixInterface->GetAffineNiftiMatrix());
@@ -147,6 +169,53 @@ Niftyregf3dComponent< TPixel >
 
 }
 
+
+template< class TPixel >
+void
+Niftyregf3dComponent< TPixel >
+::ReleaseData()
+{
+  // The nifti copies of the inputs are only needed to run the registration. reg_f3d does not own them and only uses
+  // them in Run, which gets new copies. The warped images and the control point grid are kept.
+  this->m_reference_image = nullptr;
+  this->m_floating_image  = nullptr;
+  this->m_input_mask      = nullptr;
+}
+
+
+template< class TPixel >
+bool
+Niftyregf3dComponent< TPixel >
+::WriteResults( const std::string & directory )
+{
+  reg_io_WriteImageFile( ( *( this->m_warped_images.get() ) )[ 0 ].get(), ( directory + "/WarpedImage.nii.gz" ).c_str() );
+  reg_io_WriteImageFile( this->m_cpp_image.get(), ( directory + "/ControlPointPositionImage.nii.gz" ).c_str() );
+  return true;
+}
+
+
+template< class TPixel >
+bool
+Niftyregf3dComponent< TPixel >
+::ReadResults( const std::string & directory )
+{
+  // NiftyReg exits the process on files that cannot be read
+  const std::string warpedFileName       = directory + "/WarpedImage.nii.gz";
+  const std::string controlPointFileName = directory + "/ControlPointPositionImage.nii.gz";
+  if( !std::ifstream( warpedFileName ) || !std::ifstream( controlPointFileName ) )
+  {
+    return false;
+  }
+
+  // Only the forward warped image is provided
+  this->m_warped_images
+    = std::unique_ptr< std::array< std::shared_ptr< nifti_image >,
+    2 >>( new std::array< std::shared_ptr< nifti_image >, 2 > );
+  (*(this->m_warped_images.get()))[0] = std::shared_ptr< nifti_image >( reg_io_ReadImageFile( warpedFileName.c_str() ), nifti_image_free );
+  this->m_cpp_image = std::shared_ptr< nifti_image >( reg_io_ReadImageFile( controlPointFileName.c_str() ), nifti_image_free );
+  return true;
+}
+
 template< class TPixel >
 bool
 Niftyregf3dComponent< TPixel >
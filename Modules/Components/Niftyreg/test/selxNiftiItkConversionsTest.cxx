@@ -146,4 +146,44 @@ TEST_F(NiftiItkConversionsTest, NiftiToItkImage)
   ASSERT_EQ(0.0f, compareFilter->GetTotalDifference());
 }
 
+TEST_F(NiftiItkConversionsTest, NiftiToItkImageSharedData)
+{
+  // nifti images of scalar pixels have the same data layout as itk images, so data will be shared
+  using itkImageType = itk::Image<float, 3>;
+  int dims[8] = { 3, 16, 16, 16, 1, 1, 1, 1 };
+  std::shared_ptr< nifti_image > niftiImage(nifti_make_new_nim(dims, NIFTI_TYPE_FLOAT32, 1), nifti_image_free);
+  void* niftiData = niftiImage->data;
+
+  auto itkImage = selx::NiftiToItkImage<itkImageType, float>::Convert(niftiImage);
+  ASSERT_EQ(niftiData, static_cast<void*>(itkImage->GetBufferPointer()));
+  // the pixel container of the itk image co-owns the nifti image
+  ASSERT_EQ(2, niftiImage.use_count());
+
+  niftiImage.reset();
+  // Test if memory still exists by writing to it.
+  float* floatdata = itkImage->GetBufferPointer();
+  for (unsigned int index = 0; index < 16 * 16 * 16; ++index)
+  {
+    ASSERT_EQ(0, floatdata[index]);
+    ASSERT_NO_THROW(floatdata[index] = 42.0f);
+  }
+}
+
+TEST_F(NiftiItkConversionsTest, NiftiToItkImageCopiedData)
+{
+  // rescaling requires a copy, so the nifti data is left untouched
+  using itkImageType = itk::Image<float, 3>;
+  int dims[8] = { 3, 16, 16, 16, 1, 1, 1, 1 };
+  std::shared_ptr< nifti_image > niftiImage(nifti_make_new_nim(dims, NIFTI_TYPE_FLOAT32, 1), nifti_image_free);
+  niftiImage->qform_code = NIFTI_XFORM_SCANNER_ANAT;
+  niftiImage->scl_slope = 2.0f;
+  niftiImage->scl_inter = 1.0f;
+
+  auto itkImage = selx::NiftiToItkImage<itkImageType, float>::Convert(niftiImage);
+  ASSERT_NE(niftiImage->data, static_cast<void*>(itkImage->GetBufferPointer()));
+  ASSERT_EQ(1, niftiImage.use_count());
+  ASSERT_EQ(1.0f, itkImage->GetBufferPointer()[0]);
+  ASSERT_EQ(0.0f, static_cast<float*>(niftiImage->data)[0]);
+}
+
 }
@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxNiftiVectorLayout.h"
+#include "selxTestUtilities.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <numeric>
+
+namespace selx
+{
+class NiftiVectorLayoutTest : public ::testing::Test
+{
+public:
+
+  // The byte-by-byte transpose the nifti converters used before
+  static void ReferenceInterleavedToPlanar( const void * interleaved, void * planar, std::size_t numberOfVoxels,
+    unsigned int numberOfComponents, unsigned int componentSize, const int * componentOrder )
+  {
+    const char * in  = static_cast< const char * >( interleaved );
+    char *       out = static_cast< char * >( planar );
+    for( std::size_t voxel = 0; voxel < numberOfVoxels; ++voxel )
+    {
+      for( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+        const std::size_t planarIndex      = ( c * numberOfVoxels + voxel ) * componentSize;
+        const std::size_t interleavedIndex = ( voxel * numberOfComponents + ( componentOrder ? componentOrder[ c ] : c ) ) * componentSize;
+        for( unsigned int b = 0; b < componentSize; ++b )
+        {
+          out[ planarIndex + b ] = in[ interleavedIndex + b ];
+        }
+      }
+    }
+  }
+
+
+  template< typename TComponent >
+  static void CheckRoundTrip( std::size_t numberOfVoxels, unsigned int numberOfComponents, const int * componentOrder,
+    unsigned int numberOfThreads )
+  {
+    std::vector< TComponent > interleaved( numberOfVoxels * numberOfComponents );
+    std::iota( interleaved.begin(), interleaved.end(), TComponent( 0 ) );
+
+    std::vector< TComponent > expected( interleaved.size() );
+    ReferenceInterleavedToPlanar( interleaved.data(), expected.data(), numberOfVoxels, numberOfComponents, sizeof( TComponent ), componentOrder );
+
+    std::vector< TComponent > planar( interleaved.size() );
+    NiftiVectorLayout::InterleavedToPlanar( interleaved.data(), planar.data(), numberOfVoxels, numberOfComponents,
+      sizeof( TComponent ), componentOrder, numberOfThreads );
+    EXPECT_EQ( expected, planar );
+
+    std::vector< TComponent > roundTrip( interleaved.size() );
+    NiftiVectorLayout::PlanarToInterleaved( planar.data(), roundTrip.data(), numberOfVoxels, numberOfComponents,
+      sizeof( TComponent ), componentOrder, numberOfThreads );
+    EXPECT_EQ( interleaved, roundTrip );
+  }
+};
+
+TEST_F( NiftiVectorLayoutTest, DisplacementFields )
+{
+  // an odd number of voxels, such that the last thread gets a partial range
+  const std::size_t numberOfVoxels = 3 * NiftiVectorLayout::MinimumNumberOfVoxelsPerThread + 7;
+  for( unsigned int numberOfThreads : { 1u, 4u } )
+  {
+    CheckRoundTrip< float >( numberOfVoxels, 2, nullptr, numberOfThreads );
+    CheckRoundTrip< float >( numberOfVoxels, 3, nullptr, numberOfThreads );
+    CheckRoundTrip< double >( numberOfVoxels, 2, nullptr, numberOfThreads );
+    CheckRoundTrip< double >( numberOfVoxels, 3, nullptr, numberOfThreads );
+  }
+}
+
+TEST_F( NiftiVectorLayoutTest, ComponentOrder )
+{
+  // a b d c e f, as the lower triangular storage of a symmetric 3x3 tensor in nifti
+  const int componentOrder[] = { 0, 1, 3, 2, 4, 5 };
+  CheckRoundTrip< float >( 1000, 6, componentOrder, 1 );
+  CheckRoundTrip< short >( 1000, 6, componentOrder, 1 );
+  CheckRoundTrip< unsigned char >( 1000, 5, nullptr, 1 );
+}
+
+TEST_F( NiftiVectorLayoutTest, UnsupportedComponentSize )
+{
+  char buffer[ 6 ] = {};
+  EXPECT_THROW( NiftiVectorLayout::InterleavedToPlanar( buffer, buffer, 1, 2, 3 ), std::runtime_error );
+}
+
+#ifdef SUPERELASTIX_BUILD_LONG_UNIT_TESTS
+TEST_F( NiftiVectorLayoutTest, Benchmark )
+{
+  // 3D displacement field of 128^3 voxels with float components
+  const std::size_t          numberOfVoxels     = 128 * 128 * 128;
+  const unsigned int         numberOfComponents = 3;
+  std::vector< float >       interleaved( numberOfVoxels * numberOfComponents, 1.0f );
+  std::vector< float >       planar( interleaved.size(), 0.0f );
+
+  const double reference = TestUtilities::MeasureMilliseconds( [ & ]() {
+      ReferenceInterleavedToPlanar( interleaved.data(), planar.data(), numberOfVoxels, numberOfComponents, sizeof( float ), nullptr );
+    } );
+  const double singleThreaded = TestUtilities::MeasureMilliseconds( [ & ]() {
+      NiftiVectorLayout::InterleavedToPlanar( interleaved.data(), planar.data(), numberOfVoxels, numberOfComponents, sizeof( float ), nullptr, 1 );
+    } );
+  const double multiThreaded = TestUtilities::MeasureMilliseconds( [ & ]() {
+      NiftiVectorLayout::InterleavedToPlanar( interleaved.data(), planar.data(), numberOfVoxels, numberOfComponents, sizeof( float ), nullptr, 4 );
+    } );
+
+  std::cout << "Transpose of 128^3 displacement field (float, 3 components):" << std::endl;
+  std::cout << "  byte-by-byte:     " << reference << " ms" << std::endl;
+  std::cout << "  kernel, 1 thread: " << singleThreaded << " ms" << std::endl;
+  std::cout << "  kernel, 4 threads: " << multiThreaded << " ms" << std::endl;
+}
+#endif
+} // namespace selx
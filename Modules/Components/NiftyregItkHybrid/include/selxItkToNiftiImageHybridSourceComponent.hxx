@@ -52,7 +52,7 @@ ItkToNiftiImageHybridSourceComponent< Dimensionality, TPixel >::GetReferenceNift
   // and the itk image is invalidated. However, subsequently destructing the itk
   // image should be without memory leaks.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -73,7 +73,7 @@ ItkToNiftiImageHybridSourceComponent< Dimensionality, TPixel >::GetFloatingNifti
   // and the itk image is invalidated. However, subsequently destructing the itk
   // image should be without memory leaks.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -94,7 +94,7 @@ ItkToNiftiImageHybridSourceComponent< Dimensionality, TPixel >::GetWarpedNiftiIm
   // and the itk image is invalidated. However, subsequently destructing the itk
   // image should be without memory leaks.
 
-  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, TPixel >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -115,7 +115,7 @@ ItkToNiftiImageHybridSourceComponent< Dimensionality, TPixel >::GetInputMask()
   // and the itk image is invalidated. However, subsequently destructing the itk
   // image should be without memory leaks.
 
-  return ItkToNiftiImage< ItkImageType, unsigned char >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, unsigned char >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -136,7 +136,7 @@ ItkToNiftiImageHybridSourceComponent< Dimensionality, TPixel >::GetInputFloating
   // and the itk image is invalidated. However, subsequently destructing the itk
   // image should be without memory leaks.
 
-  return ItkToNiftiImage< ItkImageType, unsigned char >::Convert( this->m_Image );
+  return ItkToNiftiImage< ItkImageType, unsigned char >::Convert( this->m_Image, this->GetNumberOfThreads() );
 }
 
 
@@ -69,6 +69,8 @@ public:
   virtual AnyFileWriter::Pointer GetOutputFileWriter( void ) override;
   virtual itk::DataObject::Pointer GetInitializedOutput( void ) override;
 
+  virtual bool UpdateMiniPipelineOutput( itk::DataObject::Pointer requestedOutput ) override;
+
   // Accept interfaces
   virtual int Accept( itkDisplacementFieldInterfacePointer ) override;
 
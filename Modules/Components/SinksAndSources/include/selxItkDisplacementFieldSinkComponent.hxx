@@ -102,6 +102,17 @@ ItkDisplacementFieldSinkComponent< Dimensionality, TPixel >
 }
 
 
+template< int Dimensionality, class TPixel >
+bool
+ItkDisplacementFieldSinkComponent< Dimensionality, TPixel >
+::UpdateMiniPipelineOutput( itk::DataObject::Pointer requestedOutput )
+{
+  this->m_MiniPipelineOutputDisplacementField->SetRequestedRegion( requestedOutput );
+  this->m_MiniPipelineOutputDisplacementField->Update();
+  return this->m_MiniPipelineOutputDisplacementField->GetBufferedRegion() == this->m_MiniPipelineOutputDisplacementField->GetLargestPossibleRegion();
+}
+
+
 template< int Dimensionality, class TPixel >
 bool
 ItkDisplacementFieldSinkComponent< Dimensionality, TPixel >
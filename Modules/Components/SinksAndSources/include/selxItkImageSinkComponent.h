@@ -70,6 +70,8 @@ public:
 
   virtual itk::DataObject::Pointer GetInitializedOutput( void ) override;
 
+  virtual bool UpdateMiniPipelineOutput( itk::DataObject::Pointer requestedOutput ) override;
+
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
   static const char * GetDescription() { return "ItkImageSink Component"; }
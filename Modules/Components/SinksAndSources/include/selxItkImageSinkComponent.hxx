@@ -95,6 +95,16 @@ ItkImageSinkComponent< Dimensionality, TPixel >::GetInitializedOutput()
 }
 
 
+template< int Dimensionality, class TPixel >
+bool
+ItkImageSinkComponent< Dimensionality, TPixel >::UpdateMiniPipelineOutput( itk::DataObject::Pointer requestedOutput )
+{
+  this->m_MiniPipelineOutputImage->SetRequestedRegion( requestedOutput );
+  this->m_MiniPipelineOutputImage->Update();
+  return this->m_MiniPipelineOutputImage->GetBufferedRegion() == this->m_MiniPipelineOutputImage->GetLargestPossibleRegion();
+}
+
+
 template< int Dimensionality, class TPixel >
 bool
 ItkImageSinkComponent< Dimensionality, TPixel >::MeetsCriterion( const ComponentBase::CriterionType & criterion )
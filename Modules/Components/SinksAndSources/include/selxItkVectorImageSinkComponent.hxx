@@ -97,6 +97,16 @@ ItkVectorImageSinkComponent< Dimensionality, TPixel >::GetInitializedOutput()
 }
 
 
+template< int Dimensionality, class TPixel >
+bool
+ItkVectorImageSinkComponent< Dimensionality, TPixel >::UpdateMiniPipelineOutput( itk::DataObject::Pointer requestedOutput )
+{
+  this->m_MiniPipelineOutputVectorImage->SetRequestedRegion( requestedOutput );
+  this->m_MiniPipelineOutputVectorImage->Update();
+  return this->m_MiniPipelineOutputVectorImage->GetBufferedRegion() == this->m_MiniPipelineOutputVectorImage->GetLargestPossibleRegion();
+}
+
+
 template< int Dimensionality, class TPixel >
 bool
 ItkVectorImageSinkComponent< Dimensionality, TPixel >::MeetsCriterion( const ComponentBase::CriterionType & criterion )
@@ -32,4 +32,10 @@ set( ${MODULE}_LIBRARIES
 
 set( ${MODULE}_TEST_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/test/selxRegistrationItkv4Test.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxAffineResampleImageFilterTest.cxx
+)
+
+set( ${MODULE}_MODULE_DEPENDENCIES
+  ModuleIntensityPreprocessing
+  ModuleImagePyramid
 )
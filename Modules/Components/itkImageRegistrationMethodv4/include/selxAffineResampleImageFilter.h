@@ -0,0 +1,108 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxAffineResampleImageFilter_h
+#define selxAffineResampleImageFilter_h
+
+#include "itkResampleImageFilter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+
+#include <type_traits>
+
+namespace selx
+{
+/** \class AffineResampleImageFilter
+ * \brief ResampleImageFilter with a fast path for linear transforms.
+ *
+ * If the transform is linear (affine, rigid, translation, identity), the interpolator is linear or
+ * nearest neighbour, no extrapolator is set and the pixels are scalars, each output scanline is
+ * resampled by stepping the continuous input index incrementally instead of calling TransformPoint
+ * and a virtual Evaluate per voxel. The part of a scanline that maps outside the input is computed
+ * up front, so the interpolation loop does not branch. Threads resample slabs of the output.
+ *
+ * Otherwise the filter falls back to the generic path of itk::ResampleImageFilter.
+ */
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType = double,
+class TTransformPrecisionType = TInterpolatorPrecisionType >
+class AffineResampleImageFilter :
+  public itk::ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+{
+public:
+
+  /** Standard class typedefs. */
+  typedef AffineResampleImageFilter Self;
+  typedef itk::ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType,
+    TTransformPrecisionType >                Superclass;
+  typedef itk::SmartPointer< Self >       Pointer;
+  typedef itk::SmartPointer< const Self > ConstPointer;
+
+  itkNewMacro( Self );
+  itkTypeMacro( AffineResampleImageFilter, ResampleImageFilter );
+
+  itkStaticConstMacro( ImageDimension, unsigned int, TOutputImage::ImageDimension );
+
+  typedef typename Superclass::InputImageType        InputImageType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename Superclass::TransformType         TransformType;
+  typedef typename InputImageType::PixelType         InputPixelType;
+  typedef typename OutputImageType::PixelType        OutputPixelType;
+
+  typedef itk::LinearInterpolateImageFunction< InputImageType, TInterpolatorPrecisionType >          LinearInterpolatorType;
+  typedef itk::NearestNeighborInterpolateImageFunction< InputImageType, TInterpolatorPrecisionType > NearestNeighborInterpolatorType;
+
+  /** Whether the last update took the fast path */
+  itkGetConstMacro( FastPath, bool );
+
+protected:
+
+  AffineResampleImageFilter();
+  ~AffineResampleImageFilter() {}
+
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  void ThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+
+  ITK_DISALLOW_COPY_AND_ASSIGN( AffineResampleImageFilter );
+
+  typedef std::integral_constant< bool, std::is_arithmetic< InputPixelType >::value
+    && std::is_arithmetic< OutputPixelType >::value > HasScalarPixels;
+
+  void FastThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId, std::true_type );
+
+  void FastThreadedGenerateData( const OutputImageRegionType &, itk::ThreadIdType, std::false_type ) {}
+
+  bool m_FastPath;
+  bool m_NearestNeighbor;
+
+  /** Maps an output index to a continuous input index */
+  double m_IndexMatrix[ ImageDimension ][ ImageDimension ];
+  double m_IndexOffset[ ImageDimension ];
+};
+} // end namespace selx
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxAffineResampleImageFilter.hxx"
+#endif
+
+#endif // selxAffineResampleImageFilter_h
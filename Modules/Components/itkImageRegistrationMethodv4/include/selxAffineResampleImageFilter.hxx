@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxAffineResampleImageFilter_hxx
+#define selxAffineResampleImageFilter_hxx
+
+#include "selxAffineResampleImageFilter.h"
+#include "selxFlattenTransform.h"
+#include "selxResampleKernels.h"
+
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+namespace selx
+{
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+AffineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::AffineResampleImageFilter() :
+  m_FastPath( false ),
+  m_NearestNeighbor( false )
+{
+}
+
+
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+void
+AffineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  const InputImageType * input     = this->GetInput();
+  const TransformType *  transform = this->GetTransform();
+  const auto *           interpolator = this->GetInterpolator();
+
+  this->m_NearestNeighbor = dynamic_cast< const NearestNeighborInterpolatorType * >( interpolator ) != nullptr;
+  this->m_FastPath        = HasScalarPixels::value
+    && transform->GetTransformCategory() == TransformType::Linear
+    && this->GetExtrapolator() == nullptr
+    && ( this->m_NearestNeighbor || dynamic_cast< const LinearInterpolatorType * >( interpolator ) != nullptr )
+    && input->GetBufferedRegion().GetNumberOfPixels() > 0;
+  if( !this->m_FastPath )
+  {
+    return;
+  }
+
+  // Compose output index to point, the transform, and input point to index into one affine map
+  const auto   affine         = ToAffineTransform< TTransformPrecisionType, ImageDimension >( transform );
+  const auto & transformMatrix = affine->GetMatrix();
+  const auto & transformOffset = affine->GetOffset();
+  const auto & outputIndexToPoint = this->GetOutput()->GetIndexToPhysicalPoint();
+  const auto & inputPointToIndex  = input->GetPhysicalPointToIndex();
+  const auto & outputOrigin = this->GetOutput()->GetOrigin();
+  const auto & inputOrigin  = input->GetOrigin();
+
+  double pointMatrix[ ImageDimension ][ ImageDimension ];
+  double pointOffset[ ImageDimension ];
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    pointOffset[ i ] = transformOffset[ i ] - inputOrigin[ i ];
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+      pointOffset[ i ]      += transformMatrix[ i ][ j ] * outputOrigin[ j ];
+      pointMatrix[ i ][ j ] = 0.0;
+      for( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+        pointMatrix[ i ][ j ] += transformMatrix[ i ][ k ] * outputIndexToPoint[ k ][ j ];
+      }
+    }
+  }
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    this->m_IndexOffset[ i ] = 0.0;
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+      this->m_IndexOffset[ i ]      += inputPointToIndex[ i ][ j ] * pointOffset[ j ];
+      this->m_IndexMatrix[ i ][ j ] = 0.0;
+      for( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+        this->m_IndexMatrix[ i ][ j ] += inputPointToIndex[ i ][ k ] * pointMatrix[ k ][ j ];
+      }
+    }
+  }
+}
+
+
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+void
+AffineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::ThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId )
+{
+  if( !this->m_FastPath )
+  {
+    Superclass::ThreadedGenerateData( outputRegionForThread, threadId );
+    return;
+  }
+  this->FastThreadedGenerateData( outputRegionForThread, threadId, HasScalarPixels() );
+}
+
+
+template< class TInputImage, class TOutputImage, class TInterpolatorPrecisionType, class TTransformPrecisionType >
+void
+AffineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::FastThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, itk::ThreadIdType threadId, std::true_type )
+{
+  if( outputRegionForThread.GetNumberOfPixels() == 0 )
+  {
+    return;
+  }
+
+  const InputImageType * input  = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+  const BufferSampler< InputPixelType, ImageDimension > sampler( input->GetBufferPointer(),
+    input->GetBufferedRegion().GetIndex(), input->GetBufferedRegion().GetSize() );
+  const OutputPixelType defaultValue = this->GetDefaultPixelValue();
+
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+  double            step[ ImageDimension ];
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    step[ i ] = this->m_IndexMatrix[ i ][ 0 ];
+  }
+
+  itk::ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  itk::ImageScanlineIterator< OutputImageType > it( output, outputRegionForThread );
+  while( !it.IsAtEnd() )
+  {
+    const auto index = it.GetIndex();
+    double     start[ ImageDimension ];
+    for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+      start[ i ] = this->m_IndexOffset[ i ];
+      for( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+        start[ i ] += this->m_IndexMatrix[ i ][ j ] * index[ j ];
+      }
+    }
+
+    OutputPixelType * line = output->GetBufferPointer() + output->ComputeOffset( index );
+    if( this->m_NearestNeighbor )
+    {
+      ResampleAffineScanline< false >( sampler, start, step, lineLength, defaultValue, line );
+    }
+    else
+    {
+      ResampleAffineScanline< true >( sampler, start, step, lineLength, defaultValue, line );
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  }
+}
+} // end namespace selx
+
+#endif // selxAffineResampleImageFilter_hxx
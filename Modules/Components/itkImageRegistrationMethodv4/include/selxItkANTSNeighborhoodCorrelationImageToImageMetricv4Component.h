@@ -82,7 +82,8 @@ public:
 
   static const char * GetDescription() { return "ItkANTSNeighborhoodCorrelationImageToImageMetricv4 Component"; }
 
-  void BeforeUpdate() override;
+  // The masks are read when the network is executed, before the registration that uses this metric is updated
+  void Update() override;
 
 private:
 
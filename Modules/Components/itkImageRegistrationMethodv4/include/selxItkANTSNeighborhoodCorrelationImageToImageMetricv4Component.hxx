@@ -57,7 +57,7 @@ ItkANTSNeighborhoodCorrelationImageToImageMetricv4Component< Dimensionality, TPi
 
 template< int Dimensionality, class TPixel >
 void
-ItkANTSNeighborhoodCorrelationImageToImageMetricv4Component< Dimensionality, TPixel >::BeforeUpdate()
+ItkANTSNeighborhoodCorrelationImageToImageMetricv4Component< Dimensionality, TPixel >::Update()
 {
   if(this->m_FixedMask) {
     // The fixedMaskSpatialObject requires the mask to buffered when set
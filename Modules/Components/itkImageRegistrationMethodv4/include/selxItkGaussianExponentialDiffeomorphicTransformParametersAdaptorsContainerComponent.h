@@ -24,6 +24,7 @@
 
 #include "selxItkRegistrationMethodv4Interfaces.h"
 #include "selxSinksAndSourcesInterfaces.h"
+#include "selxImagePyramidInterfaces.h"
 
 #include "itkImageRegistrationMethodv4.h"
 #include "itkGradientDescentOptimizerv4.h"
@@ -39,7 +40,7 @@ namespace selx
 template< int Dimensionality, class TransformInternalComputationValueType >
 class ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent :
   public SuperElastixComponent<
-  Accepting< itkImageDomainFixedInterface< Dimensionality >>,
+  Accepting< itkImageDomainFixedInterface< Dimensionality >, itkImagePyramidInterface< Dimensionality >>,
   Providing< itkTransformParametersAdaptorsContainerInterface< TransformInternalComputationValueType, Dimensionality >, UpdateInterface
   >
   >
@@ -51,7 +52,7 @@ public:
     Dimensionality, TransformInternalComputationValueType
     >                                       Self;
   typedef SuperElastixComponent<
-    Accepting< itkImageDomainFixedInterface< Dimensionality >>,
+    Accepting< itkImageDomainFixedInterface< Dimensionality >, itkImagePyramidInterface< Dimensionality >>,
     Providing< itkTransformParametersAdaptorsContainerInterface< TransformInternalComputationValueType, Dimensionality >, UpdateInterface
     >
     >                                       Superclass;
@@ -83,6 +84,8 @@ public:
   //Accepting Interfaces:
   int Accept( typename itkImageDomainFixedInterface< Dimensionality >::Pointer ) override;
 
+  int Accept( typename itkImagePyramidInterface< Dimensionality >::Pointer ) override;
+
   //Providing Interfaces:
   TransformParametersAdaptorsContainerType GetItkTransformParametersAdaptorsContainer() override;
 
@@ -91,6 +94,9 @@ public:
   //BaseClass methods
   bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
+  // Either the fixed domain or a pyramid is required
+  bool ConnectionsSatisfied() override;
+
   static const char * GetDescription() { return "ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainer Component"; }
 
 private:
@@ -107,6 +113,9 @@ private:
 
   ItkImageDomainPointer m_FixedDomain;
 
+  // If connected, the levels and their geometry are those of the pyramid instead of the fixed domain shrunk by the settings
+  typename itkImagePyramidInterface< Dimensionality >::Pointer m_ImagePyramid;
+
 protected:
 
   static inline const std::map< std::string, std::string > TemplateProperties()
@@ -18,6 +18,7 @@
  *=========================================================================*/
 
 #include "selxItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent.h"
+#include "selxImagePyramid.h"
 
 namespace selx
 {
@@ -47,35 +48,56 @@ ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent
   return 0;
 }
 
+template< int Dimensionality, class TransformInternalComputationValueType >
+int
+ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent< Dimensionality, TransformInternalComputationValueType >
+::Accept( typename itkImagePyramidInterface< Dimensionality >::Pointer component )
+{
+  if( this->m_ShrinkFactorsPerLevel.Size() > 0 )
+  {
+    this->m_Logger.Log( LogLevel::WRN, "{0}: The ShrinkFactorsPerLevel setting is replaced by the {1} levels of the connected pyramid.",
+      this->m_Name, component->GetNumberOfLevels() );
+  }
+  this->m_ImagePyramid = component;
+
+  return 0;
+}
+
 template< int Dimensionality, class TransformInternalComputationValueType >
 void
 ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent< Dimensionality, TransformInternalComputationValueType >
 ::BeforeUpdate() {
-  this->m_FixedDomain->UpdateOutputInformation();
+  // The network may be executed again (batch mode), do not accumulate adaptors
+  this->m_Adaptors.clear();
 
-  for( unsigned int level = 0; level < m_ShrinkFactorsPerLevel.Size(); level++ )
+  if( !this->m_ImagePyramid )
   {
-    // We use the shrink image filter to calculate the fixed parameters of the virtual
-    // domain at each level.  To speed up calculation and avoid unnecessary memory
-    // usage, we could calculate these fixed parameters directly.
-
-    typedef itk::Image< TransformInternalComputationValueType, Dimensionality > FixedImageType;
-
-    typename FixedImageType::Pointer fixedImage = FixedImageType::New();
-    fixedImage->CopyInformation( this->m_FixedDomain );
-    //fixedImage->Allocate();
+    this->m_FixedDomain->UpdateOutputInformation();
+  }
+  const unsigned int numberOfLevels = this->m_ImagePyramid ? this->m_ImagePyramid->GetNumberOfLevels() : m_ShrinkFactorsPerLevel.Size();
 
-    typedef itk::ShrinkImageFilter< FixedImageType, FixedImageType > ShrinkFilterType;
-    typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
-    shrinkFilter->SetShrinkFactors( m_ShrinkFactorsPerLevel[ level ] );
-    shrinkFilter->SetInput( fixedImage );
-    shrinkFilter->UpdateOutputInformation();
+  for( unsigned int level = 0; level < numberOfLevels; level++ )
+  {
+    // The fixed parameters of the virtual domain at each level are those of the fixed domain shrunk by
+    // the shrink image filter of the registration method, derived without a (dummy) image and filter,
+    // either by the pyramid or from the ShrinkFactorsPerLevel setting.
+    ItkImageDomainPointer shrunkDomain;
+    if( this->m_ImagePyramid )
+    {
+      shrunkDomain = this->m_ImagePyramid->GetItkImageDomainAtLevel( level );
+    }
+    else
+    {
+      itk::FixedArray< unsigned int, Dimensionality > shrinkFactors;
+      shrinkFactors.Fill( m_ShrinkFactorsPerLevel[ level ] );
+      shrunkDomain = ShrinkImageDomain< Dimensionality >( this->m_FixedDomain.GetPointer(), shrinkFactors );
+    }
 
     typename TransformParametersAdaptorType::Pointer transformAdaptor = TransformParametersAdaptorType::New();
-    transformAdaptor->SetRequiredSpacing( shrinkFilter->GetOutput()->GetSpacing() );
-    transformAdaptor->SetRequiredSize( shrinkFilter->GetOutput()->GetLargestPossibleRegion().GetSize() );
-    transformAdaptor->SetRequiredDirection( shrinkFilter->GetOutput()->GetDirection() );
-    transformAdaptor->SetRequiredOrigin( shrinkFilter->GetOutput()->GetOrigin() );
+    transformAdaptor->SetRequiredSpacing( shrunkDomain->GetSpacing() );
+    transformAdaptor->SetRequiredSize( shrunkDomain->GetLargestPossibleRegion().GetSize() );
+    transformAdaptor->SetRequiredDirection( shrunkDomain->GetDirection() );
+    transformAdaptor->SetRequiredOrigin( shrunkDomain->GetOrigin() );
 
     this->m_Adaptors.push_back( transformAdaptor.GetPointer() ); // Implicit cast back to TransformParametersAdaptorBase<itk::Transform<...>>
   }
@@ -124,4 +146,14 @@ ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent
 
   return meetsCriteria;
 }
+
+
+template< int Dimensionality, class TransformInternalComputationValueType >
+bool
+ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent< Dimensionality, TransformInternalComputationValueType >
+::ConnectionsSatisfied()
+{
+  return this->InterfaceAcceptor< itkImageDomainFixedInterface< Dimensionality >>::GetAccepted()
+    || this->InterfaceAcceptor< itkImagePyramidInterface< Dimensionality >>::GetAccepted();
+}
 } //end namespace selx
@@ -25,14 +25,14 @@
 #include "selxItkRegistrationMethodv4Interfaces.h"
 #include "selxSinksAndSourcesInterfaces.h"
 #include "selxItkObjectInterfaces.h"
+#include "selxImagePyramidInterfaces.h"
 
 #include "itkImageRegistrationMethodv4.h"
 #include "itkGradientDescentOptimizerv4.h"
 #include "itkImageSource.h"
 #include "itkTransformToDisplacementFieldFilter.h"
 #include "itkComposeDisplacementFieldsImageFilter.h"
-#include "itkRescaleIntensityImageFilter.h"
-#include "itkInvertIntensityImageFilter.h"
+#include "selxIntensityPreprocessingImageFilter.h"
 
 namespace selx
 {
@@ -45,7 +45,8 @@ class ItkImageRegistrationMethodv4Component :
   itkTransformInterface< InternalComputationValueType, Dimensionality >,
   itkTransformParametersAdaptorsContainerInterface< InternalComputationValueType, Dimensionality >,
   itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >,
-  itkOptimizerv4Interface< InternalComputationValueType >
+  itkOptimizerv4Interface< InternalComputationValueType >,
+  itkImagePyramidInterface< Dimensionality >
   >,
   Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
   MultiStageTransformInterface< InternalComputationValueType, Dimensionality >,
@@ -66,7 +67,8 @@ public:
     itkTransformInterface< InternalComputationValueType, Dimensionality >,
     itkTransformParametersAdaptorsContainerInterface< InternalComputationValueType, Dimensionality >,
     itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >,
-    itkOptimizerv4Interface< InternalComputationValueType >
+    itkOptimizerv4Interface< InternalComputationValueType >,
+    itkImagePyramidInterface< Dimensionality >
     >,
     Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
     MultiStageTransformInterface< InternalComputationValueType, Dimensionality >,
@@ -98,18 +100,10 @@ public:
   using ImageRegistrationMethodv4Pointer = typename ImageRegistrationMethodv4Type::Pointer;
   using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift< ImageMetricType >;
 
-  using FixedRescaleImageFilterType = itk::RescaleIntensityImageFilter<FixedImageType, FixedImageType>;
-  using FixedRescaleImageFilterPointer = typename FixedRescaleImageFilterType::Pointer;
-  using MovingRescaleImageFilterType = itk::RescaleIntensityImageFilter<MovingImageType, MovingImageType>;
-  using MovingRescaleImageFilterPointer = typename MovingRescaleImageFilterType::Pointer;
-  using FixedInvertIntensityImageFilterType = itk::InvertIntensityImageFilter<FixedImageType, FixedImageType>;
-  using FixedInvertIntensityImageFilterPointer = typename FixedInvertIntensityImageFilterType::Pointer;
-  using MovingInvertIntensityImageFilterType = itk::InvertIntensityImageFilter<MovingImageType, MovingImageType>;
-  using MovingInvertIntensityImageFilterPointer = typename MovingInvertIntensityImageFilterType::Pointer;
-  using FixedImageCalculatorFilterType = itk::MinimumMaximumImageCalculator<FixedImageType>;
-  using FixedImageCalculatorFilterPointer = typename FixedImageCalculatorFilterType::Pointer;
-  using MovingImageCalculatorFilterType = itk::MinimumMaximumImageCalculator<MovingImageType>;
-  using MovingImageCalculatorFilterPointer = typename MovingImageCalculatorFilterType::Pointer;
+  using FixedIntensityPreprocessingFilterType = IntensityPreprocessingImageFilter< FixedImageType, FixedImageType >;
+  using FixedIntensityPreprocessingFilterPointer = typename FixedIntensityPreprocessingFilterType::Pointer;
+  using MovingIntensityPreprocessingFilterType = IntensityPreprocessingImageFilter< MovingImageType, MovingImageType >;
+  using MovingIntensityPreprocessingFilterPointer = typename MovingIntensityPreprocessingFilterType::Pointer;
 
   // Accepting Interfaces:
   int Accept( typename itkImageFixedInterface< Dimensionality, PixelType >::Pointer ) override;
@@ -119,10 +113,16 @@ public:
   int Accept( typename itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >::Pointer ) override;
   int Accept( typename itkOptimizerv4Interface< InternalComputationValueType >::Pointer ) override;
 
+  // Optional: the levels of the registration follow the pyramid of the fixed image
+  int Accept( typename itkImagePyramidInterface< Dimensionality >::Pointer ) override;
+
   // Providing Interfaces:
   TransformPointer GetItkTransform() override;
   void Update() override;
   void BeforeUpdate() override;
+  void ReleaseData() override;
+  bool WriteResults( const std::string & directory ) override;
+  bool ReadResults( const std::string & directory ) override;
   void SetFixedInitialTransform( typename CompositeTransformType::Pointer fixedInitialTransform ) override;
   void SetMovingInitialTransform( typename CompositeTransformType::Pointer movingInitialTransform ) override;
 
@@ -136,6 +136,9 @@ public:
 
 private:
 
+  // Rescales and inverts the intensities as configured and sets the results as inputs of the registration
+  void SetIntensityAdjustedImages();
+
   FixedImagePointer m_FixedImage;
   MovingImagePointer m_MovingImage;
   ImageRegistrationMethodv4Pointer m_ImageRegistrationMethodv4Filter;
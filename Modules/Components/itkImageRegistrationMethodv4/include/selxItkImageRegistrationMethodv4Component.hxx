@@ -24,9 +24,14 @@
 #include "itkANTSNeighborhoodCorrelationImageToImageMetricv4.h"
 #include "itkGradientDescentOptimizerv4.h"
 #include "itkImageFileWriter.h"
+#include "itkTransformFileReader.h"
+#include "itkTransformFileWriter.h"
 #include "selxCheckTemplateProperties.h"
 #include "selxStringConverter.h"
 
+#include <iomanip>
+#include <sstream>
+
 namespace selx
 {
 template< typename TFilter >
@@ -42,9 +47,12 @@ public:
   typedef itk::GradientDescentOptimizerv4 OptimizerType;
   typedef   const OptimizerType *         OptimizerPointer;
 
+  /** The component that owns the observed filter, its logger receives the progress */
+  void SetComponent( ComponentBase * component ) { this->m_Component = component; }
+
 protected:
 
-  CommandIterationUpdate() {}
+  CommandIterationUpdate() : m_Component( nullptr ) {}
 
 public:
 
@@ -56,6 +64,11 @@ public:
 
   virtual void Execute( const itk::Object * object, const itk::EventObject & event ) ITK_OVERRIDE
   {
+    if( this->m_Component == nullptr || !this->m_Component->m_Logger.ShouldLog( LogLevel::DBG ) )
+    {
+      return;
+    }
+
     const TFilter * filter = static_cast< const TFilter * >( object );
     if( typeid( event ) == typeid( itk::MultiResolutionIterationEvent ) )
     {
@@ -75,27 +88,27 @@ public:
       }
       typename GradientDescentOptimizerv4Type::DerivativeType gradient = optimizer->GetGradient();
 
-      //debug:
-      std::cout << "  CL Current level:           " << currentLevel << std::endl;
-      std::cout << "   SF Shrink factor:          " << shrinkFactors << std::endl;
-      std::cout << "   SS Smoothing sigma:        " << smoothingSigmas[ currentLevel ] << std::endl;
-      //std::cout << "   RFP Required fixed params: " << adaptors[ currentLevel ]->GetRequiredFixedParameters() << std::endl;
-      std::cout << "   LR Final learning rate:    " << optimizer->GetLearningRate() << std::endl;
-      std::cout << "   FM Final metric value:     " << optimizer->GetCurrentMetricValue() << std::endl;
-      std::cout << "   SC Optimizer scales:       " << optimizer->GetScales() << std::endl;
-      std::cout << "   FG Final metric gradient (sample of values): ";
+      std::ostringstream message;
+      message << "Current level: " << currentLevel
+              << ", shrink factor: " << shrinkFactors
+              << ", smoothing sigma: " << smoothingSigmas[ currentLevel ]
+              //<< ", required fixed params: " << adaptors[ currentLevel ]->GetRequiredFixedParameters()
+              << ", final learning rate: " << optimizer->GetLearningRate()
+              << ", final metric value: " << optimizer->GetCurrentMetricValue()
+              << ", optimizer scales: " << optimizer->GetScales()
+              << ", final metric gradient (sample of values): ";
       if( gradient.GetSize() < 16 )
       {
-        std::cout << std::setprecision(6) << gradient;
+        message << std::setprecision(6) << gradient;
       }
       else
       {
         for( itk::SizeValueType i = 0; i < gradient.GetSize(); i += ( gradient.GetSize() / 16 ) )
         {
-          std::cout << std::setprecision(6) << gradient[ i ] << " ";
+          message << std::setprecision(6) << gradient[ i ] << " ";
         }
       }
-      std::cout << std::endl;
+      this->m_Component->Debug( "{0}: {1}", this->m_Component->m_Name, message.str() );
     }
     else if( typeid( event ) == typeid( itk::IterationEvent ) )
     {
@@ -106,15 +119,73 @@ public:
       {
         itkGenericExceptionMacro( "Error dynamic_cast failed" );
       }
-      std::cout << "   Iteration #:    " << optimizer->GetCurrentIteration() << std::endl;
-      std::cout << "   LR Final learning rate:    " << optimizer->GetLearningRate() << std::endl;
-      std::cout << "   FM Final metric value:     " << optimizer->GetCurrentMetricValue() << std::endl;
+      this->m_Component->Debug( "{0}: iteration {1}, learning rate {2}, metric value {3}", this->m_Component->m_Name,
+        optimizer->GetCurrentIteration(), optimizer->GetLearningRate(), optimizer->GetCurrentMetricValue() );
     }
-    else if( !( itk::IterationEvent().CheckEvent( &event ) ) )
+  }
+
+private:
+
+  ComponentBase * m_Component;
+};
+
+/** Records the metric value (and learning rate, if applicable) of each optimizer iteration in the profiler of a component */
+template< typename TFilter >
+class OptimizerIterationUpdate : public itk::Command
+{
+public:
+
+  typedef OptimizerIterationUpdate  Self;
+  typedef itk::Command              Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+  itkNewMacro( Self );
+
+  typedef typename TFilter::OptimizerType                             OptimizerType;
+  typedef typename OptimizerType::ParametersValueType                 ValueType;
+  typedef itk::GradientDescentOptimizerv4Template< ValueType >        GradientDescentOptimizerType;
+
+  void SetComponent( const ComponentBase * component ) { this->m_Component = component; }
+
+  void SetFilter( const TFilter * filter ) { this->m_Filter = filter; }
+
+protected:
+
+  OptimizerIterationUpdate() : m_Component( nullptr ), m_Filter( nullptr ) {}
+
+public:
+
+  virtual void Execute( itk::Object * caller, const itk::EventObject & event ) ITK_OVERRIDE
+  {
+    Execute( (const itk::Object *)caller, event );
+  }
+
+
+  virtual void Execute( const itk::Object * object, const itk::EventObject & event ) ITK_OVERRIDE
+  {
+    const OptimizerType * optimizer = dynamic_cast< const OptimizerType * >( object );
+    if( optimizer == nullptr || this->m_Component == nullptr || !this->m_Component->m_Profiler
+      || !itk::IterationEvent().CheckEvent( &event ) )
     {
       return;
     }
+
+    Profiler::Iteration iteration;
+    iteration.componentName             = this->m_Component->m_Name;
+    iteration.level                     = this->m_Filter ? this->m_Filter->GetCurrentLevel() : 0;
+    iteration.iteration                 = static_cast< unsigned int >( optimizer->GetCurrentIteration() );
+    iteration.values[ "MetricValue" ]   = static_cast< double >( optimizer->GetCurrentMetricValue() );
+    const GradientDescentOptimizerType * gradientDescentOptimizer = dynamic_cast< const GradientDescentOptimizerType * >( optimizer );
+    if( gradientDescentOptimizer != nullptr )
+    {
+      iteration.values[ "LearningRate" ] = static_cast< double >( gradientDescentOptimizer->GetLearningRate() );
+    }
+    this->m_Component->m_Profiler->AddIteration( iteration );
   }
+
+private:
+
+  const ComponentBase * m_Component;
+  const TFilter *       m_Filter;
 };
 
 template< int Dimensionality, class TPixel, class InternalComputationValueType >
@@ -199,73 +270,114 @@ ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputati
   return 0;
 }
 
+
 template< int Dimensionality, class TPixel, class InternalComputationValueType >
-void
-ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::BeforeUpdate( void ) {
-  FixedImagePointer fixedImage = this->m_FixedImage;
-  MovingImagePointer movingImage = this->m_MovingImage;
+int
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::Accept( typename
+  itkImagePyramidInterface< Dimensionality >::Pointer component )
+{
+  // ImageRegistrationMethodv4 smooths and shrinks internally by the schedule of the pyramid. Its levels then match
+  // the level geometry that a transform parameters adaptors container connected to the same pyramid takes from it.
+  const unsigned int numberOfLevels = component->GetNumberOfLevels();
+  if( this->m_NumberOfLevelsLastSetBy != "" )
+  {
+    this->m_Logger.Log( LogLevel::WRN, "{0}: The levels set by {1} are replaced by the {2} levels of the connected pyramid.",
+      this->m_Name, this->m_NumberOfLevelsLastSetBy, numberOfLevels );
+  }
 
-  fixedImage->Update();
-  movingImage->Update();
+  itk::Array< itk::SizeValueType >            shrinkFactorsPerLevel( numberOfLevels );
+  itk::Array< InternalComputationValueType > smoothingSigmasPerLevel( numberOfLevels );
+  for( unsigned int level = 0; level < numberOfLevels; ++level )
+  {
+    shrinkFactorsPerLevel[ level ]   = component->GetShrinkFactorAtLevel( level );
+    smoothingSigmasPerLevel[ level ] = component->GetSmoothingSigmaAtLevel( level );
+  }
+  this->m_ImageRegistrationMethodv4Filter->SetNumberOfLevels( numberOfLevels );
+  this->m_ImageRegistrationMethodv4Filter->SetShrinkFactorsPerLevel( shrinkFactorsPerLevel );
+  this->m_ImageRegistrationMethodv4Filter->SetSmoothingSigmasPerLevel( smoothingSigmasPerLevel );
+  // The pyramid specifies its standard deviations in physical units
+  this->m_ImageRegistrationMethodv4Filter->SmoothingSigmasAreSpecifiedInPhysicalUnitsOn();
+  this->m_NumberOfLevelsLastSetBy = "ImagePyramid";
+  return 0;
+}
 
-  if (this->m_RescaleIntensity.size() == 2) {
-    this->m_Logger.Log(LogLevel::INF, "{0}: Rescaling images to [{1}, {2}]", this->m_Name, this->m_RescaleIntensity[0], this->m_RescaleIntensity[1]);
 
-    FixedRescaleImageFilterPointer fixedIntensityRescaler = FixedRescaleImageFilterType::New();
-    fixedIntensityRescaler->SetInput(fixedImage);
-    fixedIntensityRescaler->SetOutputMinimum(std::stof(this->m_RescaleIntensity[0]));
-    fixedIntensityRescaler->SetOutputMaximum(std::stof(this->m_RescaleIntensity[1]));
-    fixedIntensityRescaler->UpdateOutputInformation();
-    fixedImage = fixedIntensityRescaler->GetOutput();
-    fixedImage->Update();
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::BeforeUpdate( void ) {
+  // The intensity adjusted copies of the images are only alive during Update, see ReleaseData
+  this->m_ImageRegistrationMethodv4Filter->SetFixedImage(this->m_FixedImage);
+  this->m_ImageRegistrationMethodv4Filter->SetMovingImage(this->m_MovingImage);
 
-    MovingRescaleImageFilterPointer movingIntensityRescaler = MovingRescaleImageFilterType::New();
-    movingIntensityRescaler->SetInput(movingImage);
-    movingIntensityRescaler->SetOutputMinimum(std::stof(this->m_RescaleIntensity[0]));
-    movingIntensityRescaler->SetOutputMaximum(std::stof(this->m_RescaleIntensity[1]));
-    movingIntensityRescaler->UpdateOutputInformation();
-    movingImage = movingIntensityRescaler->GetOutput();
-    movingImage->Update();
+  if(this->m_MetricSamplingPercentage < 1.0) {
+    this->m_ImageRegistrationMethodv4Filter->SetMetricSamplingPercentage(this->m_MetricSamplingPercentage);
   }
+}
 
-  if (this->m_InvertIntensity) {
-    this->m_Logger.Log(LogLevel::INF, "{0}, Inverting image scales", this->m_Name);
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::SetIntensityAdjustedImages( void )
+{
+  FixedImagePointer fixedImage = this->m_FixedImage;
+  MovingImagePointer movingImage = this->m_MovingImage;
 
-    FixedImageCalculatorFilterPointer fixedIntensityMaximumCalculator = FixedImageCalculatorFilterType::New();
-    fixedIntensityMaximumCalculator->SetImage(fixedImage);
-    fixedIntensityMaximumCalculator->ComputeMaximum();
+  if (this->m_RescaleIntensity.size() == 2 || this->m_InvertIntensity) {
+    // Rescaling and inverting are done in one pass that allocates a single copy of each image
+    FixedIntensityPreprocessingFilterPointer fixedIntensityAdjuster = FixedIntensityPreprocessingFilterType::New();
+    fixedIntensityAdjuster->SetInput(fixedImage);
+    MovingIntensityPreprocessingFilterPointer movingIntensityAdjuster = MovingIntensityPreprocessingFilterType::New();
+    movingIntensityAdjuster->SetInput(movingImage);
+    if (this->GetNumberOfThreads() > 0) {
+      fixedIntensityAdjuster->SetNumberOfThreads(this->GetNumberOfThreads());
+      movingIntensityAdjuster->SetNumberOfThreads(this->GetNumberOfThreads());
+    }
 
-    FixedInvertIntensityImageFilterPointer fixedIntensityInverter = FixedInvertIntensityImageFilterType::New();
-    fixedIntensityInverter->SetInput(fixedImage);
-    fixedIntensityInverter->SetMaximum(fixedIntensityMaximumCalculator->GetMaximum());
-    fixedIntensityInverter->UpdateOutputInformation();
-    fixedImage = fixedIntensityInverter->GetOutput();
-    fixedImage->Update();
+    if (this->m_RescaleIntensity.size() == 2) {
+      this->m_Logger.Log(LogLevel::INF, "{0}: Rescaling images to [{1}, {2}]", this->m_Name, this->m_RescaleIntensity[0], this->m_RescaleIntensity[1]);
+      fixedIntensityAdjuster->RescaleOn();
+      fixedIntensityAdjuster->SetOutputMinimum(std::stof(this->m_RescaleIntensity[0]));
+      fixedIntensityAdjuster->SetOutputMaximum(std::stof(this->m_RescaleIntensity[1]));
+      movingIntensityAdjuster->RescaleOn();
+      movingIntensityAdjuster->SetOutputMinimum(std::stof(this->m_RescaleIntensity[0]));
+      movingIntensityAdjuster->SetOutputMaximum(std::stof(this->m_RescaleIntensity[1]));
+    }
 
-    MovingImageCalculatorFilterPointer movingIntensityMaximumCalculator = MovingImageCalculatorFilterType::New();
-    movingIntensityMaximumCalculator->SetImage(movingImage);
-    movingIntensityMaximumCalculator->ComputeMaximum();
+    if (this->m_InvertIntensity) {
+      this->m_Logger.Log(LogLevel::INF, "{0}, Inverting image scales", this->m_Name);
+      fixedIntensityAdjuster->InvertOn();
+      movingIntensityAdjuster->InvertOn();
+    }
 
-    MovingInvertIntensityImageFilterPointer movingIntensityInverter = MovingInvertIntensityImageFilterType::New();
-    movingIntensityInverter->SetInput(movingImage);
-    movingIntensityInverter->SetMaximum(movingIntensityMaximumCalculator->GetMaximum());
-    movingIntensityInverter->UpdateOutputInformation();
-    movingImage = movingIntensityInverter->GetOutput();
+    fixedIntensityAdjuster->UpdateOutputInformation();
+    fixedImage = fixedIntensityAdjuster->GetOutput();
+    fixedImage->Update();
+    movingIntensityAdjuster->UpdateOutputInformation();
+    movingImage = movingIntensityAdjuster->GetOutput();
     movingImage->Update();
   }
 
   this->m_ImageRegistrationMethodv4Filter->SetFixedImage(fixedImage);
   this->m_ImageRegistrationMethodv4Filter->SetMovingImage(movingImage);
+}
 
-  if(this->m_MetricSamplingPercentage < 1.0) {
-    this->m_ImageRegistrationMethodv4Filter->SetMetricSamplingPercentage(this->m_MetricSamplingPercentage);
-  }
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::ReleaseData( void )
+{
+  // Drop the intensity adjusted copies of the images. The resulting transform is kept.
+  this->m_ImageRegistrationMethodv4Filter->SetFixedImage( this->m_FixedImage );
+  this->m_ImageRegistrationMethodv4Filter->SetMovingImage( this->m_MovingImage );
 }
 
 template< int Dimensionality, class TPixel, class InternalComputationValueType >
 void
 ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::Update( void )
 {
+  // The pixel data is read when the network is executed, not when it is configured
+  this->m_FixedImage->Update();
+  this->m_MovingImage->Update();
+  this->SetIntensityAdjustedImages();
+
   // Set transform
   typedef itk::CompositeTransform<InternalComputationValueType, Dimensionality >  MovingCompositeTransformType;
 
@@ -289,6 +401,14 @@ ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputati
   auto optimizer = this->m_ImageRegistrationMethodv4Filter->GetModifiableOptimizer();
   optimizer->SetScalesEstimator(scalesEstimator);
 
+  // The share of the ThreadBudget of this component. Metric and optimizer do not inherit the threads of the filter.
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    this->m_ImageRegistrationMethodv4Filter->SetNumberOfThreads( this->GetNumberOfThreads() );
+    metric->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+    optimizer->SetNumberOfThreads( this->GetNumberOfThreads() );
+  }
+
   // Multi-resolution setup
   if( this->m_TransformAdaptorsContainerInterface != nullptr )
   {
@@ -298,10 +418,58 @@ ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputati
 
   typedef CommandIterationUpdate< ImageRegistrationMethodv4Type > RegistrationCommandType;
   typename RegistrationCommandType::Pointer registrationObserver = RegistrationCommandType::New();
-  this->m_ImageRegistrationMethodv4Filter->AddObserver( itk::IterationEvent(), registrationObserver );
+  registrationObserver->SetComponent( this );
+  const unsigned long registrationObserverTag = this->m_ImageRegistrationMethodv4Filter->AddObserver( itk::IterationEvent(), registrationObserver );
+
+  typedef OptimizerIterationUpdate< ImageRegistrationMethodv4Type > OptimizerCommandType;
+  typename OptimizerCommandType::Pointer optimizerObserver = OptimizerCommandType::New();
+  optimizerObserver->SetComponent( this );
+  optimizerObserver->SetFilter( this->m_ImageRegistrationMethodv4Filter );
+  const unsigned long optimizerObserverTag = optimizer->AddObserver( itk::IterationEvent(), optimizerObserver );
 
   // Perform the actual registration
   this->m_ImageRegistrationMethodv4Filter->Update();
+
+  // The network may be executed again (batch mode), do not accumulate observers
+  this->m_ImageRegistrationMethodv4Filter->RemoveObserver( registrationObserverTag );
+  optimizer->RemoveObserver( optimizerObserverTag );
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+bool
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::WriteResults( const std::string & directory )
+{
+  // The registration optimizes m_Transform in place
+  typedef itk::TransformFileWriterTemplate< InternalComputationValueType > TransformWriterType;
+  typename TransformWriterType::Pointer writer = TransformWriterType::New();
+  writer->SetInput( this->m_Transform );
+  writer->SetFileName( directory + "/Transform.h5" );
+  writer->Update();
+  return true;
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+bool
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >::ReadResults( const std::string & directory )
+{
+  typedef itk::TransformFileReaderTemplate< InternalComputationValueType > TransformReaderType;
+  typename TransformReaderType::Pointer reader = TransformReaderType::New();
+  reader->SetFileName( directory + "/Transform.h5" );
+  reader->Update();
+
+  const auto transformList = reader->GetTransformList();
+  if( transformList->size() != 1 || std::string( transformList->front()->GetNameOfClass() ) != this->m_Transform->GetNameOfClass() )
+  {
+    this->m_Logger.Log( LogLevel::WRN, "{0}: stored results do not match the transform, registration is executed.", this->m_Name );
+    return false;
+  }
+
+  // Restore the transform object that was passed to the downstream components
+  this->m_Transform->SetFixedParameters( transformList->front()->GetFixedParameters() );
+  this->m_Transform->SetParameters( transformList->front()->GetParameters() );
+  return true;
 }
 
 
@@ -516,6 +684,8 @@ ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputati
   }
   // Allow unconnected itkTransformParametersAdaptorsContainerInterface (not needed for affine transform)
   // itkTransformParametersAdaptorsContainerInterface< InternalComputationValueType, Dimensionality >
+  // Allow unconnected itkImagePyramidInterface (the levels are set by the settings instead)
+  // itkImagePyramidInterface< Dimensionality >
   if( !this->InterfaceAcceptor< itkMetricv4Interface< Dimensionality, TPixel, InternalComputationValueType >>::GetAccepted() )
   {
     return false;
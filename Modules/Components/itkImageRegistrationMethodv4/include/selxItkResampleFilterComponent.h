@@ -24,6 +24,7 @@
 
 #include "selxItkRegistrationMethodv4Interfaces.h"
 #include "selxSinksAndSourcesInterfaces.h"
+#include "selxAffineResampleImageFilter.h"
 
 #include "itkImageRegistrationMethodv4.h"
 #include "itkGradientDescentOptimizerv4.h"
@@ -75,7 +76,8 @@ public:
   typedef typename itkImageMovingInterface< Dimensionality, TPixel >::ItkImageType    MovingImageType;
   typedef typename itkImageInterface< Dimensionality, TPixel >::ItkImageType          ResultImageType;
 
-  typedef itk::ResampleImageFilter< MovingImageType, ResultImageType > ResampleFilterType;
+  // Takes a fast path for linear transforms and falls back to itk::ResampleImageFilter otherwise
+  typedef AffineResampleImageFilter< MovingImageType, ResultImageType > ResampleFilterType;
 
   //Accepting Interfaces:
   virtual int Accept( typename itkImageDomainFixedInterface< Dimensionality >::Pointer ) override;
@@ -44,6 +44,8 @@ ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
 ::Accept( typename itkImageDomainFixedInterface< Dimensionality >::Pointer component )
 {
   auto fixedImageDomain = component->GetItkImageDomainFixed();
+  // Only the geometry of the fixed image is needed, not its pixel data
+  fixedImageDomain->UpdateOutputInformation();
   // connect the itk pipeline
 
   //this->m_ResampleFilter->SetSize(fixedImage->GetBufferedRegion().GetSize());  //should be virtual image...
@@ -77,8 +79,11 @@ ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
   this->m_TransformComponent = component;
 
   auto transform = component->GetItkTransform();
-  // connect the itk pipeline
-  this->m_ResampleFilter->SetTransform( transform );
+  // connect the itk pipeline. A transform that is not available yet is connected in Update
+  if( transform )
+  {
+    this->m_ResampleFilter->SetTransform( transform );
+  }
 
   return 0;
 }
@@ -101,6 +106,10 @@ ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
   auto transform = this->m_TransformComponent->GetItkTransform();
   // reconnect the tranform, since it does not comply with the itk pipeline
   this->m_ResampleFilter->SetTransform( transform );
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    this->m_ResampleFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+  }
 }
 
 
@@ -58,11 +58,15 @@ public:
 
   virtual void SetFileName( const std::string ) ITK_OVERRIDE;
 
+  virtual std::string GetFileName( void ) const ITK_OVERRIDE;
+
   /** The AnyFileReader has a non type-specific, but derived from OutputDataType, GetOutput */
   virtual OutputDataType * GetOutput() ITK_OVERRIDE;
 
   virtual void Update( void ) ITK_OVERRIDE;
 
+  virtual void UpdateOutputInformation( void ) ITK_OVERRIDE;
+
   ItkTransformDataObjectFileReader();
   ~ItkTransformDataObjectFileReader();
 
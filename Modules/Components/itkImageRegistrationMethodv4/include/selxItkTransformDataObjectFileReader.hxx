@@ -57,6 +57,15 @@ ItkTransformDataObjectFileReader< TParametersValueType, NInputDimensions, NOutpu
 }
 
 
+template< typename TParametersValueType, int NInputDimensions, int NOutputDimensions >
+std::string
+ItkTransformDataObjectFileReader< TParametersValueType, NInputDimensions, NOutputDimensions >
+::GetFileName() const
+{
+  return m_Reader->GetFileName();
+}
+
+
 template< typename TParametersValueType, int NInputDimensions, int NOutputDimensions >
 typename ItkTransformDataObjectFileReader< TParametersValueType, NInputDimensions, NOutputDimensions >::OutputDataType
 * ItkTransformDataObjectFileReader< TParametersValueType, NInputDimensions, NOutputDimensions >
@@ -86,6 +95,16 @@ ItkTransformDataObjectFileReader< TParametersValueType, NInputDimensions, NOutpu
 {
   return m_Reader->Update();
 }
+
+
+template< typename TParametersValueType, int NInputDimensions, int NOutputDimensions >
+void
+ItkTransformDataObjectFileReader< TParametersValueType, NInputDimensions, NOutputDimensions >
+::UpdateOutputInformation()
+{
+  // A transform file has no header that can be read separately, but it is small
+  return m_Reader->Update();
+}
 } // namespace elx
 
 #endif // selxProcessObject_hxx
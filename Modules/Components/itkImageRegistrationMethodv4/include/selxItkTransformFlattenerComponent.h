@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#ifndef selxItkTransformFlattenerComponent_h
+#define selxItkTransformFlattenerComponent_h
+
+#include "selxSuperElastixComponent.h"
+
+#include "selxItkRegistrationMethodv4Interfaces.h"
+#include "selxSinksAndSourcesInterfaces.h"
+
+#include "selxFlattenTransform.h"
+
+namespace selx
+{
+/** Collapses the transform chain of a multi-stage registration into a single transform before it is
+ * used for resampling. Linear stages are merged into one affine transform; a chain with non-linear
+ * stages is sampled into one displacement field on the grid of the fixed image domain. See FlattenTransform.
+ * Connect this component between e.g. an ItkCompositeTransformComponent and the ItkResampleFilterComponents
+ * that warp an image, its labels and its masks with the same chain. */
+template< class InternalComputationValueType, int Dimensionality >
+class ItkTransformFlattenerComponent :
+  public SuperElastixComponent<
+  Accepting< itkTransformInterface< InternalComputationValueType, Dimensionality >,
+  itkImageDomainFixedInterface< Dimensionality >
+  >,
+  Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
+  UpdateInterface
+  >
+  >
+{
+public:
+
+  /** Standard ITK typedefs. */
+  typedef ItkTransformFlattenerComponent<
+    InternalComputationValueType, Dimensionality
+    >                                     Self;
+  typedef SuperElastixComponent<
+    Accepting< itkTransformInterface< InternalComputationValueType, Dimensionality >,
+    itkImageDomainFixedInterface< Dimensionality >
+    >,
+    Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
+    UpdateInterface
+    >
+    >                                     Superclass;
+  typedef std::shared_ptr< Self >       Pointer;
+  typedef std::shared_ptr< const Self > ConstPointer;
+
+  ItkTransformFlattenerComponent( const std::string & name, LoggerImpl & logger );
+  virtual ~ItkTransformFlattenerComponent();
+
+  using TransformType = typename itkTransformInterface< InternalComputationValueType, Dimensionality >::TransformType;
+
+  //Accepting Interfaces:
+  int Accept( typename itkImageDomainFixedInterface< Dimensionality >::Pointer ) override;
+
+  int Accept( typename itkTransformInterface< InternalComputationValueType, Dimensionality >::Pointer ) override;
+
+  //Providing Interfaces:
+  /** Before Update this is the unflattened transform */
+  typename TransformType::Pointer GetItkTransform() override;
+
+  void Update() override;
+
+  //BaseClass methods
+  bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
+
+  static const char * GetDescription() { return "ItkTransformFlattener Component"; }
+
+private:
+
+  typename itk::ImageBase< Dimensionality >::Pointer m_ImageDomainFixed;
+  typename itkTransformInterface< InternalComputationValueType, Dimensionality >::Pointer m_TransformComponent;
+  typename TransformType::Pointer m_FlattenedTransform;
+
+protected:
+
+  // return the class name and the template arguments to uniquely identify this component.
+  static inline const std::map< std::string, std::string > TemplateProperties()
+  {
+    return { { keys::NameOfClass, "ItkTransformFlattenerComponent" }, { keys::InternalComputationValueType, PodString< InternalComputationValueType >::Get() }, { keys::Dimensionality, std::to_string( Dimensionality ) } };
+  }
+};
+} //end namespace selx
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxItkTransformFlattenerComponent.hxx"
+#endif
+#endif // #define selxItkTransformFlattenerComponent_h
@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxItkTransformFlattenerComponent.h"
+#include "selxCheckTemplateProperties.h"
+
+namespace selx
+{
+template< class InternalComputationValueType, int Dimensionality >
+ItkTransformFlattenerComponent< InternalComputationValueType,
+Dimensionality >::ItkTransformFlattenerComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger )
+{
+}
+
+
+template< class InternalComputationValueType, int Dimensionality >
+ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >::~ItkTransformFlattenerComponent()
+{
+}
+
+
+template< class InternalComputationValueType, int Dimensionality >
+int
+ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >
+::Accept( typename itkImageDomainFixedInterface< Dimensionality >::Pointer component )
+{
+  this->m_ImageDomainFixed = component->GetItkImageDomainFixed();
+  // Only the geometry of the fixed image is needed, not its pixel data
+  this->m_ImageDomainFixed->UpdateOutputInformation();
+  return 0;
+}
+
+
+template< class InternalComputationValueType, int Dimensionality >
+int
+ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >
+::Accept( typename itkTransformInterface< InternalComputationValueType, Dimensionality >::Pointer component )
+{
+  // The transform is only complete after the upstream components have been updated
+  this->m_TransformComponent = component;
+  return 0;
+}
+
+
+template< class InternalComputationValueType, int Dimensionality >
+typename ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >::TransformType::Pointer
+ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >
+::GetItkTransform()
+{
+  if( this->m_FlattenedTransform )
+  {
+    return this->m_FlattenedTransform;
+  }
+  if( !this->m_TransformComponent )
+  {
+    // A downstream component may connect before the transform is connected to this component. It fetches the
+    // transform again in its Update.
+    return nullptr;
+  }
+  return this->m_TransformComponent->GetItkTransform();
+}
+
+
+template< class InternalComputationValueType, int Dimensionality >
+void
+ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >
+::Update()
+{
+  this->m_FlattenedTransform = FlattenTransform< InternalComputationValueType, Dimensionality >(
+    this->m_TransformComponent->GetItkTransform(), this->m_ImageDomainFixed, this->GetNumberOfThreads() );
+}
+
+
+template< class InternalComputationValueType, int Dimensionality >
+bool
+ItkTransformFlattenerComponent< InternalComputationValueType, Dimensionality >
+::MeetsCriterion( const ComponentBase::CriterionType & criterion )
+{
+  auto status = CheckTemplateProperties( this->TemplateProperties(), criterion );
+  if( status == CriterionStatus::Satisfied )
+  {
+    return true;
+  }
+  else if( status == CriterionStatus::Failed )
+  {
+    return false;
+  } // else: CriterionStatus::Unknown
+  return false;
+}
+} //end namespace selx
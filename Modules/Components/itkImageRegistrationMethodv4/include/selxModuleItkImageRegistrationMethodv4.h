@@ -29,6 +29,7 @@
 #include "selxItkAffineTransformComponent.h"
 #include "selxItkTransformDisplacementFilterComponent.h"
 #include "selxItkResampleFilterComponent.h"
+#include "selxItkTransformFlattenerComponent.h"
 #include "selxItkTransformSourceComponent.h"
 #include "selxItkTransformSinkComponent.h"
 
@@ -57,6 +58,8 @@ using ModuleItkImageRegistrationMethodv4Components = selx::TypeList<
   ItkTransformDisplacementFilterComponent< 3, float, double >,
   ItkResampleFilterComponent< 2, float, double >,
   ItkResampleFilterComponent< 3, float, double >,
+  ItkTransformFlattenerComponent< double, 2 >,
+  ItkTransformFlattenerComponent< double, 3 >,
   ItkTransformSourceComponent< 2, double >,
   ItkTransformSourceComponent< 3, double >,
   ItkTransformSinkComponent< 2, double >,
@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "selxAffineResampleImageFilter.h"
+#include "selxTestUtilities.h"
+
+#include "itkAffineTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTranslationTransform.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+namespace selx
+{
+class AffineResampleImageFilterTest : public ::testing::Test
+{
+public:
+
+  typedef itk::Image< float, 3 >                            ImageType;
+  typedef itk::AffineTransform< double, 3 >                 AffineTransformType;
+  typedef itk::ResampleImageFilter< ImageType, ImageType >  GenericResampleFilterType;
+  typedef AffineResampleImageFilter< ImageType, ImageType > ResampleFilterType;
+
+  static ImageType::Pointer MakeImage( unsigned int size )
+  {
+    ImageType::SpacingType spacing;
+    spacing[ 0 ] = 1.0;
+    spacing[ 1 ] = 1.5;
+    spacing[ 2 ] = 2.0;
+    ImageType::PointType origin;
+    origin[ 0 ] = -10.0;
+    origin[ 1 ] = 5.0;
+    origin[ 2 ] = 0.0;
+    return TestUtilities::MakeSinCosImage< ImageType >( size, spacing, origin );
+  }
+
+
+  static AffineTransformType::Pointer MakeAffineTransform()
+  {
+    auto transform = AffineTransformType::New();
+    AffineTransformType::OutputVectorType axis;
+    axis[ 0 ] = 0.2;
+    axis[ 1 ] = 1.0;
+    axis[ 2 ] = 0.3;
+    transform->Rotate3D( axis, 0.2 );
+    transform->Scale( 1.05 );
+    AffineTransformType::OutputVectorType translation;
+    translation[ 0 ] = 3.2;
+    translation[ 1 ] = -1.7;
+    translation[ 2 ] = 0.4;
+    transform->Translate( translation );
+    return transform;
+  }
+
+
+  template< class TFilter >
+  static typename TFilter::Pointer MakeFilter( const ImageType * image, const itk::Transform< double, 3, 3 > * transform, bool nearestNeighbor )
+  {
+    return TestUtilities::MakeResampleFilter< TFilter >( image, transform, image, nearestNeighbor );
+  }
+
+
+  static void ExpectNear( const ImageType * expected, const ImageType * actual, double tolerance )
+  {
+    // Voxels that map within rounding errors of the border of the input may flip between inside and outside
+    TestUtilities::ExpectImagesNear( expected, actual, tolerance, 1e-4 );
+  }
+
+
+  void Benchmark( unsigned int size )
+  {
+    auto image     = MakeImage( size );
+    auto transform = MakeAffineTransform();
+
+    std::cout << "Affine resampling of " << size << "^3 voxels (float):" << std::endl;
+    for( bool nearestNeighbor : { false, true } )
+    {
+      auto         genericFilter = MakeFilter< GenericResampleFilterType >( image, transform, nearestNeighbor );
+      auto         fastFilter    = MakeFilter< ResampleFilterType >( image, transform, nearestNeighbor );
+      const double generic       = TestUtilities::MeasureMilliseconds( [ & ]() { genericFilter->Update(); } );
+      const double fast          = TestUtilities::MeasureMilliseconds( [ & ]() { fastFilter->Update(); } );
+      // The timings are only meaningful if the fast path was taken
+      EXPECT_TRUE( fastFilter->GetFastPath() );
+      std::cout << ( nearestNeighbor ? "  nearest neighbour" : "  linear           " )
+                << ": itk::ResampleImageFilter " << generic << " ms, fast path " << fast << " ms" << std::endl;
+    }
+  }
+};
+
+TEST_F( AffineResampleImageFilterTest, AffineTransform )
+{
+  auto image     = MakeImage( 40 );
+  auto transform = MakeAffineTransform();
+
+  for( bool nearestNeighbor : { false, true } )
+  {
+    auto expected = MakeFilter< GenericResampleFilterType >( image, transform, nearestNeighbor );
+    auto actual   = MakeFilter< ResampleFilterType >( image, transform, nearestNeighbor );
+    expected->Update();
+    actual->Update();
+    EXPECT_TRUE( actual->GetFastPath() );
+    ExpectNear( expected->GetOutput(), actual->GetOutput(), 1e-3 );
+  }
+}
+
+TEST_F( AffineResampleImageFilterTest, TranslationTransformAndStreaming )
+{
+  auto image     = MakeImage( 40 );
+  auto transform = itk::TranslationTransform< double, 3 >::New();
+  itk::TranslationTransform< double, 3 >::OutputVectorType translation;
+  translation[ 0 ] = 4.3;
+  translation[ 1 ] = -2.1;
+  translation[ 2 ] = 1.3;
+  transform->Translate( translation );
+
+  auto expected = MakeFilter< GenericResampleFilterType >( image, transform, false );
+  expected->Update();
+
+  // Resample the lower half of the output, as a streaming writer would request it
+  auto actual = MakeFilter< ResampleFilterType >( image, transform, false );
+  auto region = image->GetLargestPossibleRegion();
+  region.SetSize( 2, region.GetSize( 2 ) / 2 );
+  actual->GetOutput()->SetRequestedRegion( region );
+  actual->Update();
+  EXPECT_TRUE( actual->GetFastPath() );
+
+  itk::ImageRegionConstIterator< ImageType > expectedIt( expected->GetOutput(), region );
+  itk::ImageRegionConstIterator< ImageType > actualIt( actual->GetOutput(), region );
+  for( ; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt )
+  {
+    EXPECT_NEAR( expectedIt.Get(), actualIt.Get(), 1e-3 );
+  }
+}
+
+TEST_F( AffineResampleImageFilterTest, FallsBackForNonLinearTransforms )
+{
+  typedef itk::DisplacementFieldTransform< double, 3 > DisplacementFieldTransformType;
+  typedef DisplacementFieldTransformType::DisplacementFieldType DisplacementFieldType;
+
+  auto image = MakeImage( 20 );
+  auto field = DisplacementFieldType::New();
+  field->CopyInformation( image );
+  field->SetRegions( image->GetLargestPossibleRegion() );
+  field->Allocate();
+  DisplacementFieldType::PixelType displacement;
+  displacement.Fill( 0.75 );
+  field->FillBuffer( displacement );
+  auto transform = DisplacementFieldTransformType::New();
+  transform->SetDisplacementField( field );
+
+  auto expected = MakeFilter< GenericResampleFilterType >( image, transform, false );
+  auto actual   = MakeFilter< ResampleFilterType >( image, transform, false );
+  expected->Update();
+  actual->Update();
+  EXPECT_FALSE( actual->GetFastPath() );
+  ExpectNear( expected->GetOutput(), actual->GetOutput(), 0.0 );
+}
+
+#ifdef SUPERELASTIX_BUILD_LONG_UNIT_TESTS
+TEST_F( AffineResampleImageFilterTest, Benchmark )
+{
+  this->Benchmark( 256 );
+}
+#endif
+
+// Needs about 1.5 GB of memory, run with --gtest_also_run_disabled_tests
+TEST_F( AffineResampleImageFilterTest, DISABLED_Benchmark512 )
+{
+  this->Benchmark( 512 );
+}
+} // namespace selx
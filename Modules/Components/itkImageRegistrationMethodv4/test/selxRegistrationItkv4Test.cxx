@@ -43,6 +43,12 @@
 #include "selxItkTransformSourceComponent.h"
 
 #include "selxItkCompositeTransformComponent.h"
+#include "selxItkTransformFlattenerComponent.h"
+#include "selxItkImagePyramidComponent.h"
+#include "selxFlattenTransform.h"
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTranslationTransform.h"
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
@@ -56,6 +62,8 @@
 #include "selxDataManager.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
 namespace selx
 {
 class RegistrationItkv4Test : public ::testing::Test
@@ -98,6 +106,9 @@ public:
     ItkResampleFilterComponent< 3, double, double >,
     ItkCompositeTransformComponent< double, 3 >,
     ItkCompositeTransformComponent< double, 2 >,
+    ItkTransformFlattenerComponent< double, 3 >,
+    ItkTransformFlattenerComponent< double, 2 >,
+    ItkImagePyramidComponent< 2, float >,
     ItkTransformSinkComponent<2, double>, 
     ItkTransformSinkComponent<3, double >,
     ItkTransformSourceComponent<2, double>,
@@ -672,6 +683,196 @@ TEST_F( RegistrationItkv4Test, CompositeTransform )
   resultImageWriter->Update();
 }
 
+TEST_F( RegistrationItkv4Test, FlattenedCompositeTransform )
+{
+  /** make example blueprint configuration */
+  BlueprintPointer blueprint = Blueprint::New();
+
+  blueprint->SetComponent( "MultiStageTransformController", { { "NameOfClass", { "ItkCompositeTransformComponent" } }, { "ExecutionOrder", { "RegistrationMethod1", "RegistrationMethod2" } } } );
+
+  blueprint->SetComponent( "FixedImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } } } );
+  blueprint->SetComponent( "MovingImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } } } );
+  blueprint->SetComponent( "ResultImageSink", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "2" } } } );
+
+  blueprint->SetComponent( "ResampleFilter", { { "NameOfClass", { "ItkResampleFilterComponent" } } } );
+  blueprint->SetConnection( "FixedImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "MovingImageSource", "ResampleFilter", { {} } );
+  blueprint->SetComponent( "TransformFlattener", { { "NameOfClass", { "ItkTransformFlattenerComponent" } } } );
+  blueprint->SetConnection( "MultiStageTransformController", "TransformFlattener", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "TransformFlattener", { {} } );
+  blueprint->SetConnection( "TransformFlattener", "ResampleFilter", { {} } );
+
+  blueprint->SetConnection( "ResampleFilter", "ResultImageSink", {} );
+
+  blueprint->SetComponent( "RegistrationMethod1", { { "NameOfClass", { "ItkImageRegistrationMethodv4Component" } },
+                                                    { "Dimensionality", { "2" } },
+                                                    { "InternalComputationValueType", { "double" } },
+                                                    { "PixelType", { "float" } } } );
+  blueprint->SetConnection( "FixedImageSource", "RegistrationMethod1", { } );
+  blueprint->SetConnection( "MovingImageSource", "RegistrationMethod1", { } );
+
+  blueprint->SetComponent( "Metric1", { { "NameOfClass", { "ItkANTSNeighborhoodCorrelationImageToImageMetricv4Component" } } } );
+  blueprint->SetConnection( "Metric1", "RegistrationMethod1", {} );
+  blueprint->SetComponent( "Transform1", { { "NameOfClass", { "ItkAffineTransformComponent" } } } );
+  blueprint->SetConnection( "Transform1", "RegistrationMethod1", {} );
+  blueprint->SetComponent( "Optimizer1", { { "NameOfClass", { "ItkGradientDescentOptimizerv4Component" } } } );
+  blueprint->SetConnection( "Optimizer1", "RegistrationMethod1", {} );
+
+  blueprint->SetConnection( "RegistrationMethod1", "MultiStageTransformController", {} ); // MultiStageTransformInterface
+
+  blueprint->SetComponent( "RegistrationMethod2", { { "NameOfClass", { "ItkImageRegistrationMethodv4Component" } },
+                                                    { "Dimensionality", { "2" } },
+                                                    { "InternalComputationValueType", { "double" } },
+                                                    { "PixelType", { "float" } },
+                                                    { "NumberOfLevels", { "2" } },
+                                                    { "ShrinkFactorsPerLevel", { "2", "1" } },
+                                                    { "SmoothingSigmasPerLevel", { "2", "1" } } } );
+  blueprint->SetConnection( "FixedImageSource", "RegistrationMethod2", {} );
+  blueprint->SetConnection( "MovingImageSource", "RegistrationMethod2", {} );
+
+  blueprint->SetComponent( "Metric2", { { "NameOfClass", { "ItkANTSNeighborhoodCorrelationImageToImageMetricv4Component" } } } );
+  blueprint->SetConnection( "Metric2", "RegistrationMethod2", {} );
+  blueprint->SetComponent( "Transform2", { { "NameOfClass", { "ItkGaussianExponentialDiffeomorphicTransformComponent" } } } );
+  blueprint->SetConnection( "Transform2", "RegistrationMethod2", {} );
+  blueprint->SetConnection( "FixedImageSource", "Transform2", {} );
+  blueprint->SetComponent( "TransformResolutionAdaptor2", { { "NameOfClass", { "ItkGaussianExponentialDiffeomorphicTransformParametersAdaptorsContainerComponent" } },
+                                                            { "ShrinkFactorsPerLevel", { "2", "1" } } } );
+  blueprint->SetConnection( "FixedImageSource", "TransformResolutionAdaptor2", {} );
+  blueprint->SetConnection( "TransformResolutionAdaptor2", "RegistrationMethod2", {} );
+
+  blueprint->SetComponent( "Optimizer2", { { "NameOfClass", { "ItkGradientDescentOptimizerv4Component" } } } );
+  blueprint->SetConnection( "Optimizer2", "RegistrationMethod2", {} );
+  blueprint->SetConnection( "RegistrationMethod2", "MultiStageTransformController", {} ); // MultiStageTransformInterface
+
+  blueprint->Write( dataManager->GetOutputFile( "RegistrationItkv4Test_FlattenedCompositeTransform.dot" ) );
+
+  // Set up the readers and writers
+  ImageReader2DType::Pointer fixedImageReader = ImageReader2DType::New();
+  fixedImageReader->SetFileName( dataManager->GetInputFile( "coneA2d64.mhd" ) );
+
+  ImageReader2DType::Pointer movingImageReader = ImageReader2DType::New();
+  movingImageReader->SetFileName( dataManager->GetInputFile( "coneB2d64.mhd" ) );
+
+  ImageWriter2DType::Pointer resultImageWriter = ImageWriter2DType::New();
+  resultImageWriter->SetFileName( dataManager->GetOutputFile( "RegistrationItkv4Test_FlattenedCompositeTransform.mhd" ) );
+
+  // Connect SuperElastix in an itk pipeline
+  superElastixFilter->SetInput( "FixedImageSource", fixedImageReader->GetOutput() );
+  superElastixFilter->SetInput( "MovingImageSource", movingImageReader->GetOutput() );
+
+  resultImageWriter->SetInput( superElastixFilter->GetOutput< Image2DType >( "ResultImageSink" ) );
+
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetLogger( logger );
+
+  //Optional Update call
+  //superElastixFilter->Update();
+
+  // Update call on the writers triggers SuperElastix to configure and execute
+  resultImageWriter->Update();
+}
+
+TEST_F( RegistrationItkv4Test, TransformFlattenerDeclaredFirst )
+{
+  // Components are connected in the order in which they are declared, so the ResampleFilter asks the
+  // TransformFlattener for its transform before the transform has been connected to the TransformFlattener.
+  BlueprintPointer blueprint = Blueprint::New();
+
+  blueprint->SetComponent( "TransformFlattener", { { "NameOfClass", { "ItkTransformFlattenerComponent" } } } );
+  blueprint->SetComponent( "ResampleFilter", { { "NameOfClass", { "ItkResampleFilterComponent" } } } );
+  blueprint->SetComponent( "FixedImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } } } );
+  blueprint->SetComponent( "MovingImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } } } );
+  blueprint->SetComponent( "ResultImageSink", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "2" } } } );
+  blueprint->SetComponent( "RegistrationMethod", { { "NameOfClass", { "ItkImageRegistrationMethodv4Component" } },
+                                                   { "Dimensionality", { "2" } },
+                                                   { "InternalComputationValueType", { "double" } },
+                                                   { "PixelType", { "float" } } } );
+  blueprint->SetComponent( "Metric", { { "NameOfClass", { "ItkMeanSquaresImageToImageMetricv4Component" } } } );
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "ItkAffineTransformComponent" } } } );
+  blueprint->SetComponent( "Optimizer", { { "NameOfClass", { "ItkGradientDescentOptimizerv4Component" } }, { "NumberOfIterations", { "1" } } } );
+
+  blueprint->SetConnection( "TransformFlattener", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "MovingImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "ResampleFilter", "ResultImageSink", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "MovingImageSource", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "Metric", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "Transform", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "Optimizer", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "RegistrationMethod", "TransformFlattener", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "TransformFlattener", { {} } );
+
+  ImageReader2DType::Pointer fixedImageReader = ImageReader2DType::New();
+  fixedImageReader->SetFileName( dataManager->GetInputFile( "coneA2d64.mhd" ) );
+
+  ImageReader2DType::Pointer movingImageReader = ImageReader2DType::New();
+  movingImageReader->SetFileName( dataManager->GetInputFile( "coneB2d64.mhd" ) );
+
+  ImageWriter2DType::Pointer resultImageWriter = ImageWriter2DType::New();
+  resultImageWriter->SetFileName( dataManager->GetOutputFile( "RegistrationItkv4Test_TransformFlattenerDeclaredFirst.mhd" ) );
+
+  superElastixFilter->SetInput( "FixedImageSource", fixedImageReader->GetOutput() );
+  superElastixFilter->SetInput( "MovingImageSource", movingImageReader->GetOutput() );
+  resultImageWriter->SetInput( superElastixFilter->GetOutput< Image2DType >( "ResultImageSink" ) );
+
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetLogger( logger );
+
+  EXPECT_NO_THROW( resultImageWriter->Update() );
+}
+
+TEST_F( RegistrationItkv4Test, LevelsFromImagePyramid )
+{
+  // The registration method takes its levels from the pyramid of the fixed image instead of from its settings
+  BlueprintPointer blueprint = Blueprint::New();
+
+  blueprint->SetComponent( "FixedImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } } } );
+  blueprint->SetComponent( "MovingImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } } } );
+  blueprint->SetComponent( "FixedImagePyramid", { { "NameOfClass", { "ItkImagePyramidComponent" } },
+                                                  { "ShrinkFactorsPerLevel", { "4", "2", "1" } },
+                                                  { "SmoothingSigmasPerLevel", { "4", "2", "0" } } } );
+  blueprint->SetComponent( "RegistrationMethod", { { "NameOfClass", { "ItkImageRegistrationMethodv4Component" } },
+                                                   { "Dimensionality", { "2" } },
+                                                   { "InternalComputationValueType", { "double" } },
+                                                   { "PixelType", { "float" } } } );
+  blueprint->SetComponent( "Metric", { { "NameOfClass", { "ItkMeanSquaresImageToImageMetricv4Component" } } } );
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "ItkAffineTransformComponent" } } } );
+  blueprint->SetComponent( "Optimizer", { { "NameOfClass", { "ItkGradientDescentOptimizerv4Component" } }, { "NumberOfIterations", { "1" } } } );
+  blueprint->SetComponent( "ResampleFilter", { { "NameOfClass", { "ItkResampleFilterComponent" } } } );
+  blueprint->SetComponent( "ResultImageSink", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "2" } } } );
+
+  blueprint->SetConnection( "FixedImageSource", "FixedImagePyramid", { {} } );
+  blueprint->SetConnection( "FixedImagePyramid", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "MovingImageSource", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "Metric", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "Transform", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "Optimizer", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "RegistrationMethod", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "MovingImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "ResampleFilter", "ResultImageSink", { {} } );
+
+  ImageReader2DType::Pointer fixedImageReader = ImageReader2DType::New();
+  fixedImageReader->SetFileName( dataManager->GetInputFile( "coneA2d64.mhd" ) );
+
+  ImageReader2DType::Pointer movingImageReader = ImageReader2DType::New();
+  movingImageReader->SetFileName( dataManager->GetInputFile( "coneB2d64.mhd" ) );
+
+  ImageWriter2DType::Pointer resultImageWriter = ImageWriter2DType::New();
+  resultImageWriter->SetFileName( dataManager->GetOutputFile( "RegistrationItkv4Test_LevelsFromImagePyramid.mhd" ) );
+
+  superElastixFilter->SetInput( "FixedImageSource", fixedImageReader->GetOutput() );
+  superElastixFilter->SetInput( "MovingImageSource", movingImageReader->GetOutput() );
+  resultImageWriter->SetInput( superElastixFilter->GetOutput< Image2DType >( "ResultImageSink" ) );
+
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetLogger( logger );
+
+  EXPECT_NO_THROW( resultImageWriter->Update() );
+}
+
 TEST_F(RegistrationItkv4Test, TransformSink)
 {
   /** make example blueprint configuration */
@@ -860,4 +1061,146 @@ TEST_F(RegistrationItkv4Test, TransformSource)
   resultImageWriter->Update();
   resultDisplacementWriter->Update();
 }
+
+TEST_F( RegistrationItkv4Test, StreamedResampling )
+{
+  // The resampled image is written in slabs: the transform is applied once, the ResampleFilter generates each slab separately
+  itk::TransformFactoryBase::RegisterDefaultTransforms();
+  TransformReaderType::Pointer transformReader = TransformReaderType::New();
+  transformReader->SetFileName( dataManager->GetInputFile( "ItkAffine3Dtransform.tfm" ) );
+  transformReader->Update();
+  auto decoratedTransform = Transform3DType::New();
+  decoratedTransform->Set( dynamic_cast< Transform3DNakedType * >( transformReader->GetTransformList()->begin()->GetPointer() ) );
+
+  auto resample = [ & ]( unsigned int numberOfStreamDivisions, const std::string & fileName )
+    {
+      BlueprintPointer blueprint = Blueprint::New();
+      blueprint->SetComponent( "TransformSource", { { "NameOfClass", { "ItkTransformSourceComponent" } }, { "Dimensionality", { "3" } }, { "InternalComputationValueType", { "double" } } } );
+      blueprint->SetComponent( "FixedImageDomainSource", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } } } );
+      blueprint->SetComponent( "MovingImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } } } );
+      blueprint->SetComponent( "ResultImageSink", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } } } );
+      blueprint->SetComponent( "ResampleFilter", { { "NameOfClass", { "ItkResampleFilterComponent" } }, { "Dimensionality", { "3" } } } );
+      blueprint->SetConnection( "TransformSource", "ResampleFilter", { { "NameOfInterface", { "itkTransformInterface" } } } );
+      blueprint->SetConnection( "FixedImageDomainSource", "ResampleFilter", { { "NameOfInterface", { "itkImageDomainFixedInterface" } } } );
+      blueprint->SetConnection( "MovingImageSource", "ResampleFilter", { { "NameOfInterface", { "itkImageMovingInterface" } } } );
+      blueprint->SetConnection( "ResampleFilter", "ResultImageSink", { { "NameOfInterface", { "itkImageInterface" } } } );
+
+      ImageReader3DType::Pointer fixedImageReader = ImageReader3DType::New();
+      fixedImageReader->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+      ImageReader3DType::Pointer movingImageReader = ImageReader3DType::New();
+      movingImageReader->SetFileName( dataManager->GetInputFile( "sphereB3d.mhd" ) );
+
+      SuperElastixFilterBase::Pointer filter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+      filter->SetInput( "FixedImageDomainSource", fixedImageReader->GetOutput() );
+      filter->SetInput( "MovingImageSource", movingImageReader->GetOutput() );
+      filter->SetInput( "TransformSource", decoratedTransform );
+      filter->SetBlueprint( blueprint );
+
+      auto writer = filter->GetOutputFileWriter( "ResultImageSink" );
+      writer->SetFileName( dataManager->GetOutputFile( fileName ) );
+      writer->SetInput( filter->GetOutput( "ResultImageSink" ) );
+      writer->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+      EXPECT_NO_THROW( writer->Update() );
+
+      ImageReader3DType::Pointer resultReader = ImageReader3DType::New();
+      resultReader->SetFileName( dataManager->GetOutputFile( fileName ) );
+      resultReader->Update();
+      return Image3DType::Pointer( resultReader->GetOutput() );
+    };
+
+  auto streamed = resample( 4, "RegistrationItkv4Test_StreamedResampling.mha" );
+  auto reference = resample( 1, "RegistrationItkv4Test_StreamedResampling_reference.mha" );
+
+  ASSERT_EQ( streamed->GetLargestPossibleRegion(), reference->GetLargestPossibleRegion() );
+  const auto numberOfPixels = reference->GetLargestPossibleRegion().GetNumberOfPixels();
+  EXPECT_TRUE( std::equal( reference->GetBufferPointer(), reference->GetBufferPointer() + numberOfPixels, streamed->GetBufferPointer() ) );
+}
+
+TEST( FlattenTransformTest, MergesLinearTransforms )
+{
+  using CompositeTransformType   = itk::CompositeTransform< double, 2 >;
+  using AffineTransformType      = itk::AffineTransform< double, 2 >;
+  using TranslationTransformType = itk::TranslationTransform< double, 2 >;
+
+  auto rotation = AffineTransformType::New();
+  rotation->Rotate2D( 0.3 );
+  auto scaling = AffineTransformType::New();
+  scaling->Scale( 1.5 );
+  auto translation = TranslationTransformType::New();
+  TranslationTransformType::OutputVectorType offset;
+  offset[ 0 ] = 2.0;
+  offset[ 1 ] = -3.0;
+  translation->Translate( offset );
+
+  // Nested as after two registration stages, of which the first was initialized by a translation
+  auto stage1 = CompositeTransformType::New();
+  stage1->AddTransform( rotation );
+  stage1->AddTransform( translation );
+  auto chain = CompositeTransformType::New();
+  chain->AddTransform( scaling );
+  chain->AddTransform( stage1 );
+
+  auto flattened = FlattenTransform< double, 2 >( chain, nullptr );
+  ASSERT_NE( dynamic_cast< AffineTransformType * >( flattened.GetPointer() ), nullptr );
+
+  CompositeTransformType::InputPointType point;
+  point[ 0 ] = 7.0;
+  point[ 1 ] = -4.0;
+  const auto expected = chain->TransformPoint( point );
+  const auto actual   = flattened->TransformPoint( point );
+  EXPECT_NEAR( actual[ 0 ], expected[ 0 ], 1e-9 );
+  EXPECT_NEAR( actual[ 1 ], expected[ 1 ], 1e-9 );
+}
+
+
+TEST( FlattenTransformTest, SamplesNonLinearChainOnGrid )
+{
+  using CompositeTransformType         = itk::CompositeTransform< double, 2 >;
+  using AffineTransformType            = itk::AffineTransform< double, 2 >;
+  using DisplacementFieldTransformType = itk::DisplacementFieldTransform< double, 2 >;
+  using DisplacementFieldType          = DisplacementFieldTransformType::DisplacementFieldType;
+
+  DisplacementFieldType::SizeType size;
+  size.Fill( 16 );
+  DisplacementFieldType::SpacingType spacing;
+  spacing.Fill( 2.0 );
+  auto field = DisplacementFieldType::New();
+  field->SetRegions( size );
+  field->SetSpacing( spacing );
+  field->Allocate();
+  itk::ImageRegionIteratorWithIndex< DisplacementFieldType > it( field, field->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it )
+  {
+    DisplacementFieldType::PixelType displacement;
+    displacement[ 0 ] = 0.1 * it.GetIndex()[ 1 ];
+    displacement[ 1 ] = -0.05 * it.GetIndex()[ 0 ];
+    it.Set( displacement );
+  }
+  auto deformation = DisplacementFieldTransformType::New();
+  deformation->SetDisplacementField( field );
+
+  auto affine = AffineTransformType::New();
+  affine->Rotate2D( 0.05 );
+  auto scaling = AffineTransformType::New();
+  scaling->Scale( 1.01 );
+
+  // The affine transforms are applied first, as after an affine stage followed by a deformable stage
+  auto chain = CompositeTransformType::New();
+  chain->AddTransform( deformation );
+  chain->AddTransform( scaling );
+  chain->AddTransform( affine );
+
+  auto flattened = FlattenTransform< double, 2 >( chain, field.GetPointer() );
+  ASSERT_NE( dynamic_cast< DisplacementFieldTransformType * >( flattened.GetPointer() ), nullptr );
+
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+  {
+    CompositeTransformType::InputPointType point;
+    field->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    const auto expected = chain->TransformPoint( point );
+    const auto actual   = flattened->TransformPoint( point );
+    EXPECT_NEAR( actual[ 0 ], expected[ 0 ], 1e-4 );
+    EXPECT_NEAR( actual[ 1 ], expected[ 1 ], 1e-4 );
+  }
+}
 } // namespace selx
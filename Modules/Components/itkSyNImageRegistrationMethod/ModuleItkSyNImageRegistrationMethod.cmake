@@ -32,3 +32,8 @@ set( ${MODULE}_LIBRARIES
 set( ${MODULE}_TEST_SOURCE_FILES 
    ${${MODULE}_SOURCE_DIR}/test/selxSyNRegistrationItkv4Test.cxx
 )
+
+set( ${MODULE}_MODULE_DEPENDENCIES
+  ModuleIntensityPreprocessing
+  ModuleImagePyramid
+)
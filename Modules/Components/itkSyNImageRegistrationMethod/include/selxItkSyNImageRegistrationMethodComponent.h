@@ -25,6 +25,7 @@
 #include "selxItkRegistrationMethodv4Interfaces.h"
 #include "selxSinksAndSourcesInterfaces.h"
 #include "selxItkObjectInterfaces.h"
+#include "selxImagePyramidInterfaces.h"
 
 #include "itkSyNImageRegistrationMethod.h"
 #include "itkGradientDescentOptimizerv4.h"
@@ -33,8 +34,7 @@
 #include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkGaussianExponentialDiffeomorphicTransform.h"
 #include "itkGaussianExponentialDiffeomorphicTransformParametersAdaptor.h"
-#include "itkRescaleIntensityImageFilter.h"
-#include "itkInvertIntensityImageFilter.h"
+#include "selxIntensityPreprocessingImageFilter.h"
 
 namespace selx
 {
@@ -43,7 +43,8 @@ class ItkSyNImageRegistrationMethodComponent :
   public SuperElastixComponent<
   Accepting< itkImageFixedInterface< Dimensionality, PixelType >,
   itkImageMovingInterface< Dimensionality, PixelType >,
-  itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >
+  itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >,
+  itkImagePyramidInterface< Dimensionality >
   >,
   Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
   UpdateInterface
@@ -60,7 +61,8 @@ public:
     Accepting<
     itkImageFixedInterface< Dimensionality, PixelType >,
     itkImageMovingInterface< Dimensionality, PixelType >,
-    itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >
+    itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >,
+    itkImagePyramidInterface< Dimensionality >
     >,
     Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
     UpdateInterface
@@ -88,18 +90,10 @@ public:
   using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift< ImageMetricType >;
   using ScalesEstimatorPointer = typename ScalesEstimatorType::Pointer;
 
-  using FixedRescaleImageFilterType = itk::RescaleIntensityImageFilter<FixedImageType, FixedImageType >;
-  using FixedRescaleImageFilterPointer = typename FixedRescaleImageFilterType::Pointer;
-  using MovingRescaleImageFilterType = itk::RescaleIntensityImageFilter<MovingImageType, MovingImageType >;
-  using MovingRescaleImageFilterPointer = typename MovingRescaleImageFilterType::Pointer;
-  using FixedInvertIntensityImageFilterType = itk::InvertIntensityImageFilter<FixedImageType, FixedImageType>;
-  using FixedInvertIntensityImageFilterPointer = typename FixedInvertIntensityImageFilterType::Pointer;
-  using MovingInvertIntensityImageFilterType = itk::InvertIntensityImageFilter<MovingImageType, MovingImageType>;
-  using MovingInvertIntensityImageFilterPointer = typename MovingInvertIntensityImageFilterType::Pointer;
-  using FixedImageCalculatorFilterType = itk::MinimumMaximumImageCalculator<FixedImageType>;
-  using FixedImageCalculatorFilterPointer = typename FixedImageCalculatorFilterType::Pointer;
-  using MovingImageCalculatorFilterType = itk::MinimumMaximumImageCalculator<MovingImageType>;
-  using MovingImageCalculatorFilterPointer = typename MovingImageCalculatorFilterType::Pointer;
+  using FixedIntensityPreprocessingFilterType = IntensityPreprocessingImageFilter< FixedImageType, FixedImageType >;
+  using FixedIntensityPreprocessingFilterPointer = typename FixedIntensityPreprocessingFilterType::Pointer;
+  using MovingIntensityPreprocessingFilterType = IntensityPreprocessingImageFilter< MovingImageType, MovingImageType >;
+  using MovingIntensityPreprocessingFilterPointer = typename MovingIntensityPreprocessingFilterType::Pointer;
 
   //Accepting Interfaces:
   virtual int Accept( typename itkImageFixedInterface< Dimensionality, PixelType >::Pointer ) override;
@@ -108,24 +102,36 @@ public:
 
   virtual int Accept( typename itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >::Pointer ) override;
 
+  virtual int Accept( typename itkImagePyramidInterface< Dimensionality >::Pointer ) override;
+
   //Providing Interfaces:
   virtual TransformPointer GetItkTransform() override;
 
   virtual void BeforeUpdate() override;
   virtual void Update() override;
+  virtual void ReleaseData() override;
 
   //BaseClass methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
+  // The pyramid is optional, the levels may be set by the settings instead
+  virtual bool ConnectionsSatisfied() override;
+
   //static const char * GetName() { return "ItkSyNImageRegistrationMethod"; } ;
   static const char * GetDescription() { return "ItkSyNImageRegistrationMethod Component"; }
 
 private:
 
+  // See ItkImageRegistrationMethodv4Component::SetIntensityAdjustedImages
+  void SetIntensityAdjustedImages();
+
   SyNImageRegistrationMethodPointer m_SyNImageRegistrationMethod;
   FixedImagePointer m_FixedImage;
   MovingImagePointer m_MovingImage;
 
+  // If connected, the pyramid of the fixed image provides the geometry of the levels
+  typename itkImagePyramidInterface< Dimensionality >::Pointer m_ImagePyramid;
+
   // The settings SmoothingSigmas and ShrinkFactors imply NumberOfLevels, if the user
   // provides inconsistent numbers we should detect that and report about it.
   std::string m_NumberOfLevelsLastSetBy;
@@ -21,12 +21,64 @@
 #include "selxItkImageRegistrationMethodv4Component.h"
 
 #include "itkDisplacementFieldTransformParametersAdaptor.h"
+#include "selxImagePyramid.h"
 //TODO: get rid of these
 #include "itkGradientDescentOptimizerv4.h"
 #include "selxStringConverter.h"
 
 namespace selx
 {
+/** Records the metric value and learning rate of each SyN iteration in the profiler of a component.
+ * Unlike ItkImageRegistrationMethodv4Component, SyN does not iterate its optimizer, it updates the displacement
+ * fields itself and reports its iterations as events of the filter.
+ */
+template< typename TFilter >
+class SyNIterationUpdate : public itk::Command
+{
+public:
+
+  typedef SyNIterationUpdate        Self;
+  typedef itk::Command              Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+  itkNewMacro( Self );
+
+  void SetComponent( const ComponentBase * component ) { this->m_Component = component; }
+
+protected:
+
+  SyNIterationUpdate() : m_Component( nullptr ) {}
+
+public:
+
+  virtual void Execute( itk::Object * caller, const itk::EventObject & event ) ITK_OVERRIDE
+  {
+    Execute( (const itk::Object *)caller, event );
+  }
+
+
+  virtual void Execute( const itk::Object * object, const itk::EventObject & event ) ITK_OVERRIDE
+  {
+    const TFilter * filter = dynamic_cast< const TFilter * >( object );
+    if( filter == nullptr || this->m_Component == nullptr || !this->m_Component->m_Profiler
+      || typeid( event ) != typeid( itk::IterationEvent ) )
+    {
+      return;
+    }
+
+    Profiler::Iteration iteration;
+    iteration.componentName             = this->m_Component->m_Name;
+    iteration.level                     = static_cast< unsigned int >( filter->GetCurrentLevel() );
+    iteration.iteration                 = static_cast< unsigned int >( filter->GetCurrentIteration() );
+    iteration.values[ "MetricValue" ]   = static_cast< double >( filter->GetCurrentMetricValue() );
+    iteration.values[ "LearningRate" ]  = static_cast< double >( filter->GetLearningRate() );
+    this->m_Component->m_Profiler->AddIteration( iteration );
+  }
+
+private:
+
+  const ComponentBase * m_Component;
+};
+
 template< int Dimensionality, class TPixel , class InternalComputationValueType >
 ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >
   ::ItkSyNImageRegistrationMethodComponent( const std::string & name, LoggerImpl & logger ) 
@@ -75,74 +127,111 @@ ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputat
   return 0;
 }
 
+
 template< int Dimensionality, class TPixel, class InternalComputationValueType >
-void
-ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >::BeforeUpdate( void )
+int
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >
+::Accept( typename itkImagePyramidInterface< Dimensionality >::Pointer component )
 {
-	FixedImagePointer fixedImage = this->m_FixedImage;
-	MovingImagePointer movingImage = this->m_MovingImage;
-
-  fixedImage->Update();
-  movingImage->Update();
+  // As in ItkImageRegistrationMethodv4Component, the registration method smooths and shrinks by the schedule of the pyramid
+  const unsigned int numberOfLevels = component->GetNumberOfLevels();
+  if( this->m_NumberOfLevelsLastSetBy != "" )
+  {
+    this->m_Logger.Log( LogLevel::WRN, "{0}: The levels set by {1} are replaced by the {2} levels of the connected pyramid.",
+      this->m_Name, this->m_NumberOfLevelsLastSetBy, numberOfLevels );
+  }
 
-	if (this->m_RescaleIntensity.size() == 2) {
-		this->m_Logger.Log(LogLevel::INF, "{0}: Rescaling images to [{1}, {2}].", this->m_Name, this->m_RescaleIntensity[0], this->m_RescaleIntensity[1]);
+  itk::Array< itk::SizeValueType >            shrinkFactorsPerLevel( numberOfLevels );
+  itk::Array< InternalComputationValueType > smoothingSigmasPerLevel( numberOfLevels );
+  for( unsigned int level = 0; level < numberOfLevels; ++level )
+  {
+    shrinkFactorsPerLevel[ level ]   = component->GetShrinkFactorAtLevel( level );
+    smoothingSigmasPerLevel[ level ] = component->GetSmoothingSigmaAtLevel( level );
+  }
+  this->m_SyNImageRegistrationMethod->SetNumberOfLevels( numberOfLevels );
+  this->m_SyNImageRegistrationMethod->SetShrinkFactorsPerLevel( shrinkFactorsPerLevel );
+  this->m_SyNImageRegistrationMethod->SetSmoothingSigmasPerLevel( smoothingSigmasPerLevel );
+  this->m_SyNImageRegistrationMethod->SmoothingSigmasAreSpecifiedInPhysicalUnitsOn();
+  this->m_NumberOfLevelsLastSetBy = "ImagePyramid";
+  this->m_ImagePyramid = component;
+  return 0;
+}
 
-		FixedRescaleImageFilterPointer fixedIntensityRescaler = FixedRescaleImageFilterType::New();
-		fixedIntensityRescaler->SetInput(fixedImage);
-		fixedIntensityRescaler->SetOutputMinimum(StringConverter{ this->m_RescaleIntensity[0] });
-		fixedIntensityRescaler->SetOutputMaximum(StringConverter{ this->m_RescaleIntensity[1] });
-		fixedIntensityRescaler->UpdateOutputInformation();
-		fixedImage = fixedIntensityRescaler->GetOutput();
-		fixedImage->Update();
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >::BeforeUpdate( void )
+{
+	// Images are (re)connected as in ItkImageRegistrationMethodv4Component::BeforeUpdate
+	this->m_SyNImageRegistrationMethod->SetFixedImage(this->m_FixedImage);
+	this->m_SyNImageRegistrationMethod->SetMovingImage(this->m_MovingImage);
 
-		MovingRescaleImageFilterPointer movingIntensityRescaler = MovingRescaleImageFilterType::New();
-		movingIntensityRescaler->SetInput(movingImage);
-		movingIntensityRescaler->SetOutputMinimum(StringConverter{ this->m_RescaleIntensity[0] });
-		movingIntensityRescaler->SetOutputMaximum(StringConverter{ this->m_RescaleIntensity[1] });
-		movingIntensityRescaler->UpdateOutputInformation();
-		movingImage = movingIntensityRescaler->GetOutput();
-		movingImage->Update();
+	if(this->m_MetricSamplingPercentage < 1.0) {
+		this->m_SyNImageRegistrationMethod->SetMetricSamplingPercentage(this->m_MetricSamplingPercentage);
 	}
+};
 
-	if (this->m_InvertIntensity) {
-		this->m_Logger.Log(LogLevel::INF, "{0}: Inverting image scales", this->m_Name);
-
-		FixedImageCalculatorFilterPointer fixedIntensityMaximumCalculator = FixedImageCalculatorFilterType::New();
-		fixedIntensityMaximumCalculator->SetImage(fixedImage);
-		fixedIntensityMaximumCalculator->ComputeMaximum();
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >::SetIntensityAdjustedImages( void )
+{
+	FixedImagePointer fixedImage = this->m_FixedImage;
+	MovingImagePointer movingImage = this->m_MovingImage;
 
-		FixedInvertIntensityImageFilterPointer fixedIntensityInverter = FixedInvertIntensityImageFilterType::New();
-		fixedIntensityInverter->SetInput(fixedImage);
-		fixedIntensityInverter->SetMaximum(fixedIntensityMaximumCalculator->GetMaximum());
-		fixedIntensityInverter->UpdateOutputInformation();
-		fixedImage = fixedIntensityInverter->GetOutput();
+	if (this->m_RescaleIntensity.size() == 2 || this->m_InvertIntensity) {
+		FixedIntensityPreprocessingFilterPointer fixedIntensityAdjuster = FixedIntensityPreprocessingFilterType::New();
+		fixedIntensityAdjuster->SetInput(fixedImage);
+		MovingIntensityPreprocessingFilterPointer movingIntensityAdjuster = MovingIntensityPreprocessingFilterType::New();
+		movingIntensityAdjuster->SetInput(movingImage);
+		if (this->GetNumberOfThreads() > 0) {
+			fixedIntensityAdjuster->SetNumberOfThreads(this->GetNumberOfThreads());
+			movingIntensityAdjuster->SetNumberOfThreads(this->GetNumberOfThreads());
+		}
+
+		if (this->m_RescaleIntensity.size() == 2) {
+			this->m_Logger.Log(LogLevel::INF, "{0}: Rescaling images to [{1}, {2}].", this->m_Name, this->m_RescaleIntensity[0], this->m_RescaleIntensity[1]);
+			fixedIntensityAdjuster->RescaleOn();
+			fixedIntensityAdjuster->SetOutputMinimum(StringConverter{ this->m_RescaleIntensity[0] });
+			fixedIntensityAdjuster->SetOutputMaximum(StringConverter{ this->m_RescaleIntensity[1] });
+			movingIntensityAdjuster->RescaleOn();
+			movingIntensityAdjuster->SetOutputMinimum(StringConverter{ this->m_RescaleIntensity[0] });
+			movingIntensityAdjuster->SetOutputMaximum(StringConverter{ this->m_RescaleIntensity[1] });
+		}
+
+		if (this->m_InvertIntensity) {
+			this->m_Logger.Log(LogLevel::INF, "{0}: Inverting image scales", this->m_Name);
+			fixedIntensityAdjuster->InvertOn();
+			movingIntensityAdjuster->InvertOn();
+		}
+
+		fixedIntensityAdjuster->UpdateOutputInformation();
+		fixedImage = fixedIntensityAdjuster->GetOutput();
 		fixedImage->Update();
-
-		MovingImageCalculatorFilterPointer movingIntensityMaximumCalculator = MovingImageCalculatorFilterType::New();
-		movingIntensityMaximumCalculator->SetImage(movingImage);
-		movingIntensityMaximumCalculator->ComputeMaximum();
-
-		MovingInvertIntensityImageFilterPointer movingIntensityInverter = MovingInvertIntensityImageFilterType::New();
-		movingIntensityInverter->SetInput(movingImage);
-		movingIntensityInverter->SetMaximum(movingIntensityMaximumCalculator->GetMaximum());
-		movingIntensityInverter->UpdateOutputInformation();
-		movingImage = movingIntensityInverter->GetOutput();
+		movingIntensityAdjuster->UpdateOutputInformation();
+		movingImage = movingIntensityAdjuster->GetOutput();
 		movingImage->Update();
 	}
 
 	this->m_SyNImageRegistrationMethod->SetFixedImage(fixedImage);
 	this->m_SyNImageRegistrationMethod->SetMovingImage(movingImage);
+}
 
-	if(this->m_MetricSamplingPercentage < 1.0) {
-		this->m_SyNImageRegistrationMethod->SetMetricSamplingPercentage(this->m_MetricSamplingPercentage);
-	}
-};
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >::ReleaseData( void )
+{
+	// See ItkImageRegistrationMethodv4Component::ReleaseData
+	this->m_SyNImageRegistrationMethod->SetFixedImage(this->m_FixedImage);
+	this->m_SyNImageRegistrationMethod->SetMovingImage(this->m_MovingImage);
+}
 
 template< int Dimensionality, class TPixel, class InternalComputationValueType >
 void
 ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >::Update( void )
 {
+	// As in ItkImageRegistrationMethodv4Component::Update
+	this->m_FixedImage->Update();
+	this->m_MovingImage->Update();
+	this->SetIntensityAdjustedImages();
 
 	typedef itk::Vector< InternalComputationValueType, Dimensionality > VectorType;
 	VectorType zeroVector( 0.0 );
@@ -192,6 +281,14 @@ ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputat
   optimizer->SetDoEstimateLearningRateOnce( false ); //true by default
   optimizer->SetDoEstimateLearningRateAtEachIteration( false );
 
+  // Threads as in ItkImageRegistrationMethodv4Component::Update
+  if( this->GetNumberOfThreads() > 0 )
+  {
+    this->m_SyNImageRegistrationMethod->SetNumberOfThreads( this->GetNumberOfThreads() );
+    theMetric->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+    optimizer->SetNumberOfThreads( this->GetNumberOfThreads() );
+  }
+
 	typedef typename SyNImageRegistrationMethodType::OutputTransformType OutputTransformType;
   typedef itk::DisplacementFieldTransformParametersAdaptor< OutputTransformType > DisplacementFieldTransformAdaptorType;
 
@@ -201,21 +298,17 @@ ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputat
   
   for( unsigned int level = 0; level < numberOfResolutionLevels; level++ )
   {
-    // We use the shrink image filter to calculate the fixed parameters of the virtual
-    // domain at each level.  To speed up calculation and avoid unnecessary memory
-    // usage, we could calculate these fixed parameters directly.
-
-    typedef itk::ShrinkImageFilter< FixedImageType, FixedImageType > ShrinkFilterType;
-    typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
-    shrinkFilter->SetShrinkFactors( this->m_SyNImageRegistrationMethod->GetShrinkFactorsPerDimension( level ) );
-    shrinkFilter->SetInput( this->m_FixedImage );
-    shrinkFilter->Update();
+    // The fixed parameters of the virtual domain at each level are those of the fixed image shrunk by
+    // the shrink image filter of the registration method, derived without shrinking the pixels, either
+    // by the pyramid or from the shrink factors of the settings.
+    auto shrunkDomain = this->m_ImagePyramid ? this->m_ImagePyramid->GetItkImageDomainAtLevel( level )
+      : ShrinkImageDomain< Dimensionality >( this->m_FixedImage.GetPointer(), this->m_SyNImageRegistrationMethod->GetShrinkFactorsPerDimension( level ) );
 
     typename DisplacementFieldTransformAdaptorType::Pointer fieldTransformAdaptor = DisplacementFieldTransformAdaptorType::New();
-    fieldTransformAdaptor->SetRequiredSpacing( shrinkFilter->GetOutput()->GetSpacing() );
-    fieldTransformAdaptor->SetRequiredSize( shrinkFilter->GetOutput()->GetBufferedRegion().GetSize() );
-    fieldTransformAdaptor->SetRequiredDirection( shrinkFilter->GetOutput()->GetDirection() );
-    fieldTransformAdaptor->SetRequiredOrigin( shrinkFilter->GetOutput()->GetOrigin() );
+    fieldTransformAdaptor->SetRequiredSpacing( shrunkDomain->GetSpacing() );
+    fieldTransformAdaptor->SetRequiredSize( shrunkDomain->GetLargestPossibleRegion().GetSize() );
+    fieldTransformAdaptor->SetRequiredDirection( shrunkDomain->GetDirection() );
+    fieldTransformAdaptor->SetRequiredOrigin( shrunkDomain->GetOrigin() );
 
     adaptors.push_back( fieldTransformAdaptor.GetPointer() );
   }
@@ -224,10 +317,20 @@ ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputat
 
   typedef CommandIterationUpdate< SyNImageRegistrationMethodType > RegistrationCommandType;
   typename RegistrationCommandType::Pointer registrationObserver = RegistrationCommandType::New();
-  this->m_SyNImageRegistrationMethod->AddObserver( itk::IterationEvent(), registrationObserver );
+  registrationObserver->SetComponent( this );
+  const unsigned long registrationObserverTag = this->m_SyNImageRegistrationMethod->AddObserver( itk::IterationEvent(), registrationObserver );
+
+  typedef SyNIterationUpdate< SyNImageRegistrationMethodType > IterationRecorderType;
+  typename IterationRecorderType::Pointer iterationRecorder = IterationRecorderType::New();
+  iterationRecorder->SetComponent( this );
+  const unsigned long iterationRecorderTag = this->m_SyNImageRegistrationMethod->AddObserver( itk::IterationEvent(), iterationRecorder );
 
   // perform the actual registration
   this->m_SyNImageRegistrationMethod->Update();
+
+  // Observers are removed for the same reason as in ItkImageRegistrationMethodv4Component::Update
+  this->m_SyNImageRegistrationMethod->RemoveObserver( registrationObserverTag );
+  this->m_SyNImageRegistrationMethod->RemoveObserver( iterationRecorderTag );
 }
 
 
@@ -488,4 +591,16 @@ ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputat
     return false;
   }
 }
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+bool
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >
+::ConnectionsSatisfied()
+{
+  // Allow unconnected itkImagePyramidInterface (the levels are set by the settings instead)
+  return this->InterfaceAcceptor< itkImageFixedInterface< Dimensionality, TPixel >>::GetAccepted()
+    && this->InterfaceAcceptor< itkImageMovingInterface< Dimensionality, TPixel >>::GetAccepted()
+    && this->InterfaceAcceptor< itkMetricv4Interface< Dimensionality, TPixel, InternalComputationValueType >>::GetAccepted();
+}
 } //end namespace selx
@@ -41,6 +41,7 @@
 #include "selxItkTransformSourceComponent.h"
 
 #include "selxItkCompositeTransformComponent.h"
+#include "selxItkImagePyramidComponent.h"
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
@@ -89,7 +90,8 @@ public:
     ItkTransformDisplacementFilterComponent< 2, float, double >,
     ItkTransformDisplacementFilterComponent< 3, double, double >,
     ItkResampleFilterComponent< 2, float, double >,
-    ItkResampleFilterComponent< 3, double, double >> RegisterComponents;
+    ItkResampleFilterComponent< 3, double, double >,
+    ItkImagePyramidComponent< 2, float >> RegisterComponents;
 
   typedef Blueprint::Pointer BlueprintPointer;
 
@@ -217,6 +219,52 @@ TEST_F(SyNRegistrationItkv4Test, FullyConfigured3d)
   EXPECT_NO_THROW( resultImageWriter->Update() );
   EXPECT_NO_THROW( resultDisplacementWriter->Update() );
 }
+TEST_F( SyNRegistrationItkv4Test, LevelsFromImagePyramid )
+{
+  // The registration method takes its levels and the level geometry of its displacement field from the pyramid of the fixed image
+  BlueprintPointer blueprint = Blueprint::New();
+
+  blueprint->SetComponent( "FixedImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "2" } } } );
+  blueprint->SetComponent( "MovingImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "2" } } } );
+  blueprint->SetComponent( "FixedImagePyramid", { { "NameOfClass", { "ItkImagePyramidComponent" } },
+                                                  { "ShrinkFactorsPerLevel", { "4", "2", "1" } },
+                                                  { "SmoothingSigmasPerLevel", { "4", "2", "0" } } } );
+  blueprint->SetComponent( "RegistrationMethod", { { "NameOfClass", { "ItkSyNImageRegistrationMethodComponent" } },
+                                                   { "Dimensionality", { "2" } },
+                                                   { "NumberOfIterations", { "2", "2", "2" } } } );
+  blueprint->SetComponent( "Metric", { { "NameOfClass", { "ItkMeanSquaresImageToImageMetricv4Component" } }, { "Dimensionality", { "2" } } } );
+  blueprint->SetComponent( "ResampleFilter", { { "NameOfClass", { "ItkResampleFilterComponent" } }, { "Dimensionality", { "2" } } } );
+  blueprint->SetComponent( "ResultImageSink", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "2" } } } );
+
+  blueprint->SetConnection( "FixedImageSource", "FixedImagePyramid", { {} } );
+  blueprint->SetConnection( "FixedImagePyramid", "RegistrationMethod", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "RegistrationMethod", { { "NameOfInterface", { "itkImageFixedInterface" } } } );
+  blueprint->SetConnection( "MovingImageSource", "RegistrationMethod", { { "NameOfInterface", { "itkImageMovingInterface" } } } );
+  blueprint->SetConnection( "Metric", "RegistrationMethod", { { "NameOfInterface", { "itkMetricv4Interface" } } } );
+  blueprint->SetConnection( "RegistrationMethod", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "FixedImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "MovingImageSource", "ResampleFilter", { {} } );
+  blueprint->SetConnection( "ResampleFilter", "ResultImageSink", { { "NameOfInterface", { "itkImageInterface" } } } );
+
+  ImageReader2DType::Pointer fixedImageReader = ImageReader2DType::New();
+  fixedImageReader->SetFileName( dataManager->GetInputFile( "coneA2d64.mhd" ) );
+
+  ImageReader2DType::Pointer movingImageReader = ImageReader2DType::New();
+  movingImageReader->SetFileName( dataManager->GetInputFile( "coneB2d64.mhd" ) );
+
+  ImageWriter2DType::Pointer resultImageWriter = ImageWriter2DType::New();
+  resultImageWriter->SetFileName( dataManager->GetOutputFile( "SyNRegistrationItkv4Test_LevelsFromImagePyramid.mhd" ) );
+
+  superElastixFilter->SetInput( "FixedImageSource", fixedImageReader->GetOutput() );
+  superElastixFilter->SetInput( "MovingImageSource", movingImageReader->GetOutput() );
+  resultImageWriter->SetInput( superElastixFilter->GetOutput< Image2DType >( "ResultImageSink" ) );
+
+  EXPECT_NO_THROW( superElastixFilter->SetBlueprint( blueprint ) );
+  EXPECT_NO_THROW( superElastixFilter->SetLogger( logger ) );
+
+  EXPECT_NO_THROW( resultImageWriter->Update() );
+}
+
 TEST_F( SyNRegistrationItkv4Test, WBIRDemo )
 {
   /** make example blueprint configuration */
@@ -25,8 +25,13 @@ set( ${MODULE}_INCLUDE_DIRS
 set( ${MODULE}_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/src/selxComponentBase.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxCheckTemplateProperties.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxComponentPrototypeIndex.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxComponentSelectionCache.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxGitInfo.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxMemoizationCache.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxNetworkContainer.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxProfiler.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxThreadBudget.cxx
 )
 
 # Export tests
@@ -34,12 +39,20 @@ set( ${MODULE}_TEST_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/test/selxComponentSelectorTest.cxx
   ${${MODULE}_SOURCE_DIR}/test/selxComponentInterfaceTest.cxx
   ${${MODULE}_SOURCE_DIR}/test/selxNetworkBuilderTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxNetworkContainerTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxProfilerTest.cxx
 )
 
 set( ${MODULE}_LIBRARIES
   ModuleCore
+  ${Boost_LIBRARIES} # MemoizationCache: filesystem
 )
 
+# Profiler::GetPeakResidentSetSize
+if( WIN32 )
+  list( APPEND ${MODULE}_LIBRARIES psapi )
+endif()
+
 set( ${MODULE}_MODULE_DEPENDENCIES
   ModuleCommon
   ModuleFileIO
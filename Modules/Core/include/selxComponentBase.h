@@ -31,6 +31,7 @@
 #include <memory>
 
 #include "selxLoggerImpl.h"
+#include "selxProfiler.h"
 
 namespace selx
 {
@@ -134,9 +135,41 @@ public:
     this->m_Logger.Log( LogLevel::OFF, fmt, args ... );
   }
 
+  // Components may report intermediate results, such as optimizer iterations, if the network is profiled
+  void SetProfiler( Profiler::Pointer profiler )
+  {
+    this->m_Profiler = profiler;
+  }
+
+  // The maximum number of threads of the component, set by its NumberOfThreads setting. 0 means no maximum.
+  void SetMaximumNumberOfThreads( unsigned int maximumNumberOfThreads )
+  {
+    this->m_MaximumNumberOfThreads = maximumNumberOfThreads;
+  }
+
+  unsigned int GetMaximumNumberOfThreads() const
+  {
+    return this->m_MaximumNumberOfThreads;
+  }
+
+  // The number of threads the component may use while it is updated, its share of the ThreadBudget set by the
+  // NetworkContainer. Components pass it on to the multi-threaded algorithms they run. 0 means the default of the toolkit.
+  void SetNumberOfThreads( unsigned int numberOfThreads )
+  {
+    this->m_NumberOfThreads = numberOfThreads;
+  }
+
+  unsigned int GetNumberOfThreads() const
+  {
+    return this->m_NumberOfThreads;
+  }
+
   const std::string m_Name;
   std::string m_HowToCite;
   LoggerImpl & m_Logger;
+  Profiler::Pointer m_Profiler;
+  unsigned int m_MaximumNumberOfThreads;
+  unsigned int m_NumberOfThreads;
 
 };
 } // end namespace selx
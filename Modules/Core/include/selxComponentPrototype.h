@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxComponentPrototype_h
+#define selxComponentPrototype_h
+
+#include "selxComponentBase.h"
+#include "selxCheckTemplateProperties.h"
+#include "selxInterfaceCompatibilityTable.h"
+#include "selxLoggerImpl.h"
+#include "selxTypeList.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace selx
+{
+/** \class ComponentPrototypeBase
+ * \brief Static description of a component type by which the ComponentSelector can narrow its
+ * selection without constructing the component.
+ *
+ * A prototype knows the template properties and the accepting and providing interfaces of its
+ * component type. Only criteria that are regular settings (e.g. "NumberOfIterations") require
+ * an actual component object, which the prototype creates on request.
+ */
+class ComponentPrototypeBase
+{
+public:
+
+  typedef std::shared_ptr< ComponentPrototypeBase >       Pointer;
+  typedef std::shared_ptr< const ComponentPrototypeBase > ConstPointer;
+  typedef std::map< std::string, std::string >            TemplatePropertiesType;
+
+  ComponentPrototypeBase( std::size_t index ) : m_Index( index ) {}
+
+  virtual ~ComponentPrototypeBase() {}
+
+  /** Position of the component type in the component list, i.e. its row and column in the InterfaceCompatibilityTable */
+  std::size_t GetIndex() const { return this->m_Index; }
+
+  /** Check the criterion against the template properties of the component type. Returns
+   * CriterionStatus::Unknown if the criterion is not a template property, in which case
+   * only a constructed component can decide by MeetsCriterion. */
+  virtual CriterionStatus CheckTemplateCriterion( const ComponentBase::CriterionType & criterion ) const = 0;
+
+  /** The template properties of the component type, empty if it declares none */
+  virtual TemplatePropertiesType GetTemplateProperties() const = 0;
+
+  virtual unsigned int CountAcceptingInterfaces( const ComponentBase::InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  virtual unsigned int CountProvidingInterfaces( const ComponentBase::InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  /** Bit mask of the accepting interfaces that meet the criteria */
+  virtual InterfaceMaskType AcceptingInterfacesMask( const ComponentBase::InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  /** Construct the component this prototype describes */
+  virtual ComponentBase::Pointer New( const std::string & name, LoggerImpl & logger ) const = 0;
+
+private:
+
+  const std::size_t m_Index;
+};
+
+// Components declare their TemplateProperties() as a protected static member. This helper
+// derives from the component type (it is never instantiated) to detect and call it.
+template< class ComponentType >
+class StaticTemplateProperties : public ComponentType
+{
+  template< class T >
+  static auto Check( int )->decltype( T::TemplateProperties(), std::true_type() );
+
+  template< class >
+  static std::false_type Check( ... );
+
+public:
+
+  using Exists = decltype( Check< ComponentType >( 0 ) );
+
+  static ComponentPrototypeBase::TemplatePropertiesType Get()
+  {
+    return ComponentType::TemplateProperties();
+  }
+};
+
+template< class ComponentType >
+class ComponentPrototype : public ComponentPrototypeBase
+{
+public:
+
+  ComponentPrototype( std::size_t index ) : ComponentPrototypeBase( index ) {}
+
+  CriterionStatus CheckTemplateCriterion( const ComponentBase::CriterionType & criterion ) const override
+  {
+    return CheckTemplateCriterion( criterion, typename StaticTemplateProperties< ComponentType >::Exists() );
+  }
+
+
+  TemplatePropertiesType GetTemplateProperties() const override
+  {
+    return GetTemplateProperties( typename StaticTemplateProperties< ComponentType >::Exists() );
+  }
+
+
+  unsigned int CountAcceptingInterfaces( const ComponentBase::InterfaceCriteriaType & interfaceCriteria ) const override
+  {
+    return ComponentType::AcceptingInterfacesTypeList::CountMeetsCriteria( interfaceCriteria );
+  }
+
+
+  unsigned int CountProvidingInterfaces( const ComponentBase::InterfaceCriteriaType & interfaceCriteria ) const override
+  {
+    return ComponentType::ProvidingInterfacesTypeList::CountMeetsCriteria( interfaceCriteria );
+  }
+
+
+  InterfaceMaskType AcceptingInterfacesMask( const ComponentBase::InterfaceCriteriaType & interfaceCriteria ) const override
+  {
+    return InterfaceCriteriaMask< typename ComponentType::AcceptingInterfacesTypeList >::Get( interfaceCriteria );
+  }
+
+
+  ComponentBase::Pointer New( const std::string & name, LoggerImpl & logger ) const override
+  {
+    return std::make_shared< ComponentType >( name, logger );
+  }
+
+
+private:
+
+  static CriterionStatus CheckTemplateCriterion( const ComponentBase::CriterionType & criterion, std::true_type )
+  {
+    return CheckTemplateProperties( StaticTemplateProperties< ComponentType >::Get(), criterion );
+  }
+
+
+  // Components without static TemplateProperties can only be queried by MeetsCriterion
+  static CriterionStatus CheckTemplateCriterion( const ComponentBase::CriterionType &, std::false_type )
+  {
+    return CriterionStatus::Unknown;
+  }
+
+
+  static TemplatePropertiesType GetTemplateProperties( std::true_type )
+  {
+    return StaticTemplateProperties< ComponentType >::Get();
+  }
+
+
+  static TemplatePropertiesType GetTemplateProperties( std::false_type )
+  {
+    return TemplatePropertiesType();
+  }
+};
+
+template< typename >
+struct ComponentPrototypesFromTypeList;
+
+template< >
+struct ComponentPrototypesFromTypeList< TypeList< >>
+{
+  static std::list< ComponentPrototypeBase::ConstPointer > fill( std::list< ComponentPrototypeBase::ConstPointer > & prototypes )
+  {
+    return prototypes;
+  }
+};
+
+template< typename ComponentType, typename ... Rest >
+struct ComponentPrototypesFromTypeList< TypeList< ComponentType, Rest ... >>
+{
+  static std::list< ComponentPrototypeBase::ConstPointer > fill( std::list< ComponentPrototypeBase::ConstPointer > & prototypes )
+  {
+    prototypes.push_back( std::make_shared< ComponentPrototype< ComponentType >>( prototypes.size() ) );
+    return ComponentPrototypesFromTypeList< TypeList< Rest ... >>::fill( prototypes );
+  }
+};
+} // end namespace selx
+
+#endif // selxComponentPrototype_h
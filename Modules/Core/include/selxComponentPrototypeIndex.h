@@ -0,0 +1,82 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxComponentPrototypeIndex_h
+#define selxComponentPrototypeIndex_h
+
+#include "selxComponentPrototype.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace selx
+{
+/** \class ComponentPrototypeIndex
+ * \brief Looks up the component types of a component list by their template properties.
+ *
+ * Criteria on template properties, like NameOfClass, Dimensionality and PixelType, are decided by hash
+ * lookups in this index instead of by comparing the template properties of each component type. A
+ * component type that does not have the property cannot be decided by the index; its components are
+ * queried by MeetsCriterion, as for any other setting.
+ */
+class ComponentPrototypeIndex
+{
+public:
+
+  typedef std::list< ComponentPrototypeBase::ConstPointer > PrototypeListType;
+  typedef std::vector< std::size_t >                        PrototypeIndicesType;
+
+  /** The prototypes must be in the order of their index, see ComponentPrototypesFromTypeList */
+  ComponentPrototypeIndex( const PrototypeListType & prototypes );
+
+  std::size_t GetNumberOfPrototypes() const;
+
+  ComponentPrototypeBase::ConstPointer GetPrototype( std::size_t prototypeIndex ) const;
+
+  /** False if none of the component types has this template property */
+  bool IsTemplateProperty( const std::string & key ) const;
+
+  /** Same as ComponentPrototypeBase::CheckTemplateCriterion for the prototype at prototypeIndex */
+  CriterionStatus CheckTemplateCriterion( std::size_t prototypeIndex, const ComponentBase::CriterionType & criterion ) const;
+
+  /** The prototypes for which the criterion is Satisfied or Unknown, in ascending order. isUnknown is set
+   * to whether it is Unknown for any of them. */
+  PrototypeIndicesType FindCandidates( const ComponentBase::CriterionType & criterion, bool & isUnknown ) const;
+
+private:
+
+  struct PropertyIndex
+  {
+    // Per prototype the position of its value in values, or -1 if it does not have the property
+    std::vector< int >                     valueOfPrototype;
+    std::unordered_map< std::string, int > values;
+    std::vector< PrototypeIndicesType >    prototypesByValue;
+    PrototypeIndicesType                   prototypesWithoutProperty;
+  };
+
+  const PropertyIndex * FindPropertyIndex( const ComponentBase::CriterionType & criterion ) const;
+
+  std::vector< ComponentPrototypeBase::ConstPointer >  m_Prototypes;
+  std::unordered_map< std::string, PropertyIndex >     m_PropertyIndices;
+};
+} // end namespace selx
+
+#endif // selxComponentPrototypeIndex_h
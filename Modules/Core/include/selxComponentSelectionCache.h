@@ -0,0 +1,67 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxComponentSelectionCache_h
+#define selxComponentSelectionCache_h
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace selx
+{
+/** \class ComponentSelectionCache
+ * \brief Remembers which component type was selected for each node of a blueprint.
+ *
+ * The key is the canonical description of the blueprint (BlueprintImpl::GetCanonicalDescription), such
+ * that blueprints with equal content share an entry, regardless of the order in which their components
+ * and connections were set. A selection maps each component name to the index of the selected
+ * component type in the component list of the NetworkBuilder, so a cache must not be shared between
+ * component lists.
+ *
+ * The cache is thread-safe. When it is full, an arbitrary entry is evicted.
+ */
+class ComponentSelectionCache
+{
+public:
+
+  typedef std::map< std::string, std::size_t > SelectionType;
+
+  ComponentSelectionCache( std::size_t maximumNumberOfEntries = 1024 );
+
+  /** Returns true and sets the selection if the blueprint description is in the cache */
+  bool Find( const std::string & blueprintDescription, SelectionType & selection ) const;
+
+  void Insert( const std::string & blueprintDescription, const SelectionType & selection );
+
+  void Clear();
+
+  std::size_t GetNumberOfEntries() const;
+
+private:
+
+  mutable std::mutex                                 m_Mutex;
+  std::unordered_map< std::string, SelectionType > m_Selections;
+  const std::size_t                                  m_MaximumNumberOfEntries;
+};
+} // end namespace selx
+
+#endif // selxComponentSelectionCache_h
@@ -21,6 +21,9 @@
 
 #include "itkObjectFactory.h"
 #include "selxComponentBase.h"
+#include "selxComponentPrototype.h"
+#include "selxComponentPrototypeIndex.h"
+#include "selxInterfaceCompatibilityTable.h"
 #include "selxLogger.h"
 #include "selxTypeList.h"
 
@@ -28,6 +31,12 @@ namespace selx
 {
 /** \class ComponentSelector
  * \brief A Component factory that accepts criteria, possibly in multiple passes, to construct and return the right Component
+ *
+ * Criteria that can be decided from the static description of a component type (template
+ * properties and interfaces) are applied to prototypes. Template properties are looked up in a
+ * ComponentPrototypeIndex that is shared by all selectors of a component list, such that selecting
+ * e.g. by NameOfClass does not compare every component type. The remaining candidates are only
+ * constructed when a query requires component objects, see Realize().
  */
 
 template< class ComponentList >
@@ -48,10 +57,19 @@ public:
 
   typedef std::list< ComponentBasePointer > ComponentListType;
   typedef ComponentListType::size_type      NumberOfComponentsType;
+
+  typedef std::list< ComponentPrototypeBase::ConstPointer > PrototypeListType;
+  typedef std::vector< CriterionType >                      CriterionListType;
+
+  typedef InterfaceCompatibilityTable< ComponentList > InterfaceCompatibilityTableType;
   /** set selection criteria for possibleComponents*/
 
   ComponentSelector( const std::string & name, LoggerImpl & logger );
 
+  /** Start with a single candidate, the component type at prototypeIndex in the component list, e.g. to
+   * restore a selection that was made before for the same configuration. */
+  ComponentSelector( const std::string & name, LoggerImpl & logger, std::size_t prototypeIndex );
+
   /** Narrow selection criteria*/
   void AddCriterion( const CriterionType & criterion );
 
@@ -61,27 +79,60 @@ public:
 
   unsigned int NumberOfComponents( void );
 
-  unsigned int RequireAcceptingInterfaceFrom( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria );
+  /** Number of candidates that are left by the criteria that could be checked without constructing components */
+  unsigned int NumberOfCandidates( void ) const;
 
-  unsigned int RequireProvidingInterfaceTo( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria );
+  /** Number of component objects that were constructed by this selector */
+  unsigned int NumberOfConstructedComponents( void ) const;
+
+  /** Handshake requirements are decided by the InterfaceCompatibilityTable between the component types; the
+   * prototype of the other side is the one that remains in its own selector, see GetPrototype(). */
+  unsigned int RequireAcceptingInterfaceFrom( ComponentPrototypeBase::ConstPointer other, const InterfaceCriteriaType & interfaceCriteria );
+
+  unsigned int RequireProvidingInterfaceTo( ComponentPrototypeBase::ConstPointer other, const InterfaceCriteriaType & interfaceCriteria );
 
   /** Return Component or Nullptr*/
   ComponentBasePointer GetComponent( void );
 
+  /** Return the prototype of the only remaining candidate or Nullptr. Does not construct components, so the settings
+   * that only components can check may still reject it. */
+  ComponentPrototypeBase::ConstPointer GetPrototype( void );
+
   void PrintComponents( void );
 
 protected:
 
-  ComponentListType m_PossibleComponents;
+  /** Construct the remaining candidates and apply the criteria that were deferred until then */
+  void Realize( void );
+
+  /** Prototypes are stateless, so one index per component list is shared by all selectors */
+  static const ComponentPrototypeIndex & GetPrototypeIndex( void );
+
+  // A candidate keeps the prototype it was selected by; its component is constructed by Realize()
+  struct Candidate
+  {
+    ComponentPrototypeBase::ConstPointer Prototype;
+    ComponentBasePointer                 Component;
+  };
+  typedef std::list< Candidate > CandidateListType;
+
+  CandidateListType m_Candidates;
+  CriterionListType m_DeferredCriteria;
+
+  // The NumberOfThreads setting, passed on to the components that are constructed
+  unsigned int m_MaximumNumberOfThreads;
+
+  bool         m_IsRealized;
+  unsigned int m_NumberOfConstructedComponents;
+
+  const std::string m_Name;
+  LoggerImpl &      m_Logger;
 
 private:
 
   ComponentSelector( const Self & ); //purposely not implemented
   void operator=( const Self & );    //purposely not implemented
 };
-
-template< typename >
-struct ContructComponentsFromTypeList;
 } // end namespace selx
 
 #ifndef ITK_MANUAL_INSTANTIATION
@@ -20,37 +20,52 @@
 #define selxComponentSelector_hxx
 
 #include "selxComponentSelector.h"
+#include "selxKeys.h"
+
+#include <stdexcept>
 
 namespace selx
 {
-template< >
-struct ContructComponentsFromTypeList< TypeList< >>
+template< class ComponentList >
+ComponentSelector< ComponentList >::ComponentSelector( const std::string & name, LoggerImpl & logger ) :
+  m_IsRealized( false ),
+  m_MaximumNumberOfThreads( 0 ),
+  m_NumberOfConstructedComponents( 0 ),
+  m_Name( name ),
+  m_Logger( logger )
 {
-  static std::list< ComponentBase::Pointer > fill( std::list< ComponentBase::Pointer > & components,
-    const std::string & name,
-    LoggerImpl & logger )
+  const ComponentPrototypeIndex & prototypeIndex = GetPrototypeIndex();
+  for( std::size_t index = 0; index < prototypeIndex.GetNumberOfPrototypes(); ++index )
   {
-    return components;
+    this->m_Candidates.push_back( { prototypeIndex.GetPrototype( index ), nullptr } );
   }
-};
+}
 
-template< typename ComponentType, typename ... Rest >
-struct ContructComponentsFromTypeList< TypeList< ComponentType, Rest ... >>
+
+template< class ComponentList >
+ComponentSelector< ComponentList >::ComponentSelector( const std::string & name, LoggerImpl & logger, std::size_t prototypeIndex ) :
+  m_IsRealized( false ),
+  m_MaximumNumberOfThreads( 0 ),
+  m_NumberOfConstructedComponents( 0 ),
+  m_Name( name ),
+  m_Logger( logger )
 {
-  static std::list< ComponentBase::Pointer > fill( std::list< ComponentBase::Pointer > & components,
-    const std::string & name,
-    LoggerImpl & logger )
+  if( prototypeIndex < GetPrototypeIndex().GetNumberOfPrototypes() )
   {
-    components.push_back( std::make_shared< ComponentType >( name, logger ) );
-    return ContructComponentsFromTypeList< TypeList< Rest ... >>::fill( components, name, logger );
+    this->m_Candidates.push_back( { GetPrototypeIndex().GetPrototype( prototypeIndex ), nullptr } );
   }
-};
+}
+
 
 template< class ComponentList >
-ComponentSelector< ComponentList >::ComponentSelector( const std::string & name, LoggerImpl & logger )
+const ComponentPrototypeIndex &
+ComponentSelector< ComponentList >::GetPrototypeIndex()
 {
-  m_PossibleComponents = std::list< ComponentBase::Pointer >();
-  m_PossibleComponents = ContructComponentsFromTypeList< ComponentList >::fill( m_PossibleComponents, name, logger );
+  static const ComponentPrototypeIndex prototypeIndex( [](){
+      PrototypeListType list;
+      return ComponentPrototypesFromTypeList< ComponentList >::fill( list );
+    } () );
+  return prototypeIndex;
 }
 
 
@@ -58,9 +73,74 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::AddCriterion( const CriterionType & criterion )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      return !component->MeetsCriterion( criterion );
-    } );
+  // Every component has a NumberOfThreads setting, which is handled here instead of by each MeetsCriterion
+  if( criterion.first == keys::NumberOfThreads )
+  {
+    if( criterion.second.size() != 1 || criterion.second[ 0 ].empty()
+      || criterion.second[ 0 ].find_first_not_of( "0123456789" ) != std::string::npos )
+    {
+      throw std::runtime_error( "The criterion " + criterion.first + " must have 1 value, a non-negative integer" );
+    }
+    this->m_MaximumNumberOfThreads = std::stoul( criterion.second[ 0 ] );
+    for( const auto & candidate : this->m_Candidates )
+    {
+      if( candidate.Component )
+      {
+        candidate.Component->SetMaximumNumberOfThreads( this->m_MaximumNumberOfThreads );
+      }
+    }
+    return;
+  }
+
+  if( this->m_IsRealized )
+  {
+    this->m_Candidates.remove_if([ & ]( const Candidate & candidate ){
+        return !candidate.Component->MeetsCriterion( criterion );
+      } );
+    return;
+  }
+
+  const ComponentPrototypeIndex & prototypeIndex = GetPrototypeIndex();
+
+  // A setting that is not a template property of any component type can only be checked (and stored) by
+  // a component object.
+  if( !prototypeIndex.IsTemplateProperty( criterion.first ) )
+  {
+    if( !this->m_Candidates.empty() )
+    {
+      this->m_DeferredCriteria.push_back( criterion );
+    }
+    return;
+  }
+
+  // Template properties are looked up in the index. If any remaining candidate does not have the
+  // property, the criterion is deferred for that candidate as well.
+  bool isDeferred = false;
+  if( this->m_Candidates.size() == prototypeIndex.GetNumberOfPrototypes() )
+  {
+    // No criteria were applied yet, so the candidates are exactly the ones found in the index
+    this->m_Candidates.clear();
+    for( const auto index : prototypeIndex.FindCandidates( criterion, isDeferred ) )
+    {
+      this->m_Candidates.push_back( { prototypeIndex.GetPrototype( index ), nullptr } );
+    }
+  }
+  else
+  {
+    this->m_Candidates.remove_if([ & ]( const Candidate & candidate ){
+        const CriterionStatus status = prototypeIndex.CheckTemplateCriterion( candidate.Prototype->GetIndex(), criterion );
+        if( status == CriterionStatus::Unknown )
+        {
+          isDeferred = true;
+        }
+        return status == CriterionStatus::Failed;
+      } );
+  }
+
+  if( isDeferred )
+  {
+    this->m_DeferredCriteria.push_back( criterion );
+  }
 }
 
 
@@ -68,8 +148,8 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::AddAcceptingInterfaceCriteria( const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      return 0 == component->CountAcceptingInterfaces( interfaceCriteria );
+  this->m_Candidates.remove_if([ & ]( const Candidate & candidate ){
+      return 0 == candidate.Prototype->CountAcceptingInterfaces( interfaceCriteria );
     } );
 }
 
@@ -78,19 +158,54 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::AddProvidingInterfaceCriteria( const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      return 0 == component->CountProvidingInterfaces( interfaceCriteria );
+  this->m_Candidates.remove_if([ & ]( const Candidate & candidate ){
+      return 0 == candidate.Prototype->CountProvidingInterfaces( interfaceCriteria );
+    } );
+}
+
+
+template< class ComponentList >
+void
+ComponentSelector< ComponentList >::Realize()
+{
+  if( this->m_IsRealized )
+  {
+    return;
+  }
+
+  this->m_Candidates.remove_if([ & ]( Candidate & candidate ){
+      candidate.Component = candidate.Prototype->New( this->m_Name, this->m_Logger );
+      candidate.Component->SetMaximumNumberOfThreads( this->m_MaximumNumberOfThreads );
+      ++this->m_NumberOfConstructedComponents;
+
+      // Settings are applied in the order in which they were added, as if the component had existed all along.
+      for( const auto & criterion : this->m_DeferredCriteria )
+      {
+        if( !candidate.Component->MeetsCriterion( criterion ) )
+        {
+          return true;
+        }
+      }
+      return false;
     } );
+
+  this->m_Logger.Log( LogLevel::TRC, "Constructed {0} component(s) for {1}, {2} of which satisfy all criteria.",
+    this->m_NumberOfConstructedComponents, this->m_Name, this->m_Candidates.size() );
+
+  this->m_DeferredCriteria.clear();
+  this->m_IsRealized = true;
 }
 
 
 // CompatibleInterfaces
 template< class ComponentList >
 unsigned int
-ComponentSelector< ComponentList >::RequireAcceptingInterfaceFrom( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria )
+ComponentSelector< ComponentList >::RequireAcceptingInterfaceFrom( ComponentPrototypeBase::ConstPointer other,
+  const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      auto status = component->CanAcceptConnectionFrom( other, interfaceCriteria );
+  this->m_Candidates.remove_if([ & ]( const Candidate & candidate ){
+      auto status = InterfaceCompatibilityTableType::CanAcceptConnectionFrom( candidate.Prototype->GetIndex(), other->GetIndex(),
+      candidate.Prototype->AcceptingInterfacesMask( interfaceCriteria ) );
       return status == InterfaceStatus::noaccepter || status == InterfaceStatus::noprovider;
     } );
   return 0;
@@ -99,10 +214,14 @@ ComponentSelector< ComponentList >::RequireAcceptingInterfaceFrom( ComponentBase
 
 template< class ComponentList >
 unsigned int
-ComponentSelector< ComponentList >::RequireProvidingInterfaceTo( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria )
+ComponentSelector< ComponentList >::RequireProvidingInterfaceTo( ComponentPrototypeBase::ConstPointer other,
+  const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      auto status = other->CanAcceptConnectionFrom( component, interfaceCriteria );
+  // The accepting interfaces of the other side that meet the criteria are the same for all candidates
+  const InterfaceMaskType criteriaMask = other->AcceptingInterfacesMask( interfaceCriteria );
+  this->m_Candidates.remove_if([ & ]( const Candidate & candidate ){
+      auto status = InterfaceCompatibilityTableType::CanAcceptConnectionFrom( other->GetIndex(), candidate.Prototype->GetIndex(),
+      criteriaMask );
       return status == InterfaceStatus::noaccepter || status == InterfaceStatus::noprovider;
     } );
   return 0;
@@ -115,10 +234,26 @@ ComponentSelector< ComponentList >::GetComponent()
 {
   //TODO check if Modified
   //this->UpdatePossibleComponents();
+  this->Realize();
 
-  if( this->m_PossibleComponents.size() == 1 )
+  if( this->m_Candidates.size() == 1 )
   {
-    return *( this->m_PossibleComponents.begin() );
+    return this->m_Candidates.begin()->Component;
+  }
+  else
+  {
+    return ITK_NULLPTR;
+  }
+}
+
+
+template< class ComponentList >
+ComponentPrototypeBase::ConstPointer
+ComponentSelector< ComponentList >::GetPrototype()
+{
+  if( this->m_Candidates.size() == 1 )
+  {
+    return this->m_Candidates.begin()->Prototype;
   }
   else
   {
@@ -131,7 +266,24 @@ template< class ComponentList >
 unsigned int
 ComponentSelector< ComponentList >::NumberOfComponents()
 {
-  return this->m_PossibleComponents.size();
+  this->Realize();
+  return this->m_Candidates.size();
+}
+
+
+template< class ComponentList >
+unsigned int
+ComponentSelector< ComponentList >::NumberOfCandidates() const
+{
+  return this->m_Candidates.size();
+}
+
+
+template< class ComponentList >
+unsigned int
+ComponentSelector< ComponentList >::NumberOfConstructedComponents() const
+{
+  return this->m_NumberOfConstructedComponents;
 }
 
 
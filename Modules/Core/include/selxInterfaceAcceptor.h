@@ -35,7 +35,10 @@ public:
 
   using Pointer = std::shared_ptr< InterfaceAcceptor< InterfaceT >>;
   // Accept() is called by a succesfull Connect()
-  // The implementation of Accept() must be provided by component developers.
+  // The implementation of Accept() must be provided by component developers. Accept() must only record
+  // the connection, e.g. store the interface or connect itk pipelines, and may query meta data such as
+  // image geometry. Data must not be computed or read: this happens when the network is executed, by
+  // the UpdateInterface of the components.
   virtual int Accept( typename InterfaceT::Pointer ) = 0;
 
   // Connect tries to connect this accepting interface with all interfaces of the provider component.
@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxInterfaceCompatibilityTable_h
+#define selxInterfaceCompatibilityTable_h
+
+#include "selxComponentBase.h"
+#include "selxAccepting.h"
+#include "selxCount.h"
+#include "selxInterfaceStatus.h"
+#include "selxTypeList.h"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace selx
+{
+// A bit for each accepting interface of a component, in the order of its Accepting< ... > arguments.
+using InterfaceMaskType = std::uint64_t;
+
+// helper class to compute, at compile time, which accepting interfaces of a component are provided by another component
+template< typename AcceptingInterfaces, typename ProvidingComponent >
+struct ProvidedInterfaceMask;
+
+template< typename ... Interfaces, typename ProvidingComponent >
+struct ProvidedInterfaceMask< Accepting< Interfaces ... >, ProvidingComponent >
+{
+  static_assert( sizeof ... ( Interfaces ) <= 64, "InterfaceMaskType holds at most 64 accepting interfaces" );
+
+  static constexpr InterfaceMaskType Get()
+  {
+    // The handshake (InterfaceAcceptor::Connect) succeeds if the providing component derives from the accepting interface.
+    const bool isProvided[] = { false, std::is_base_of< Interfaces, ProvidingComponent >::value ... };
+    InterfaceMaskType mask = 0;
+    for( std::size_t index = 0; index < sizeof ... ( Interfaces ); ++index )
+    {
+      if( isProvided[ index + 1 ] )
+      {
+        mask |= InterfaceMaskType( 1 ) << index;
+      }
+    }
+    return mask;
+  }
+};
+
+// helper class to find which accepting interfaces of a component meet the interface criteria of a connection
+template< typename AcceptingInterfaces >
+struct InterfaceCriteriaMask;
+
+template< typename ... Interfaces >
+struct InterfaceCriteriaMask< Accepting< Interfaces ... >>
+{
+  static InterfaceMaskType Get( const ComponentBase::InterfaceCriteriaType & interfaceCriteria )
+  {
+    const unsigned int meetsCriteria[] = { 0, Count< Interfaces >::MeetsCriteria( interfaceCriteria ) ... };
+    InterfaceMaskType mask = 0;
+    for( std::size_t index = 0; index < sizeof ... ( Interfaces ); ++index )
+    {
+      if( meetsCriteria[ index + 1 ] == 1 )
+      {
+        mask |= InterfaceMaskType( 1 ) << index;
+      }
+    }
+    return mask;
+  }
+};
+
+/** \class InterfaceCompatibilityTable
+ * \brief Adjacency table over a component type list that records for each pair of component types
+ * (A, B) which accepting interfaces of A can bind to B.
+ *
+ * The table is built at compile time. Together with the mask of interfaces meeting the connection
+ * criteria, a handshake between two component types is decided by a bitwise intersection instead of
+ * dynamic casts between constructed components.
+ */
+template< typename ComponentList >
+struct InterfaceCompatibilityTable;
+
+template< typename ... Components >
+struct InterfaceCompatibilityTable< TypeList< Components ... >>
+{
+  static constexpr std::size_t NumberOfComponents = sizeof ... ( Components );
+
+  using RowType   = std::array< InterfaceMaskType, NumberOfComponents >;
+  using TableType = std::array< RowType, NumberOfComponents >;
+
+  template< typename AcceptingComponent >
+  static constexpr RowType GetRow()
+  {
+    return RowType{ { ProvidedInterfaceMask< typename AcceptingComponent::AcceptingInterfacesTypeList, Components >::Get() ... } };
+  }
+
+
+  static InterfaceMaskType Get( const std::size_t acceptingIndex, const std::size_t providingIndex )
+  {
+    static constexpr TableType table = { { GetRow< Components >() ... } };
+    return table[ acceptingIndex ][ providingIndex ];
+  }
+
+
+  /** Equivalent to ComponentBase::CanAcceptConnectionFrom, given the mask of accepting interfaces meeting the criteria */
+  static InterfaceStatus CanAcceptConnectionFrom( const std::size_t acceptingIndex, const std::size_t providingIndex,
+    const InterfaceMaskType criteriaMask )
+  {
+    if( criteriaMask == 0 )
+    {
+      return InterfaceStatus::noaccepter;
+    }
+    const InterfaceMaskType compatibleMask = criteriaMask & Get( acceptingIndex, providingIndex );
+    if( compatibleMask == 0 )
+    {
+      return InterfaceStatus::noprovider;
+    }
+    // more than 1 bit set
+    if( ( compatibleMask & ( compatibleMask - 1 ) ) != 0 )
+    {
+      return InterfaceStatus::multiple;
+    }
+    return InterfaceStatus::success;
+  }
+};
+
+template< >
+struct InterfaceCompatibilityTable< TypeList< >>
+{
+  static constexpr std::size_t NumberOfComponents = 0;
+
+  static InterfaceStatus CanAcceptConnectionFrom( const std::size_t, const std::size_t, const InterfaceMaskType )
+  {
+    return InterfaceStatus::noaccepter;
+  }
+};
+} // end namespace selx
+
+#endif // selxInterfaceCompatibilityTable_h
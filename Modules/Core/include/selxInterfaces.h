@@ -61,6 +61,18 @@ public:
 
   virtual DataObjectPointer GetInitializedOutput( void ) = 0;
 
+  // Generates the part of the mini pipeline output that is requested by the output of the SuperElastixFilter,
+  // such that image outputs can be streamed, e.g. a slab by a streaming writer. Returns whether the whole output
+  // has been generated. Sinks of images copy the requested region of requestedOutput to their mini pipeline output:
+  // an output of which no region was requested yet has an empty requested region, which Update sets to the largest
+  // possible region. By default the whole output is generated, which is what Sinks of data without regions
+  // (e.g. transforms) do.
+  virtual bool UpdateMiniPipelineOutput( DataObjectPointer requestedOutput )
+  {
+    this->GetMiniPipelineOutput()->Update();
+    return true;
+  }
+
   // GetComponentName is implemented in the SuperElastixComponent class and does not need to be implemented by each component individually.
   virtual std::string GetComponentName() const = 0;
 };
@@ -81,6 +93,23 @@ public:
   // connections in the network has been set.
   virtual void BeforeUpdate() {};
 
+  // This interface is run once the component and all components downstream
+  // of it that are updated by the network have been updated. Components can
+  // release bulk data they only needed to compute their results, such as
+  // intensity rescaled copies of their inputs. Results that are pulled after
+  // the network has been updated, e.g. by the itk pipelines of the Sinks,
+  // must be kept. The network may be updated again (batch mode).
+  virtual void ReleaseData() {};
+
+  // These interfaces are used to memoize the results of the component on disk,
+  // see NetworkContainer::SetMemoizationCache. WriteResults is run after Update
+  // and writes the results the component provides into the directory.
+  // ReadResults restores them instead of running Update. Both return false if
+  // the component does not support memoization.
+  virtual bool WriteResults( const std::string & directory ) { return false; };
+
+  virtual bool ReadResults( const std::string & directory ) { return false; };
+
   // GetComponentName is implemented in the SuperElastixComponent class and does not need to be implemented by each component individually.
   virtual std::string GetComponentName() const = 0;
 };
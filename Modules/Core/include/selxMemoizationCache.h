@@ -0,0 +1,72 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxMemoizationCache_h
+#define selxMemoizationCache_h
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace selx
+{
+/** \class MemoizationCache
+ * \brief Stores the results of components on disk, such that a network that is executed again with
+ * the same settings and inputs can read them instead of recomputing them.
+ *
+ * Results are stored in a directory per key, below the directory of the cache. A key is the hash of
+ * everything the results depend on. A directory is first written under a temporary name and renamed
+ * when it is complete, so the results of a process that was killed while writing are never found.
+ *
+ * The cache can be shared by concurrent processes and threads.
+ */
+class MemoizationCache
+{
+public:
+
+  using Pointer = std::shared_ptr< MemoizationCache >;
+
+  /** Creates the directory if it does not exist */
+  MemoizationCache( const std::string & directory );
+
+  const std::string & GetDirectory() const;
+
+  /** The directory with the results stored for the key, or an empty string if there are none */
+  std::string Find( const std::string & key ) const;
+
+  /** Calls write with a new, empty directory. If write returns true, the directory is stored as the results
+   * for the key, otherwise it is removed. Returns whether the results were stored. */
+  bool Store( const std::string & key, const std::function< bool( const std::string & directory ) > & write );
+
+  /** Removes the results stored for the key, e.g. when they cannot be read */
+  void Remove( const std::string & key );
+
+  /** Hexadecimal SHA-1 of the data */
+  static std::string Hash( const std::string & data );
+
+  /** Hexadecimal SHA-1 of the content of the file. Throws if the file cannot be read. */
+  static std::string HashFile( const std::string & fileName );
+
+private:
+
+  const std::string m_Directory;
+};
+} // end namespace selx
+
+#endif // selxMemoizationCache_h
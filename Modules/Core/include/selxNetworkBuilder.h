@@ -34,6 +34,7 @@
 
 #include "selxLoggerImpl.h"
 #include "selxBlueprintImpl.h"
+#include "selxComponentSelectionCache.h"
 #include "selxNetworkContainer.h"
 #include "selxInterfaces.h"
 #include "selxInterfaceTraits.h"
@@ -64,6 +65,11 @@ public:
   /** Read configuration at the blueprints nodes and edges and return true if all components could be uniquely selected*/
   virtual bool Configure();
 
+  virtual ComponentSelectionCache::SelectionType GetSelection();
+
+  virtual void SetPreviousSelection( const ComponentSelectionCache::SelectionType & selection,
+    const ComponentNamesType & modifiedComponentNames );
+
   /** if all components are uniquely selected, they can be connected */
   virtual bool ConnectComponents();
 
@@ -81,6 +87,18 @@ public:
 
   virtual SinkInterface::DataObjectPointer GetInitializedOutput( const NetworkBuilderBase::ComponentNameType & );
 
+  /** Selections of previously configured blueprints, shared by all NetworkBuilders of this component list in the process */
+  static ComponentSelectionCache & GetSelectionCache();
+
+  /** True if Configure() restored the selection from the cache instead of applying all criteria */
+  bool IsConfiguredFromCache() const { return this->m_isConfiguredFromCache; }
+
+  /** The components that Configure() selected from all component types, after SetPreviousSelection */
+  const ComponentNamesType & GetReselectedComponentNames() const { return this->m_ReselectedComponentNames; }
+
+  /** The number of component objects that were constructed to select the component of a node */
+  unsigned int GetNumberOfConstructedComponents( const ComponentNameType & componentName ) const;
+
 protected:
 
   typedef ComponentBase::CriteriaType       CriteriaType;
@@ -96,15 +114,40 @@ protected:
   /** Read configuration at the blueprints nodes and try to find instantiated components */
   virtual void ApplyComponentConfiguration();
 
+  void ApplyComponentConfiguration( const ComponentNamesType & componentNames );
+
   /** Read configuration at the blueprints edges and try to find instantiated components */
   virtual void ApplyConnectionConfiguration();
 
+  /** Only the connections from or to these components */
+  void ApplyConnectionConfiguration( const ComponentNamesType & componentNames );
+
   /** For all uniquely selected components test handshake to non-uniquely selected components */
   virtual void PropagateConnectionsWithUniqueComponents();
 
+  /** Construct the candidates that are left at these nodes and check the settings that only components can check.
+   * Throws if no candidate meets them. */
+  void RealizeComponents( const ComponentNamesType & componentNames );
+
+  /** Create a selector for each node that starts with the cached component type and apply the node criteria.
+   * Returns false, leaving no selectors, if the selection does not fit the blueprint. */
+  bool ApplyCachedSelection( const ComponentSelectionCache::SelectionType & selection );
+
+  /** Create a selector that starts with the component type at prototypeIndex and apply the node criteria.
+   * Returns nullptr if the component type does not meet the criteria. */
+  ComponentSelectorPointer RestoreComponentSelector( const ComponentNameType & componentName, std::size_t prototypeIndex );
+
+  /** Restore the previous selection of the components that were not modified and are not connected to
+   * modified ones, and select the others as in a full configuration. Returns false, leaving no selectors,
+   * if the previous selection does not fit the blueprint. */
+  bool ApplyPreviousSelection();
+
   /** See which components need more configuration criteria */
   virtual ComponentNamesType GetNonUniqueComponentNames();
 
+  /** All components from which data flows, directly or indirectly, into the component */
+  ComponentNamesType GetUpstreamComponentNames( const ComponentNameType & componentName ) const;
+
   void Cite();
 
   //TODO make const correct
@@ -115,6 +158,10 @@ protected:
   // A selector for each node, that each can hold multiple instantiated components. Ultimately is should be 1 component each.
   ComponentSelectorContainerType  m_ComponentSelectorContainer;
   bool                            m_isConfigured;
+  bool                            m_isConfiguredFromCache;
+  ComponentSelectionCache::SelectionType m_PreviousSelection;
+  ComponentNamesType                     m_ModifiedComponentNames;
+  ComponentNamesType                     m_ReselectedComponentNames;
   LoggerImpl &                    m_Logger;
   const BlueprintImpl &                 m_Blueprint;
 
@@ -25,11 +25,20 @@
 namespace selx
 {
 template< typename ComponentList >
-NetworkBuilder< ComponentList >::NetworkBuilder( LoggerImpl & logger, const BlueprintImpl & blueprint ) : m_Logger( logger ), m_isConfigured( false ), m_Blueprint( blueprint )
+NetworkBuilder< ComponentList >::NetworkBuilder( LoggerImpl & logger, const BlueprintImpl & blueprint ) : m_Logger( logger ), m_isConfigured( false ), m_isConfiguredFromCache( false ), m_Blueprint( blueprint )
 {
 }
 
 
+template< typename ComponentList >
+ComponentSelectionCache &
+NetworkBuilder< ComponentList >::GetSelectionCache()
+{
+  static ComponentSelectionCache selectionCache;
+  return selectionCache;
+}
+
+
 template< typename ComponentList >
 bool
 NetworkBuilder< ComponentList >::AddBlueprint( const BlueprintImpl & blueprint )
@@ -51,8 +60,39 @@ NetworkBuilder< ComponentList >::Configure()
   // - ApplyNodeConfiguration()
   // - ApplyConnectionConfiguration()
   // - PropagateConnectionsWithUniqueComponents();
+  // If a blueprint with the same content was configured before, the selection is restored from the
+  // selection cache and only the node criteria are applied, to the selected component types.
+  // Otherwise, if the selection of an earlier version of the blueprint was set by SetPreviousSelection,
+  // only the modified components and their neighbors are selected from all component types.
+
+  const std::string blueprintDescription = this->m_isConfigured ? std::string() : this->m_Blueprint.GetCanonicalDescription();
+  ComponentSelectionCache::SelectionType cachedSelection;
+  if( !this->m_isConfigured && GetSelectionCache().Find( blueprintDescription, cachedSelection ) )
+  {
+    this->m_Logger.Log( LogLevel::INF, "Applying cached component selection ... " );
+    this->m_isConfiguredFromCache = this->ApplyCachedSelection( cachedSelection );
+    this->m_isConfigured = this->m_isConfiguredFromCache;
+    this->m_Logger.Log( LogLevel::INF, this->m_isConfiguredFromCache ? "Applying cached component selection ... Done"
+                                                                      : "Applying cached component selection ... Failed, selecting from all components" );
+  }
 
-  if( !this->m_isConfigured )
+  bool isSelected = false;
+  if( !this->m_isConfigured && !this->m_PreviousSelection.empty() )
+  {
+    this->m_Logger.Log( LogLevel::INF, "Reselecting modified components ... " );
+    isSelected = this->ApplyPreviousSelection();
+    if( isSelected )
+    {
+      this->m_Logger.Log( LogLevel::INF, "Reselecting modified components ... Done. Reselected {0:d} out of {1:d} components.",
+                          this->m_ReselectedComponentNames.size(), m_Blueprint.GetComponentNames().size() );
+    }
+    else
+    {
+      this->m_Logger.Log( LogLevel::INF, "Reselecting modified components ... Failed, selecting from all components" );
+    }
+  }
+
+  if( !this->m_isConfigured && !isSelected )
   {
     this->m_Logger.Log( LogLevel::INF, "Applying component criteria ... " );
     this->ApplyComponentConfiguration();
@@ -80,7 +120,17 @@ NetworkBuilder< ComponentList >::Configure()
                            m_Blueprint.GetComponentNames().size()-nonUniqueComponentNames.size(),
                            m_Blueprint.GetComponentNames().size() );
     }
+
+    this->RealizeComponents( m_Blueprint.GetComponentNames() );
+  }
+
+  if( !this->m_isConfigured )
+  {
     this->m_isConfigured = true;
+    if( this->GetNonUniqueComponentNames().empty() )
+    {
+      GetSelectionCache().Insert( blueprintDescription, this->GetSelection() );
+    }
   }
 
   auto nonUniqueComponentNames = this->GetNonUniqueComponentNames();
@@ -96,6 +146,171 @@ NetworkBuilder< ComponentList >::Configure()
 }
 
 
+template< typename ComponentList >
+ComponentSelectionCache::SelectionType
+NetworkBuilder< ComponentList >::GetSelection()
+{
+  ComponentSelectionCache::SelectionType selection;
+  for( const auto & componentSelector : this->m_ComponentSelectorContainer )
+  {
+    auto prototype = componentSelector.second->GetPrototype();
+    if( prototype )
+    {
+      selection[ componentSelector.first ] = prototype->GetIndex();
+    }
+  }
+  return selection;
+}
+
+
+template< typename ComponentList >
+void
+NetworkBuilder< ComponentList >::SetPreviousSelection( const ComponentSelectionCache::SelectionType & selection,
+  const ComponentNamesType & modifiedComponentNames )
+{
+  this->m_PreviousSelection      = selection;
+  this->m_ModifiedComponentNames = modifiedComponentNames;
+}
+
+
+template< typename ComponentList >
+bool
+NetworkBuilder< ComponentList >::ApplyCachedSelection( const ComponentSelectionCache::SelectionType & selection )
+{
+  const BlueprintImpl::ComponentNamesType componentNames = this->m_Blueprint.GetComponentNames();
+  if( selection.size() != componentNames.size() )
+  {
+    return false;
+  }
+
+  for( auto const & componentName : componentNames )
+  {
+    const auto selected = selection.find( componentName );
+    ComponentSelectorPointer componentSelector = selected == selection.end() ? nullptr : this->RestoreComponentSelector( componentName, selected->second );
+    if( !componentSelector )
+    {
+      this->m_ComponentSelectorContainer.clear();
+      return false;
+    }
+    this->m_ComponentSelectorContainer[ componentName ] = componentSelector;
+  }
+  return true;
+}
+
+
+template< typename ComponentList >
+typename NetworkBuilder< ComponentList >::ComponentSelectorPointer
+NetworkBuilder< ComponentList >::RestoreComponentSelector( const ComponentNameType & componentName, std::size_t prototypeIndex )
+{
+  // The connection criteria and handshakes only narrowed the selection to this component type, but the
+  // node criteria include the settings that have to be passed to the component.
+  ComponentSelectorPointer componentSelector = std::make_shared< ComponentSelectorType >( componentName, this->m_Logger, prototypeIndex );
+  for( auto const & criterion : this->m_Blueprint.GetComponent( componentName ) )
+  {
+    componentSelector->AddCriterion( criterion );
+  }
+
+  if( componentSelector->NumberOfComponents() != 1 )
+  {
+    return nullptr;
+  }
+  return componentSelector;
+}
+
+
+template< typename ComponentList >
+bool
+NetworkBuilder< ComponentList >::ApplyPreviousSelection()
+{
+  // Deleting a component is not tracked by the blueprint, so the neighbors it had are unknown
+  for( const auto & previouslySelected : this->m_PreviousSelection )
+  {
+    if( !this->m_Blueprint.ComponentExists( previouslySelected.first ) )
+    {
+      return false;
+    }
+  }
+
+  // A modified component may need another component type, which may change the types its neighbors need
+  const BlueprintImpl::ComponentNamesType componentNames = this->m_Blueprint.GetComponentNames();
+  ComponentNamesType reselectedComponentNames;
+  auto reselect = [ &reselectedComponentNames ]( const ComponentNamesType & names ) {
+      for( const auto & name : names )
+      {
+        if( std::find( reselectedComponentNames.begin(), reselectedComponentNames.end(), name ) == reselectedComponentNames.end() )
+        {
+          reselectedComponentNames.push_back( name );
+        }
+      }
+    };
+  for( auto const & componentName : componentNames )
+  {
+    if( this->m_PreviousSelection.count( componentName ) == 0
+      || std::find( this->m_ModifiedComponentNames.begin(), this->m_ModifiedComponentNames.end(), componentName ) != this->m_ModifiedComponentNames.end() )
+    {
+      reselect( { componentName } );
+      reselect( this->m_Blueprint.GetInputNames( componentName ) );
+      reselect( this->m_Blueprint.GetOutputNames( componentName ) );
+    }
+  }
+
+  for( auto const & componentName : componentNames )
+  {
+    if( std::find( reselectedComponentNames.begin(), reselectedComponentNames.end(), componentName ) == reselectedComponentNames.end() )
+    {
+      ComponentSelectorPointer componentSelector = this->RestoreComponentSelector( componentName, this->m_PreviousSelection[ componentName ] );
+      if( !componentSelector )
+      {
+        this->m_ComponentSelectorContainer.clear();
+        return false;
+      }
+      this->m_ComponentSelectorContainer[ componentName ] = componentSelector;
+    }
+  }
+
+  // Restored components are not checked against the reselected ones, so any failure to narrow the reselected
+  // components down is left to the selection from all components
+  try
+  {
+    this->ApplyComponentConfiguration( reselectedComponentNames );
+    this->ApplyConnectionConfiguration( reselectedComponentNames );
+    if( !this->GetNonUniqueComponentNames().empty() )
+    {
+      this->PropagateConnectionsWithUniqueComponents();
+    }
+    this->RealizeComponents( reselectedComponentNames );
+  }
+  catch( const std::exception & )
+  {
+    this->m_ComponentSelectorContainer.clear();
+    return false;
+  }
+
+  if( !this->GetNonUniqueComponentNames().empty() )
+  {
+    this->m_ComponentSelectorContainer.clear();
+    return false;
+  }
+
+  // A neighbor that changed type may need its own neighbors, which were restored, to change type as well
+  const auto selection = this->GetSelection();
+  for( auto const & componentName : reselectedComponentNames )
+  {
+    const auto previouslySelected = this->m_PreviousSelection.find( componentName );
+    if( previouslySelected != this->m_PreviousSelection.end()
+      && std::find( this->m_ModifiedComponentNames.begin(), this->m_ModifiedComponentNames.end(), componentName ) == this->m_ModifiedComponentNames.end()
+      && previouslySelected->second != selection.at( componentName ) )
+    {
+      this->m_ComponentSelectorContainer.clear();
+      return false;
+    }
+  }
+
+  this->m_ReselectedComponentNames = reselectedComponentNames;
+  return true;
+}
+
+
 template< typename ComponentList >
 NetworkBuilderBase::ComponentNamesType
 NetworkBuilder< ComponentList >::GetNonUniqueComponentNames()
@@ -109,7 +324,7 @@ NetworkBuilder< ComponentList >::GetNonUniqueComponentNames()
     // If a node has 0 possible components, the configuration is aborted (with an exception)
     // If all nodes have exactly 1 possible component, no more criteria are needed.
 
-    if( this->m_ComponentSelectorContainer[ name ]->NumberOfComponents() > 1 )
+    if( this->m_ComponentSelectorContainer[ name ]->NumberOfCandidates() > 1 )
     {
       nonUniqueComponentNames.push_back( name );
     }
@@ -118,9 +333,73 @@ NetworkBuilder< ComponentList >::GetNonUniqueComponentNames()
 }
 
 
+template< typename ComponentList >
+unsigned int
+NetworkBuilder< ComponentList >::GetNumberOfConstructedComponents( const ComponentNameType & componentName ) const
+{
+  const auto componentSelector = this->m_ComponentSelectorContainer.find( componentName );
+  return componentSelector == this->m_ComponentSelectorContainer.end() ? 0 : componentSelector->second->NumberOfConstructedComponents();
+}
+
+
+template< typename ComponentList >
+void
+NetworkBuilder< ComponentList >::RealizeComponents( const ComponentNamesType & componentNames )
+{
+  // Components are constructed only after the criteria that prototypes can decide, connections and handshakes
+  // included, narrowed the candidates down. The settings are checked by the constructed components.
+  for( auto const & componentName : componentNames )
+  {
+    if( this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents() == 0 )
+    {
+      std::string msg = "No components fulfill all criteria for " + componentName + ".";
+      this->m_Logger.Log( LogLevel::CRT, msg );
+      throw std::runtime_error( msg );
+    }
+  }
+
+  // A setting may have narrowed a node down to one component, which can narrow its neighbors by handshakes
+  if( !this->GetNonUniqueComponentNames().empty() )
+  {
+    this->PropagateConnectionsWithUniqueComponents();
+  }
+}
+
+
+template< typename ComponentList >
+NetworkBuilderBase::ComponentNamesType
+NetworkBuilder< ComponentList >::GetUpstreamComponentNames( const ComponentNameType & componentName ) const
+{
+  ComponentNamesType upstreamComponentNames;
+  ComponentNamesType unvisitedComponentNames = this->m_Blueprint.GetInputNames( componentName );
+  while( !unvisitedComponentNames.empty() )
+  {
+    const ComponentNameType name = unvisitedComponentNames.back();
+    unvisitedComponentNames.pop_back();
+    if( std::find( upstreamComponentNames.begin(), upstreamComponentNames.end(), name ) == upstreamComponentNames.end() )
+    {
+      upstreamComponentNames.push_back( name );
+      for( const auto & inputName : this->m_Blueprint.GetInputNames( name ) )
+      {
+        unvisitedComponentNames.push_back( inputName );
+      }
+    }
+  }
+  return upstreamComponentNames;
+}
+
+
 template< typename ComponentList >
 void
 NetworkBuilder< ComponentList >::ApplyComponentConfiguration()
+{
+  this->ApplyComponentConfiguration( this->m_Blueprint.GetComponentNames() );
+}
+
+
+template< typename ComponentList >
+void
+NetworkBuilder< ComponentList >::ApplyComponentConfiguration( const ComponentNamesType & componentNames )
 {
   // Creates a ComponentSelector for each node of the graph and apply
   // the criteria/properties at each node to narrow the Component selection.
@@ -141,7 +420,7 @@ NetworkBuilder< ComponentList >::ApplyComponentConfiguration()
   // realized components at each node and not the ComponentSelectors that,
   // in turn, hold 1 (or more) component.
 
-  for( auto const & componentName : this->m_Blueprint.GetComponentNames() )
+  for( auto const & componentName : componentNames )
   {
     ComponentSelectorPointer currentComponentSelector = std::make_shared< ComponentSelectorType >( componentName, this->m_Logger );
 
@@ -149,16 +428,20 @@ NetworkBuilder< ComponentList >::ApplyComponentConfiguration()
     for( auto const& criterion : currentProperty )
     {
       currentComponentSelector->AddCriterion( criterion );
-      
-      this->m_Logger.Log( LogLevel::DBG,
-                          "Finding component for {0}: {1} component(s) satisfies {2} : {3}  and previous criteria.",
-                          componentName,
-                          currentComponentSelector->NumberOfComponents(),
-                          criterion.first,
-                          this->m_Logger.ToString(criterion.second));
+
+      // Counting candidates does not construct components, settings are checked when the selection is realized, see RealizeComponents.
+      if( this->m_Logger.ShouldLog( LogLevel::DBG ) )
+      {
+        this->m_Logger.Log( LogLevel::DBG,
+                            "Finding component for {0}: {1} component(s) satisfies {2} : {3}  and previous criteria.",
+                            componentName,
+                            currentComponentSelector->NumberOfCandidates(),
+                            criterion.first,
+                            this->m_Logger.ToString(criterion.second));
+      }
     }
 
-    if( currentComponentSelector->NumberOfComponents() == 0 )
+    if( currentComponentSelector->NumberOfCandidates() == 0 )
     {
       std::string msg = "No components fulfill all criteria for " + componentName + ".";
       this->m_Logger.Log( LogLevel::CRT, msg );
@@ -176,6 +459,15 @@ template<
   typename ComponentList >
 void
 NetworkBuilder< ComponentList >::ApplyConnectionConfiguration()
+{
+  this->ApplyConnectionConfiguration( this->m_Blueprint.GetComponentNames() );
+}
+
+
+template<
+  typename ComponentList >
+void
+NetworkBuilder< ComponentList >::ApplyConnectionConfiguration( const ComponentNamesType & componentNames )
 {
   // Read the criteria/properties at each Connection and narrow the selection of
   // components.
@@ -188,6 +480,11 @@ NetworkBuilder< ComponentList >::ApplyConnectionConfiguration()
   {
     for( auto const & acceptingComponentName : this->m_Blueprint.GetOutputNames( providingComponentName ) )
     {
+      if( std::find( componentNames.begin(), componentNames.end(), providingComponentName ) == componentNames.end()
+        && std::find( componentNames.begin(), componentNames.end(), acceptingComponentName ) == componentNames.end() )
+      {
+        continue;
+      }
       for ( auto const & connectionName : this->m_Blueprint.GetConnectionNames( providingComponentName, acceptingComponentName ) )
       {
         BlueprintImpl::ParameterMapType connectionProperties = this->m_Blueprint.GetConnection( providingComponentName, acceptingComponentName, connectionName );
@@ -204,27 +501,33 @@ NetworkBuilder< ComponentList >::ApplyConnectionConfiguration()
 
         // TODO: connectionName in log message
         this->m_ComponentSelectorContainer[ providingComponentName ]->AddProvidingInterfaceCriteria( interfaceCriteria );
-        this->m_Logger.Log(LogLevel::DBG,
-          "Finding component for {0}: {1} component(s) satisfies ProvidingInterface {2} and previous criteria.",
-          providingComponentName,
-          this->m_ComponentSelectorContainer[providingComponentName]->NumberOfComponents(),
-          this->m_Logger.ToString(interfaceCriteria) );
+        if( this->m_Logger.ShouldLog( LogLevel::DBG ) )
+        {
+          this->m_Logger.Log(LogLevel::DBG,
+            "Finding component for {0}: {1} component(s) satisfies ProvidingInterface {2} and previous criteria.",
+            providingComponentName,
+            this->m_ComponentSelectorContainer[providingComponentName]->NumberOfCandidates(),
+            this->m_Logger.ToString(interfaceCriteria) );
+        }
 
         this->m_ComponentSelectorContainer[ acceptingComponentName ]->AddAcceptingInterfaceCriteria( interfaceCriteria );
-        this->m_Logger.Log(LogLevel::DBG,
-          "Finding component for {0}: {1} component(s) satisfies AcceptingInterface {2} and previous criteria.",
-          acceptingComponentName,
-          this->m_ComponentSelectorContainer[acceptingComponentName]->NumberOfComponents(),
-          this->m_Logger.ToString(interfaceCriteria) );
+        if( this->m_Logger.ShouldLog( LogLevel::DBG ) )
+        {
+          this->m_Logger.Log(LogLevel::DBG,
+            "Finding component for {0}: {1} component(s) satisfies AcceptingInterface {2} and previous criteria.",
+            acceptingComponentName,
+            this->m_ComponentSelectorContainer[acceptingComponentName]->NumberOfCandidates(),
+            this->m_Logger.ToString(interfaceCriteria) );
+        }
 
-        if( this->m_ComponentSelectorContainer[ acceptingComponentName ]->NumberOfComponents() == 0 )
+        if( this->m_ComponentSelectorContainer[ acceptingComponentName ]->NumberOfCandidates() == 0 )
         {
           std::string msg = acceptingComponentName + "does not provide any connections with the given criteria.";
           this->m_Logger.Log( LogLevel::ERR, msg );
           throw std::runtime_error( msg );
         }
 
-        if( this->m_ComponentSelectorContainer[ providingComponentName ]->NumberOfComponents() == 0 )
+        if( this->m_ComponentSelectorContainer[ providingComponentName ]->NumberOfCandidates() == 0 )
         {
           std::string msg = providingComponentName + "does not accept any connections with the given criteria.";
           this->m_Logger.Log( LogLevel::ERR, msg );
@@ -271,11 +574,11 @@ NetworkBuilder< ComponentList >::PropagateConnectionsWithUniqueComponents()
             }
 
             // TODO: connectionName in log message
-            auto               acceptingComponent = this->m_ComponentSelectorContainer[ acceptingComponentName ]->GetComponent();
-            const unsigned int beforeCriteria    = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
+            auto               acceptingPrototype = this->m_ComponentSelectorContainer[ acceptingComponentName ]->GetPrototype();
+            const unsigned int beforeCriteria    = this->m_ComponentSelectorContainer[ componentName ]->NumberOfCandidates();
             this->m_Logger.Log( LogLevel::DBG, "Propagating 'ProvidingInterface' properties from '{0}' to {2} components at '{1}' ... ", componentName, acceptingComponentName, beforeCriteria );
-            this->m_ComponentSelectorContainer[ componentName ]->RequireProvidingInterfaceTo( acceptingComponent, interfaceCriteria );
-            const unsigned int afterCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
+            this->m_ComponentSelectorContainer[ componentName ]->RequireProvidingInterfaceTo( acceptingPrototype, interfaceCriteria );
+            const unsigned int afterCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfCandidates();
             this->m_Logger.Log( LogLevel::DBG, "Propagating 'ProvidingInterface' properties from '{0}' to {2} components at '{1}' ... Done. Reduced '{1}' to {3} components", componentName, acceptingComponentName, beforeCriteria, afterCriteria );
 
             if( beforeCriteria > afterCriteria )
@@ -314,12 +617,12 @@ NetworkBuilder< ComponentList >::PropagateConnectionsWithUniqueComponents()
             }
 
             // TODO(FB): Use this to provide more info to user
-            auto providingComponent = this->m_ComponentSelectorContainer[ providingComponentName ]->GetComponent();
+            auto providingPrototype = this->m_ComponentSelectorContainer[ providingComponentName ]->GetPrototype();
 
-            const unsigned int beforeCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
+            const unsigned int beforeCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfCandidates();
             this->m_Logger.Log(LogLevel::DBG, "Propagating 'AcceptingInterface' properties from '{0}' to {2} components at '{1}' ... ", componentName, providingComponentName, beforeCriteria);
-            this->m_ComponentSelectorContainer[ componentName ]->RequireAcceptingInterfaceFrom( providingComponent, interfaceCriteria );
-            const unsigned int afterCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
+            this->m_ComponentSelectorContainer[ componentName ]->RequireAcceptingInterfaceFrom( providingPrototype, interfaceCriteria );
+            const unsigned int afterCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfCandidates();
             this->m_Logger.Log(LogLevel::DBG, "Propagating 'AcceptingInterface' properties from '{0}' to {2} components at '{1}' ... Done. Reduced '{1}' to {3} components", componentName, providingComponentName, beforeCriteria, afterCriteria);
 
             if( beforeCriteria > afterCriteria )
@@ -544,6 +847,7 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
   NetworkContainer::ComponentContainerType components;
   NetworkContainer::UpdateOrderType beforeUpdateOrder;
   NetworkContainer::UpdateOrderType updateOrder;
+  NetworkContainer::UpdateDependenciesType updateDependencies;
   NetworkContainer::OutputObjectsMapType outputObjectsMap;
 
   if( this->Configure() )
@@ -567,6 +871,11 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
       }
     }
 
+    // The position in updateOrder of the components that are updated by the network container
+    std::map< ComponentNameType, std::size_t > updateOrderIndices;
+    NetworkContainer::UpdateDescriptionsType   updateDescriptions;
+    const SourceInterfaceMapType               sourceInterfaces = this->GetSourceInterfaces();
+
     for (const auto & componentName : this->m_Blueprint.GetUpdateOrder())
     {
       auto component = this->m_ComponentSelectorContainer[componentName]->GetComponent();
@@ -583,6 +892,30 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
         
         if (connectionInfoUpdateInterface->GetProvidedTo().size() == 0)
         {
+          // A component depends on all updated components upstream, which precede it in the topological order.
+          // Its results are determined by the settings of these components and the data of the Sources among them.
+          std::vector< std::size_t > dependencies;
+          NetworkContainer::UpdateDescription updateDescription;
+          auto upstreamNames = this->GetUpstreamComponentNames( componentName );
+          for( const auto & upstreamName : upstreamNames )
+          {
+            auto updateOrderIndex = updateOrderIndices.find( upstreamName );
+            if( updateOrderIndex != updateOrderIndices.end() )
+            {
+              dependencies.push_back( updateOrderIndex->second );
+            }
+            if( sourceInterfaces.count( upstreamName ) > 0 )
+            {
+              updateDescription.sourceNames.push_back( upstreamName );
+            }
+          }
+          std::sort( updateDescription.sourceNames.begin(), updateDescription.sourceNames.end() );
+          upstreamNames.push_back( componentName );
+          updateDescription.blueprint = this->m_Blueprint.GetCanonicalDescription( upstreamNames );
+
+          updateOrderIndices[ componentName ] = updateOrder.size();
+          updateDependencies.push_back( dependencies );
+          updateDescriptions.push_back( updateDescription );
           updateOrder.push_back(provingUpdateInterface);
           connectionInfoUpdateInterface->SetProvidedTo("NetworkBuilder");
         }
@@ -592,7 +925,25 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
       }
     }
 
-    return NetworkContainer( components, beforeUpdateOrder, updateOrder, outputObjectsMap );
+    // The updated components each Sink depends on, such that the network can be executed for the requested outputs only
+    NetworkContainer::SinkDependenciesType sinkDependencies;
+    for( const auto & nameAndOutput : outputObjectsMap )
+    {
+      std::vector< std::size_t > & dependencies = sinkDependencies[ nameAndOutput.first ];
+      auto componentNames = this->GetUpstreamComponentNames( nameAndOutput.first );
+      componentNames.push_back( nameAndOutput.first );
+      for( const auto & componentName : componentNames )
+      {
+        auto updateOrderIndex = updateOrderIndices.find( componentName );
+        if( updateOrderIndex != updateOrderIndices.end() )
+        {
+          dependencies.push_back( updateOrderIndex->second );
+        }
+      }
+    }
+
+    return NetworkContainer( components, beforeUpdateOrder, updateOrder, updateDependencies, outputObjectsMap,
+      sourceInterfaces, this->GetSinkInterfaces(), sinkDependencies, updateDescriptions );
   }
   else
   {
@@ -29,6 +29,7 @@
 #include <map>
 
 #include "selxComponentSelector.h"
+#include "selxComponentSelectionCache.h"
 #include "selxComponentBase.h"
 #include "selxInterfaces.h"
 #include "selxInterfaceTraits.h"
@@ -64,6 +65,14 @@ public:
   /** Read configuration at the blueprints nodes and edges and return true if all components could be uniquely selected*/
   virtual bool Configure() = 0;
 
+  /** The component type that was selected for each component of the blueprint, see ComponentSelectionCache */
+  virtual ComponentSelectionCache::SelectionType GetSelection() = 0;
+
+  /** Let Configure() start from the selection of a network that was realized from an earlier version of the same
+   * blueprint: only the modified components and their neighbors are selected from all component types. */
+  virtual void SetPreviousSelection( const ComponentSelectionCache::SelectionType & selection,
+    const ComponentNamesType & modifiedComponentNames ) = 0;
+
   /** if all components are uniquely selected, they can be connected */
   virtual bool ConnectComponents() = 0;
 
@@ -22,6 +22,8 @@
 
 #include "selxComponentBase.h"
 #include "selxInterfaces.h"
+#include "selxMemoizationCache.h"
+#include "selxProfiler.h"
 
 #include "itkDataObject.h"
 
@@ -40,25 +42,116 @@ public:
   using ComponentContainerType = std::vector< std::shared_ptr< ComponentBase >>;
   using UpdateOrderType = std::vector<std::shared_ptr< UpdateInterface >>;
   using OutputObjectsMapType   = std::map< std::string, itk::DataObject::Pointer >;
+  // For each entry of the update order, the indices of the entries (upstream in the blueprint) it depends on
+  using UpdateDependenciesType = std::vector< std::vector< std::size_t >>;
+  using SourceInterfaceMapType = std::map< std::string, SourceInterface::Pointer >;
+  using SinkInterfaceMapType   = std::map< std::string, SinkInterface::Pointer >;
+  // For each Sink, the indices of the entries of the update order (upstream in the blueprint) it depends on
+  using SinkDependenciesType = std::map< std::string, std::vector< std::size_t >>;
+  // For each entry of the update order, the canonical description of the part of the blueprint it depends on
+  // (the component and all components upstream) and the names of the Sources in that part
+  struct UpdateDescription
+  {
+    std::string                blueprint;
+    std::vector< std::string > sourceNames;
+  };
+  using UpdateDescriptionsType = std::vector< UpdateDescription >;
+  using SourceKeysType = std::map< std::string, std::string >;
 
-  NetworkContainer( ComponentContainerType components, UpdateOrderType beforeUpdateOrder, UpdateOrderType updateOrder, OutputObjectsMapType outputObjectsMap );
+  NetworkContainer( ComponentContainerType components, UpdateOrderType beforeUpdateOrder, UpdateOrderType updateOrder, UpdateDependenciesType updateDependencies, OutputObjectsMapType outputObjectsMap,
+    SourceInterfaceMapType sourceInterfaces = SourceInterfaceMapType(), SinkInterfaceMapType sinkInterfaces = SinkInterfaceMapType(),
+    SinkDependenciesType sinkDependencies = SinkDependenciesType(), UpdateDescriptionsType updateDescriptions = UpdateDescriptionsType() );
   ~NetworkContainer() {}
 
   /** Allow components to setup internal state before network is updated */
   void BeforeUpdate();
 
-  /** Run the (registration) algorithm */
+  /** Run the (registration) algorithm. Independent branches of the network are updated concurrently,
+   * by at most MaximumNumberOfConcurrentUpdates threads. Only components that the requested outputs
+   * depend on are updated, see SetRequestedOutputs. */
   void Update();
 
+  /** Restrict Update to the components upstream of the Sinks with these names. Components that no Sink
+   * depends on (e.g. components that write files themselves) are always updated, as are all components
+   * if the Sink dependencies are unknown. By default all outputs are requested. */
+  void SetRequestedOutputs( const std::vector< std::string > & outputNames );
+
+  /** Request all outputs again */
+  void RequestAllOutputs();
+
+  /** If on (the default), Update calls ReleaseData on each component as soon as the component and all updated
+   * components downstream of it have finished, such that peak memory is not the sum of all intermediate data. */
+  void SetReleaseIntermediateData( bool releaseIntermediateData );
+
+  bool GetReleaseIntermediateData() const;
+
+  /** Whether Update updates the entry at index of the update order, given the requested outputs */
+  std::vector< bool > GetRequiredUpdates() const;
+
+  /** Components run their own multi-threaded algorithms (ITK, NiftyReg, ...), so by default
+   * the network is updated serially. A value of 0 is treated as 1. */
+  void SetMaximumNumberOfConcurrentUpdates( unsigned int maximumNumberOfConcurrentUpdates );
+
+  unsigned int GetMaximumNumberOfConcurrentUpdates() const;
+
+  /** Measure BeforeUpdate and Update of each component. The profiler is passed on to the components, which
+   * may add their own records, e.g. optimizer iterations. Null (the default) disables profiling. */
+  void SetProfiler( Profiler::Pointer profiler );
+
+  Profiler::Pointer GetProfiler() const;
+
+  /** Memoize the results of the components on disk. A component whose settings, upstream components and Source
+   * data are the same as in an earlier execution of the same revision of SuperElastix reads its results from the
+   * cache instead of being updated, if it supports memoization (see UpdateInterface::ReadResults). Results that
+   * cannot be read are removed from the cache and computed again. Null (the default) disables memoization. */
+  void SetMemoizationCache( MemoizationCache::Pointer memoizationCache );
+
+  MemoizationCache::Pointer GetMemoizationCache() const;
+
+  /** Identify the data of the Sources, e.g. by the hash of the files they are read from. Components that depend
+   * on a Source without a key are not memoized. */
+  void SetSourceKeys( const SourceKeysType & sourceKeys );
+
+  /** The key of the results of the entry at index of the update order, or an empty string if they cannot be memoized */
+  std::string GetMemoizationKey( std::size_t index ) const;
+
   /** Get the Sinking output objects */
   OutputObjectsMapType GetOutputObjectsMap();
 
+  /** Get the Source and Sink components by name, e.g. to feed new inputs to a network that is executed repeatedly */
+  SourceInterfaceMapType GetSourceInterfaces();
+
+  SinkInterfaceMapType GetSinkInterfaces();
+
 private:
 
+  /** Updates the entry at index of the update order with numberOfThreads as its share of the ThreadBudget,
+   * or reads its results from the memoization cache */
+  void UpdateComponent( std::size_t index, unsigned int numberOfThreads );
+
+  void ReleaseData( std::size_t index );
+
   const ComponentContainerType m_ComponentContainer;
   const UpdateOrderType m_BeforeUpdateOrder;
   const UpdateOrderType m_UpdateOrder;
+  const UpdateDependenciesType m_UpdateDependencies;
   const OutputObjectsMapType   m_OutputObjectsMap;
+  const SourceInterfaceMapType m_SourceInterfaces;
+  const SinkInterfaceMapType   m_SinkInterfaces;
+  const SinkDependenciesType   m_SinkDependencies;
+  const UpdateDescriptionsType m_UpdateDescriptions;
+
+  bool                       m_AllOutputsRequested;
+  std::vector< std::string > m_RequestedOutputs;
+
+  bool m_ReleaseIntermediateData;
+
+  unsigned int m_MaximumNumberOfConcurrentUpdates;
+
+  Profiler::Pointer m_Profiler;
+
+  MemoizationCache::Pointer m_MemoizationCache;
+  SourceKeysType            m_SourceKeys;
 };
 } // end namespace selx
 #endif // selxNetworkContainer_h
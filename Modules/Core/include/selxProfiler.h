@@ -0,0 +1,120 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxProfiler_h
+#define selxProfiler_h
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace selx
+{
+/** \class Profiler
+ * \brief Collects where time and memory go when a network is executed.
+ *
+ * A Measurement holds the wall time, the CPU time and the increase of the peak resident set size of the
+ * process during one phase (e.g. BeforeUpdate, Update, Output) of one component. CPU time and peak memory
+ * are process wide: components are multi-threaded themselves and, if independent branches are updated
+ * concurrently, the measurements of the concurrent components overlap.
+ *
+ * An Iteration holds the values an optimizer reports at one iteration, such as the metric value.
+ *
+ * The Profiler is thread-safe.
+ */
+class Profiler
+{
+public:
+
+  using Pointer      = std::shared_ptr< Profiler >;
+  using ConstPointer = std::shared_ptr< const Profiler >;
+
+  struct Measurement
+  {
+    std::string  componentName;
+    std::string  phase;
+    double       wallTime;           // seconds
+    double       cpuTime;            // seconds
+    std::int64_t peakMemoryIncrease; // bytes
+  };
+
+  struct Iteration
+  {
+    std::string                     componentName;
+    unsigned int                    level;
+    unsigned int                    iteration;
+    std::map< std::string, double > values;
+  };
+
+  /** Measures the lifetime of the scope and adds it to the profiler. Does nothing if the profiler is null. */
+  class Scope
+  {
+public:
+
+    Scope( Profiler * profiler, const std::string & componentName, const std::string & phase );
+    Scope( const Pointer & profiler, const std::string & componentName, const std::string & phase ) :
+      Scope( profiler.get(), componentName, phase ) {}
+    ~Scope();
+
+    Scope( const Scope & ) = delete;
+    Scope & operator=( const Scope & ) = delete;
+
+private:
+
+    Profiler * const                      m_Profiler;
+    const std::string                     m_ComponentName;
+    const std::string                     m_Phase;
+    std::chrono::steady_clock::time_point m_WallStart;
+    double                                m_CpuStart;
+    std::int64_t                          m_PeakMemoryStart;
+  };
+
+  void AddMeasurement( const Measurement & measurement );
+
+  void AddIteration( const Iteration & iteration );
+
+  std::vector< Measurement > GetMeasurements() const;
+
+  std::vector< Iteration > GetIterations() const;
+
+  void Clear();
+
+  /** Writes { "Measurements": [ ... ], "Iterations": [ ... ] } */
+  void WriteJson( std::ostream & stream ) const;
+
+  /** CPU time of the process, user and system, in seconds */
+  static double GetProcessCpuTime();
+
+  /** Peak resident set size of the process in bytes, or 0 if not available on this platform */
+  static std::int64_t GetPeakResidentSetSize();
+
+private:
+
+  mutable std::mutex         m_Mutex;
+  std::vector< Measurement > m_Measurements;
+  std::vector< Iteration >   m_Iterations;
+};
+} // end namespace selx
+
+#endif // selxProfiler_h
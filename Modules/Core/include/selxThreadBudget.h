@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxThreadBudget_h
+#define selxThreadBudget_h
+
+namespace selx
+{
+/** \class ThreadBudget
+ * \brief The number of threads of the process, split between the components that run concurrently.
+ *
+ * The toolkits that components wrap each choose their own number of threads by default: ITK filters use
+ * the global default of itk::MultiThreader, NiftyReg uses OpenMP and elastix runs its own ITK filters.
+ * Components that run concurrently, e.g. independent branches of a network or the jobs of a batch, would
+ * each use all cores of the machine. Instead, the NetworkContainer passes each component its share of the
+ * budget before it is updated, see ComponentBase::GetNumberOfThreads().
+ *
+ * Whoever runs independent work concurrently, e.g. the jobs of a batch, announces it by a Reservation for the
+ * duration of the concurrent work. The NetworkContainer splits the share of its caller between the components
+ * that run concurrently when each component starts: a batch of 4 jobs on 16 threads gives each job 4 threads,
+ * of which 2 branches that run concurrently get 2 each.
+ */
+class ThreadBudget
+{
+public:
+
+  /** Sets the number of threads of the process, 0 restores the default: the number of hardware threads.
+   * ITK filters that are not updated by a component (e.g. the pipelines of the Sinks) are limited to it as well. */
+  static void SetNumberOfThreads( unsigned int numberOfThreads );
+
+  static unsigned int GetNumberOfThreads();
+
+  /** The number of threads of each of the consumers that run concurrently, at least 1 */
+  static unsigned int GetNumberOfThreadsPerConsumer();
+
+  /** Splits the share of the caller between numberOfConsumers consumers for the lifetime of this object */
+  class Reservation
+  {
+public:
+
+    Reservation( unsigned int numberOfConsumers );
+    ~Reservation();
+
+private:
+
+    Reservation( const Reservation & ); // purposely not implemented
+    void operator=( const Reservation & ); // purposely not implemented
+
+    const unsigned int m_NumberOfAdditionalConsumers;
+  };
+};
+} // end namespace selx
+
+#endif // selxThreadBudget_h
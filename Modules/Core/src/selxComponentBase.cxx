@@ -22,11 +22,11 @@
 namespace selx
 {
 // TODO delete this constructor
-ComponentBase::ComponentBase() : m_Name( "undefined" ), m_Logger( *( new LoggerImpl() ) )
+ComponentBase::ComponentBase() : m_Name( "undefined" ), m_Logger( *( new LoggerImpl() ) ), m_MaximumNumberOfThreads( 0 ), m_NumberOfThreads( 0 )
 {
 }
 
-ComponentBase::ComponentBase(const std::string & name, LoggerImpl & logger) : m_Logger(logger), m_Name( name )
+ComponentBase::ComponentBase(const std::string & name, LoggerImpl & logger) : m_Logger(logger), m_Name( name ), m_MaximumNumberOfThreads( 0 ), m_NumberOfThreads( 0 )
 {
 }
 
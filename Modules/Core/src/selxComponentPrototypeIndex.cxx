@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxComponentPrototypeIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace selx
+{
+ComponentPrototypeIndex::ComponentPrototypeIndex( const PrototypeListType & prototypes ) :
+  m_Prototypes( prototypes.begin(), prototypes.end() )
+{
+  const std::size_t numberOfPrototypes = this->m_Prototypes.size();
+  for( std::size_t prototypeIndex = 0; prototypeIndex < numberOfPrototypes; ++prototypeIndex )
+  {
+    if( this->m_Prototypes[ prototypeIndex ]->GetIndex() != prototypeIndex )
+    {
+      throw std::runtime_error( "ComponentPrototypeIndex requires the prototypes in the order of their index" );
+    }
+
+    for( const auto & keyAndValue : this->m_Prototypes[ prototypeIndex ]->GetTemplateProperties() )
+    {
+      PropertyIndex & propertyIndex = this->m_PropertyIndices[ keyAndValue.first ];
+      propertyIndex.valueOfPrototype.resize( numberOfPrototypes, -1 );
+
+      const auto inserted = propertyIndex.values.emplace( keyAndValue.second, static_cast< int >( propertyIndex.prototypesByValue.size() ) );
+      if( inserted.second )
+      {
+        propertyIndex.prototypesByValue.emplace_back();
+      }
+      propertyIndex.valueOfPrototype[ prototypeIndex ] = inserted.first->second;
+      propertyIndex.prototypesByValue[ inserted.first->second ].push_back( prototypeIndex );
+    }
+  }
+
+  for( auto & keyAndPropertyIndex : this->m_PropertyIndices )
+  {
+    PropertyIndex & propertyIndex = keyAndPropertyIndex.second;
+    for( std::size_t prototypeIndex = 0; prototypeIndex < numberOfPrototypes; ++prototypeIndex )
+    {
+      if( propertyIndex.valueOfPrototype[ prototypeIndex ] < 0 )
+      {
+        propertyIndex.prototypesWithoutProperty.push_back( prototypeIndex );
+      }
+    }
+  }
+}
+
+
+std::size_t
+ComponentPrototypeIndex::GetNumberOfPrototypes() const
+{
+  return this->m_Prototypes.size();
+}
+
+
+ComponentPrototypeBase::ConstPointer
+ComponentPrototypeIndex::GetPrototype( std::size_t prototypeIndex ) const
+{
+  return this->m_Prototypes.at( prototypeIndex );
+}
+
+
+bool
+ComponentPrototypeIndex::IsTemplateProperty( const std::string & key ) const
+{
+  return this->m_PropertyIndices.count( key ) == 1;
+}
+
+
+const ComponentPrototypeIndex::PropertyIndex *
+ComponentPrototypeIndex::FindPropertyIndex( const ComponentBase::CriterionType & criterion ) const
+{
+  const auto found = this->m_PropertyIndices.find( criterion.first );
+  if( found == this->m_PropertyIndices.end() )
+  {
+    return nullptr;
+  }
+  if( criterion.second.size() != 1 ) // see CheckTemplateProperties
+  {
+    throw std::runtime_error( "The criterion " + criterion.first + " may have only 1 value" );
+  }
+  return &found->second;
+}
+
+
+CriterionStatus
+ComponentPrototypeIndex::CheckTemplateCriterion( std::size_t prototypeIndex, const ComponentBase::CriterionType & criterion ) const
+{
+  const auto found = this->m_PropertyIndices.find( criterion.first );
+  if( found == this->m_PropertyIndices.end() || found->second.valueOfPrototype[ prototypeIndex ] < 0 )
+  {
+    return CriterionStatus::Unknown;
+  }
+
+  const PropertyIndex * propertyIndex = this->FindPropertyIndex( criterion );
+  const auto            value         = propertyIndex->values.find( criterion.second[ 0 ] );
+  return value != propertyIndex->values.end() && value->second == propertyIndex->valueOfPrototype[ prototypeIndex ]
+         ? CriterionStatus::Satisfied : CriterionStatus::Failed;
+}
+
+
+ComponentPrototypeIndex::PrototypeIndicesType
+ComponentPrototypeIndex::FindCandidates( const ComponentBase::CriterionType & criterion, bool & isUnknown ) const
+{
+  const PropertyIndex * propertyIndex = this->FindPropertyIndex( criterion );
+  if( !propertyIndex )
+  {
+    isUnknown = !this->m_Prototypes.empty();
+    PrototypeIndicesType all( this->m_Prototypes.size() );
+    for( std::size_t prototypeIndex = 0; prototypeIndex < all.size(); ++prototypeIndex )
+    {
+      all[ prototypeIndex ] = prototypeIndex;
+    }
+    return all;
+  }
+
+  isUnknown = !propertyIndex->prototypesWithoutProperty.empty();
+  const auto value = propertyIndex->values.find( criterion.second[ 0 ] );
+  if( value == propertyIndex->values.end() )
+  {
+    return propertyIndex->prototypesWithoutProperty;
+  }
+
+  const PrototypeIndicesType & satisfied = propertyIndex->prototypesByValue[ value->second ];
+  PrototypeIndicesType         candidates;
+  candidates.reserve( satisfied.size() + propertyIndex->prototypesWithoutProperty.size() );
+  std::merge( satisfied.begin(), satisfied.end(), propertyIndex->prototypesWithoutProperty.begin(),
+    propertyIndex->prototypesWithoutProperty.end(), std::back_inserter( candidates ) );
+  return candidates;
+}
+} // end namespace selx
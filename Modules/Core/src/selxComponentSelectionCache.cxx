@@ -0,0 +1,74 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxComponentSelectionCache.h"
+
+namespace selx
+{
+ComponentSelectionCache::ComponentSelectionCache( std::size_t maximumNumberOfEntries ) :
+  m_MaximumNumberOfEntries( maximumNumberOfEntries )
+{
+}
+
+
+bool
+ComponentSelectionCache::Find( const std::string & blueprintDescription, SelectionType & selection ) const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  const auto found = this->m_Selections.find( blueprintDescription );
+  if( found == this->m_Selections.end() )
+  {
+    return false;
+  }
+  selection = found->second;
+  return true;
+}
+
+
+void
+ComponentSelectionCache::Insert( const std::string & blueprintDescription, const SelectionType & selection )
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  if( this->m_MaximumNumberOfEntries == 0 )
+  {
+    return;
+  }
+  if( this->m_Selections.size() >= this->m_MaximumNumberOfEntries && this->m_Selections.count( blueprintDescription ) == 0 )
+  {
+    this->m_Selections.erase( this->m_Selections.begin() );
+  }
+  this->m_Selections[ blueprintDescription ] = selection;
+}
+
+
+void
+ComponentSelectionCache::Clear()
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  this->m_Selections.clear();
+}
+
+
+std::size_t
+ComponentSelectionCache::GetNumberOfEntries() const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  return this->m_Selections.size();
+}
+} // end namespace selx
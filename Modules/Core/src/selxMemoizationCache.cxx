@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxMemoizationCache.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/uuid/detail/sha1.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace selx
+{
+namespace
+{
+std::string
+HexDigest( boost::uuids::detail::sha1 & sha1 )
+{
+  unsigned int digest[ 5 ];
+  sha1.get_digest( digest );
+  std::ostringstream hex;
+  for( const auto word : digest )
+  {
+    hex << std::hex << std::setw( 8 ) << std::setfill( '0' ) << word;
+  }
+  return hex.str();
+}
+} // end anonymous namespace
+
+MemoizationCache::MemoizationCache( const std::string & directory ) :
+  m_Directory( directory )
+{
+  boost::filesystem::create_directories( this->m_Directory );
+}
+
+
+const std::string &
+MemoizationCache::GetDirectory() const
+{
+  return this->m_Directory;
+}
+
+
+std::string
+MemoizationCache::Find( const std::string & key ) const
+{
+  const boost::filesystem::path directory = boost::filesystem::path( this->m_Directory ) / key;
+  boost::system::error_code     error;
+  return boost::filesystem::is_directory( directory, error ) ? directory.string() : std::string();
+}
+
+
+bool
+MemoizationCache::Store( const std::string & key, const std::function< bool( const std::string & directory ) > & write )
+{
+  const boost::filesystem::path directory = boost::filesystem::path( this->m_Directory ) / key;
+  const boost::filesystem::path temporaryDirectory
+    = boost::filesystem::path( this->m_Directory ) / boost::filesystem::unique_path( key + ".partial-%%%%-%%%%-%%%%" );
+  boost::filesystem::create_directories( temporaryDirectory );
+
+  bool written = false;
+  try
+  {
+    written = write( temporaryDirectory.string() );
+  }
+  catch( ... )
+  {
+    boost::filesystem::remove_all( temporaryDirectory );
+    throw;
+  }
+
+  boost::system::error_code error;
+  if( written )
+  {
+    // Fails if another process stored the same results meanwhile, which are just as good
+    boost::filesystem::rename( temporaryDirectory, directory, error );
+  }
+  if( !written || error )
+  {
+    boost::filesystem::remove_all( temporaryDirectory, error );
+  }
+  return written;
+}
+
+
+void
+MemoizationCache::Remove( const std::string & key )
+{
+  // Renamed first, so that it disappears at once for concurrent readers
+  const boost::filesystem::path directory = boost::filesystem::path( this->m_Directory ) / key;
+  const boost::filesystem::path removedDirectory
+    = boost::filesystem::path( this->m_Directory ) / boost::filesystem::unique_path( key + ".removed-%%%%-%%%%-%%%%" );
+  boost::system::error_code error;
+  boost::filesystem::rename( directory, removedDirectory, error );
+  if( !error )
+  {
+    boost::filesystem::remove_all( removedDirectory, error );
+  }
+}
+
+
+std::string
+MemoizationCache::Hash( const std::string & data )
+{
+  boost::uuids::detail::sha1 sha1;
+  sha1.process_bytes( data.data(), data.size() );
+  return HexDigest( sha1 );
+}
+
+
+std::string
+MemoizationCache::HashFile( const std::string & fileName )
+{
+  std::ifstream file( fileName, std::ios::binary );
+  if( !file )
+  {
+    throw std::runtime_error( "MemoizationCache cannot read " + fileName );
+  }
+
+  boost::uuids::detail::sha1 sha1;
+  std::vector< char >        buffer( 1 << 20 );
+  while( file )
+  {
+    file.read( buffer.data(), buffer.size() );
+    sha1.process_bytes( buffer.data(), static_cast< std::size_t >( file.gcount() ) );
+  }
+  return HexDigest( sha1 );
+}
+} // end namespace selx
@@ -18,17 +18,47 @@
 *=========================================================================*/
 
 #include "selxNetworkContainer.h"
+#include "selxGitInfo.h"
+#include "selxThreadBudget.h"
 #include "selxKeys.h"
 #include "selxSuperElastixComponent.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
 namespace selx
 {
-NetworkContainer::NetworkContainer( ComponentContainerType components, UpdateOrderType beforeUpdateOrder, UpdateOrderType updateOrder, OutputObjectsMapType outputObjectsMap ) :
+NetworkContainer::NetworkContainer( ComponentContainerType components, UpdateOrderType beforeUpdateOrder, UpdateOrderType updateOrder, UpdateDependenciesType updateDependencies, OutputObjectsMapType outputObjectsMap,
+  SourceInterfaceMapType sourceInterfaces, SinkInterfaceMapType sinkInterfaces, SinkDependenciesType sinkDependencies,
+  UpdateDescriptionsType updateDescriptions ) :
   m_ComponentContainer( components ),
   m_BeforeUpdateOrder( beforeUpdateOrder ),
   m_UpdateOrder( updateOrder),
-  m_OutputObjectsMap( outputObjectsMap )
+  m_UpdateDependencies( updateDependencies ),
+  m_OutputObjectsMap( outputObjectsMap ),
+  m_SourceInterfaces( sourceInterfaces ),
+  m_SinkInterfaces( sinkInterfaces ),
+  m_SinkDependencies( sinkDependencies ),
+  m_UpdateDescriptions( updateDescriptions ),
+  m_AllOutputsRequested( true ),
+  m_ReleaseIntermediateData( true ),
+  m_MaximumNumberOfConcurrentUpdates( 1 ),
+  m_Profiler( nullptr ),
+  m_MemoizationCache( nullptr )
 {
+  if( this->m_UpdateDependencies.size() != this->m_UpdateOrder.size() )
+  {
+    throw std::runtime_error( "NetworkContainer requires the dependencies of each component in the update order" );
+  }
+  if( !this->m_UpdateDescriptions.empty() && this->m_UpdateDescriptions.size() != this->m_UpdateOrder.size() )
+  {
+    throw std::runtime_error( "NetworkContainer requires the description of each component in the update order" );
+  }
 }
 
 void
@@ -38,6 +68,7 @@ NetworkContainer::BeforeUpdate()
   // The interface is executed in the right pipeline order.
   for( const auto& updateInterface : this->m_BeforeUpdateOrder )
   {
+    Profiler::Scope scope( this->m_Profiler, updateInterface->GetComponentName(), "BeforeUpdate" );
     updateInterface->BeforeUpdate();
   }
 }
@@ -47,10 +78,395 @@ NetworkContainer::Update()
 {
   // For components that need to do active work when the network is executed.
   // // The interface is executed in the right pipeline order.
-  for( const auto& updateInterface : this->m_UpdateOrder )
+  const std::vector< bool > requiredUpdates  = this->GetRequiredUpdates();
+  const std::size_t         numberOfRequired = std::count( requiredUpdates.begin(), requiredUpdates.end(), true );
+  const std::size_t         numberOfThreads  = std::min< std::size_t >( this->m_MaximumNumberOfConcurrentUpdates, numberOfRequired );
+
+  // The share of the caller, e.g. of a job of a batch, is split between the components that run concurrently
+  const unsigned int callerNumberOfThreads = ThreadBudget::GetNumberOfThreadsPerConsumer();
+
+  // A component is ready to be updated when all components it depends on have been updated. The components
+  // a required component depends on are required as well.
+  std::vector< std::size_t > numberOfPendingDependencies( this->m_UpdateOrder.size() );
+  std::vector< std::vector< std::size_t >> dependents( this->m_UpdateOrder.size() );
+  std::deque< std::size_t > ready;
+  for( std::size_t index = 0; index < this->m_UpdateOrder.size(); ++index )
+  {
+    if( !requiredUpdates[ index ] )
+    {
+      continue;
+    }
+    numberOfPendingDependencies[ index ] = this->m_UpdateDependencies[ index ].size();
+    for( const auto dependency : this->m_UpdateDependencies[ index ] )
+    {
+      dependents[ dependency ].push_back( index );
+    }
+    if( numberOfPendingDependencies[ index ] == 0 )
+    {
+      ready.push_back( index );
+    }
+  }
+
+  // Liveness: the data of a component is dead once the component itself and all components downstream that
+  // are updated have finished. Returns the components whose data died by finishing the component at index.
+  std::vector< std::size_t > numberOfLiveUsers( this->m_UpdateOrder.size() );
+  for( std::size_t index = 0; index < this->m_UpdateOrder.size(); ++index )
+  {
+    numberOfLiveUsers[ index ] = 1 + dependents[ index ].size();
+  }
+  auto finish = [ & ]( std::size_t index ) {
+      std::vector< std::size_t > dead;
+      if( !this->m_ReleaseIntermediateData )
+      {
+        return dead;
+      }
+      if( --numberOfLiveUsers[ index ] == 0 )
+      {
+        dead.push_back( index );
+      }
+      for( const auto dependency : this->m_UpdateDependencies[ index ] )
+      {
+        if( --numberOfLiveUsers[ dependency ] == 0 )
+        {
+          dead.push_back( dependency );
+        }
+      }
+      return dead;
+    };
+
+  if( numberOfThreads <= 1 )
+  {
+    for( std::size_t index = 0; index < this->m_UpdateOrder.size(); ++index )
+    {
+      if( requiredUpdates[ index ] )
+      {
+        this->UpdateComponent( index, callerNumberOfThreads );
+        for( const auto deadIndex : finish( index ) )
+        {
+          this->ReleaseData( deadIndex );
+        }
+      }
+    }
+    return;
+  }
+
+  std::mutex              mutex;
+  std::condition_variable condition;
+  std::size_t             numberOfRunning = 0;
+  std::exception_ptr      exception;
+
+  auto worker = [ & ]()
+  {
+    std::unique_lock< std::mutex > lock( mutex );
+    while( true )
+    {
+      // Done when nothing is ready and nothing is running that could make components ready
+      condition.wait( lock, [ & ]() { return !ready.empty() || numberOfRunning == 0; } );
+      if( ready.empty() )
+      {
+        break;
+      }
+      const std::size_t index = ready.front();
+      ready.pop_front();
+      ++numberOfRunning;
+
+      // The component shares the threads with the running components and with the ready ones that are started
+      // next to it. Components that become ready later find the threads of the running ones taken.
+      const std::size_t  numberOfConcurrent       = std::min( numberOfThreads, numberOfRunning + ready.size() );
+      const unsigned int componentNumberOfThreads = std::max( 1u, callerNumberOfThreads / static_cast< unsigned int >( numberOfConcurrent ) );
+      lock.unlock();
+
+      std::exception_ptr updateException;
+      try
+      {
+        this->UpdateComponent( index, componentNumberOfThreads );
+      }
+      catch( ... )
+      {
+        updateException = std::current_exception();
+      }
+
+      lock.lock();
+      --numberOfRunning;
+      if( updateException )
+      {
+        // Let the running components finish, but do not start new ones
+        if( !exception )
+        {
+          exception = updateException;
+        }
+        ready.clear();
+      }
+      else if( !exception )
+      {
+        for( const auto dependent : dependents[ index ] )
+        {
+          if( --numberOfPendingDependencies[ dependent ] == 0 )
+          {
+            ready.push_back( dependent );
+          }
+        }
+
+        const std::vector< std::size_t > dead = finish( index );
+        if( !dead.empty() )
+        {
+          // No component that could use the data is running or will be started
+          condition.notify_all();
+          lock.unlock();
+          for( const auto deadIndex : dead )
+          {
+            this->ReleaseData( deadIndex );
+          }
+          lock.lock();
+        }
+      }
+      condition.notify_all();
+    }
+  };
+
+  std::vector< std::thread > threads;
+  for( std::size_t threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex )
+  {
+    threads.emplace_back( worker );
+  }
+  for( auto & thread : threads )
+  {
+    thread.join();
+  }
+
+  if( exception )
+  {
+    std::rethrow_exception( exception );
+  }
+}
+
+
+void
+NetworkContainer::UpdateComponent( std::size_t index, unsigned int numberOfThreads )
+{
+  const auto &      updateInterface = this->m_UpdateOrder[ index ];
+  const std::string key             = this->GetMemoizationKey( index );
+  if( !key.empty() )
+  {
+    const std::string directory = this->m_MemoizationCache->Find( key );
+    if( !directory.empty() )
+    {
+      Profiler::Scope scope( this->m_Profiler, updateInterface->GetComponentName(), "ReadResults" );
+      std::string     reason = "the component rejected them";
+      try
+      {
+        if( updateInterface->ReadResults( directory ) )
+        {
+          return;
+        }
+      }
+      catch( std::exception & e )
+      {
+        reason = e.what();
+      }
+
+      // A corrupt or incompatible entry is replaced by the results of an Update
+      const auto component = std::dynamic_pointer_cast< ComponentBase >( updateInterface );
+      if( component )
+      {
+        component->Warning( "{0}: Cannot read the memoized results in {1}, updating instead: {2}",
+          updateInterface->GetComponentName(), directory, reason );
+      }
+      this->m_MemoizationCache->Remove( key );
+    }
+  }
+
   {
+    // The share of the component is decided when it starts, the threads of a running algorithm cannot be changed
+    const auto component = std::dynamic_pointer_cast< ComponentBase >( updateInterface );
+    if( component )
+    {
+      component->SetNumberOfThreads( component->GetMaximumNumberOfThreads() > 0
+        ? std::min( numberOfThreads, component->GetMaximumNumberOfThreads() ) : numberOfThreads );
+    }
+
+    Profiler::Scope scope( this->m_Profiler, updateInterface->GetComponentName(), "Update" );
     updateInterface->Update();
   }
+
+  if( !key.empty() )
+  {
+    Profiler::Scope scope( this->m_Profiler, updateInterface->GetComponentName(), "WriteResults" );
+    this->m_MemoizationCache->Store( key, [ & ]( const std::string & directory ) {
+        return updateInterface->WriteResults( directory );
+      } );
+  }
+}
+
+
+std::string
+NetworkContainer::GetMemoizationKey( std::size_t index ) const
+{
+  if( !this->m_MemoizationCache || index >= this->m_UpdateDescriptions.size() )
+  {
+    return std::string();
+  }
+
+  // Strings are prefixed by their length, as in the canonical description of the blueprint. Results of another
+  // revision of SuperElastix are not reused, since its components may compute or store them differently.
+  const UpdateDescription & updateDescription = this->m_UpdateDescriptions[ index ];
+  const std::string         revision          = GitInfo::GetRevisionSha();
+  std::string               description       = "SuperElastixMemoization1R" + std::to_string( revision.size() ) + ':' + revision
+                                                  + updateDescription.blueprint;
+  for( const auto & sourceName : updateDescription.sourceNames )
+  {
+    const auto sourceKey = this->m_SourceKeys.find( sourceName );
+    if( sourceKey == this->m_SourceKeys.end() || sourceKey->second.empty() )
+    {
+      return std::string();
+    }
+    description += "S" + std::to_string( sourceName.size() ) + ':' + sourceName
+                   + std::to_string( sourceKey->second.size() ) + ':' + sourceKey->second;
+  }
+  return MemoizationCache::Hash( description );
+}
+
+
+void
+NetworkContainer::SetMemoizationCache( MemoizationCache::Pointer memoizationCache )
+{
+  this->m_MemoizationCache = memoizationCache;
+}
+
+
+MemoizationCache::Pointer
+NetworkContainer::GetMemoizationCache() const
+{
+  return this->m_MemoizationCache;
+}
+
+
+void
+NetworkContainer::SetSourceKeys( const SourceKeysType & sourceKeys )
+{
+  this->m_SourceKeys = sourceKeys;
+}
+
+
+void
+NetworkContainer::ReleaseData( std::size_t index )
+{
+  Profiler::Scope scope( this->m_Profiler, this->m_UpdateOrder[ index ]->GetComponentName(), "ReleaseData" );
+  this->m_UpdateOrder[ index ]->ReleaseData();
+}
+
+
+void
+NetworkContainer::SetReleaseIntermediateData( bool releaseIntermediateData )
+{
+  this->m_ReleaseIntermediateData = releaseIntermediateData;
+}
+
+
+bool
+NetworkContainer::GetReleaseIntermediateData() const
+{
+  return this->m_ReleaseIntermediateData;
+}
+
+
+void
+NetworkContainer::SetRequestedOutputs( const std::vector< std::string > & outputNames )
+{
+  for( const auto & outputName : outputNames )
+  {
+    if( this->m_OutputObjectsMap.count( outputName ) == 0 )
+    {
+      throw std::runtime_error( "NetworkContainer has no Sink named '" + outputName + "'" );
+    }
+  }
+  this->m_AllOutputsRequested = false;
+  this->m_RequestedOutputs    = outputNames;
+}
+
+
+void
+NetworkContainer::RequestAllOutputs()
+{
+  this->m_AllOutputsRequested = true;
+  this->m_RequestedOutputs.clear();
+}
+
+
+std::vector< bool >
+NetworkContainer::GetRequiredUpdates() const
+{
+  if( this->m_AllOutputsRequested || this->m_SinkDependencies.empty() )
+  {
+    return std::vector< bool >( this->m_UpdateOrder.size(), true );
+  }
+
+  // Components that no Sink depends on have effects of their own
+  std::vector< bool > requiredUpdates( this->m_UpdateOrder.size(), true );
+  for( const auto & nameAndDependencies : this->m_SinkDependencies )
+  {
+    for( const auto index : nameAndDependencies.second )
+    {
+      requiredUpdates[ index ] = false;
+    }
+  }
+
+  for( const auto & outputName : this->m_RequestedOutputs )
+  {
+    const auto sinkDependencies = this->m_SinkDependencies.find( outputName );
+    if( sinkDependencies != this->m_SinkDependencies.end() )
+    {
+      for( const auto index : sinkDependencies->second )
+      {
+        requiredUpdates[ index ] = true;
+      }
+    }
+  }
+
+  // Components only depend on components that precede them in the update order
+  for( std::size_t index = this->m_UpdateOrder.size(); index-- > 0; )
+  {
+    if( requiredUpdates[ index ] )
+    {
+      for( const auto dependency : this->m_UpdateDependencies[ index ] )
+      {
+        requiredUpdates[ dependency ] = true;
+      }
+    }
+  }
+  return requiredUpdates;
+}
+
+
+void
+NetworkContainer::SetMaximumNumberOfConcurrentUpdates( unsigned int maximumNumberOfConcurrentUpdates )
+{
+  this->m_MaximumNumberOfConcurrentUpdates = std::max( maximumNumberOfConcurrentUpdates, 1u );
+}
+
+
+unsigned int
+NetworkContainer::GetMaximumNumberOfConcurrentUpdates() const
+{
+  return this->m_MaximumNumberOfConcurrentUpdates;
+}
+
+
+void
+NetworkContainer::SetProfiler( Profiler::Pointer profiler )
+{
+  this->m_Profiler = profiler;
+  for( const auto & component : this->m_ComponentContainer )
+  {
+    component->SetProfiler( profiler );
+  }
+}
+
+
+Profiler::Pointer
+NetworkContainer::GetProfiler() const
+{
+  return this->m_Profiler;
 }
 
 
@@ -59,4 +475,18 @@ NetworkContainer::GetOutputObjectsMap()
 {
   return this->m_OutputObjectsMap;
 }
+
+
+NetworkContainer::SourceInterfaceMapType
+NetworkContainer::GetSourceInterfaces()
+{
+  return this->m_SourceInterfaces;
+}
+
+
+NetworkContainer::SinkInterfaceMapType
+NetworkContainer::GetSinkInterfaces()
+{
+  return this->m_SinkInterfaces;
+}
 } //end namespace selx
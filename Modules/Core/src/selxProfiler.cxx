@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxProfiler.h"
+
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace selx
+{
+namespace
+{
+std::string
+JsonString( const std::string & value )
+{
+  std::ostringstream out;
+  out << '"';
+  for( const char c : value )
+  {
+    switch( c )
+    {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\r': out << "\\r"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if( static_cast< unsigned char >( c ) < 0x20 )
+        {
+          out << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast< int >( c ) << std::dec;
+        }
+        else
+        {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+  return out.str();
+}
+} // end anonymous namespace
+
+Profiler::Scope::Scope( Profiler * profiler, const std::string & componentName, const std::string & phase ) :
+  m_Profiler( profiler ),
+  m_ComponentName( profiler ? componentName : std::string() ),
+  m_Phase( profiler ? phase : std::string() ),
+  m_CpuStart( 0.0 ),
+  m_PeakMemoryStart( 0 )
+{
+  if( this->m_Profiler )
+  {
+    this->m_PeakMemoryStart = Profiler::GetPeakResidentSetSize();
+    this->m_CpuStart        = Profiler::GetProcessCpuTime();
+    this->m_WallStart       = std::chrono::steady_clock::now();
+  }
+}
+
+
+Profiler::Scope::~Scope()
+{
+  if( this->m_Profiler )
+  {
+    const auto wallStop = std::chrono::steady_clock::now();
+    Measurement measurement;
+    measurement.componentName      = this->m_ComponentName;
+    measurement.phase              = this->m_Phase;
+    measurement.wallTime           = std::chrono::duration< double >( wallStop - this->m_WallStart ).count();
+    measurement.cpuTime            = Profiler::GetProcessCpuTime() - this->m_CpuStart;
+    measurement.peakMemoryIncrease = Profiler::GetPeakResidentSetSize() - this->m_PeakMemoryStart;
+    this->m_Profiler->AddMeasurement( measurement );
+  }
+}
+
+
+void
+Profiler::AddMeasurement( const Measurement & measurement )
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  this->m_Measurements.push_back( measurement );
+}
+
+
+void
+Profiler::AddIteration( const Iteration & iteration )
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  this->m_Iterations.push_back( iteration );
+}
+
+
+std::vector< Profiler::Measurement >
+Profiler::GetMeasurements() const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  return this->m_Measurements;
+}
+
+
+std::vector< Profiler::Iteration >
+Profiler::GetIterations() const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  return this->m_Iterations;
+}
+
+
+void
+Profiler::Clear()
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  this->m_Measurements.clear();
+  this->m_Iterations.clear();
+}
+
+
+void
+Profiler::WriteJson( std::ostream & stream ) const
+{
+  const auto measurements = this->GetMeasurements();
+  const auto iterations   = this->GetIterations();
+
+  std::ostringstream out;
+  out << std::setprecision( 9 );
+  out << "{\n  \"Measurements\": [";
+  for( std::size_t index = 0; index < measurements.size(); ++index )
+  {
+    const auto & measurement = measurements[ index ];
+    out << ( index == 0 ? "\n" : ",\n" )
+        << "    { \"Component\": " << JsonString( measurement.componentName )
+        << ", \"Phase\": " << JsonString( measurement.phase )
+        << ", \"WallTime\": " << measurement.wallTime
+        << ", \"CpuTime\": " << measurement.cpuTime
+        << ", \"PeakMemoryIncrease\": " << measurement.peakMemoryIncrease << " }";
+  }
+  out << ( measurements.empty() ? "],\n" : "\n  ],\n" );
+
+  out << "  \"Iterations\": [";
+  for( std::size_t index = 0; index < iterations.size(); ++index )
+  {
+    const auto & iteration = iterations[ index ];
+    out << ( index == 0 ? "\n" : ",\n" )
+        << "    { \"Component\": " << JsonString( iteration.componentName )
+        << ", \"Level\": " << iteration.level
+        << ", \"Iteration\": " << iteration.iteration;
+    for( const auto & nameAndValue : iteration.values )
+    {
+      out << ", " << JsonString( nameAndValue.first ) << ": " << nameAndValue.second;
+    }
+    out << " }";
+  }
+  out << ( iterations.empty() ? "]\n}\n" : "\n  ]\n}\n" );
+
+  stream << out.str();
+}
+
+
+double
+Profiler::GetProcessCpuTime()
+{
+#ifdef _WIN32
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if( !GetProcessTimes( GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime ) )
+  {
+    return 0.0;
+  }
+  auto toSeconds = []( const FILETIME & time ) {
+      return ( ( static_cast< std::uint64_t >( time.dwHighDateTime ) << 32 ) | time.dwLowDateTime ) * 1e-7;
+    };
+  return toSeconds( kernelTime ) + toSeconds( userTime );
+#else
+  struct rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+  {
+    return 0.0;
+  }
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#endif
+}
+
+
+std::int64_t
+Profiler::GetPeakResidentSetSize()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+  {
+    return 0;
+  }
+  return static_cast< std::int64_t >( counters.PeakWorkingSetSize );
+#else
+  struct rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+  {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast< std::int64_t >( usage.ru_maxrss );        // bytes
+#else
+  return static_cast< std::int64_t >( usage.ru_maxrss ) * 1024; // kilobytes
+#endif
+#endif
+}
+} // end namespace selx
@@ -0,0 +1,75 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxThreadBudget.h"
+
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace selx
+{
+namespace
+{
+// 0 means the number of hardware threads
+std::atomic< unsigned int > processNumberOfThreads( 0 );
+
+std::atomic< unsigned int > processNumberOfConsumers( 1 );
+} // end anonymous namespace
+
+void
+ThreadBudget::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  processNumberOfThreads = numberOfThreads;
+
+  const unsigned int itkNumberOfThreads = GetNumberOfThreads();
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads( itkNumberOfThreads );
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads( itkNumberOfThreads );
+}
+
+
+unsigned int
+ThreadBudget::GetNumberOfThreads()
+{
+  const unsigned int numberOfThreads = processNumberOfThreads;
+  return numberOfThreads > 0 ? numberOfThreads : std::max( 1u, std::thread::hardware_concurrency() );
+}
+
+
+unsigned int
+ThreadBudget::GetNumberOfThreadsPerConsumer()
+{
+  return std::max( 1u, GetNumberOfThreads() / std::max( 1u, processNumberOfConsumers.load() ) );
+}
+
+
+ThreadBudget::Reservation::Reservation( unsigned int numberOfConsumers ) :
+  m_NumberOfAdditionalConsumers( numberOfConsumers > 1 ? numberOfConsumers - 1 : 0 )
+{
+  processNumberOfConsumers += this->m_NumberOfAdditionalConsumers;
+}
+
+
+ThreadBudget::Reservation::~Reservation()
+{
+  processNumberOfConsumers -= this->m_NumberOfAdditionalConsumers;
+}
+} // end namespace selx
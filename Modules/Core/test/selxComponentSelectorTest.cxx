@@ -20,6 +20,8 @@
 #include "gtest/gtest.h"
 
 #include "selxComponentSelector.h"
+#include "selxKeys.h"
+#include "selxInterfaceCompatibilityTable.h"
 #include "selxTypeList.h"
 #include "selxTransformComponent1.h"
 #include "selxMetricComponent1.h"
@@ -31,6 +33,30 @@
 
 namespace selx
 {
+// A component type that is instantiated for multiple dimensions, like the ITK components
+template< int Dimensionality >
+class DimensionalComponent : public SuperElastixComponent< Accepting< >, Providing< >>
+{
+public:
+
+  DimensionalComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+
+  virtual bool MeetsCriterion( const CriterionType & criterion ) override
+  {
+    return CheckTemplateProperties( this->TemplateProperties(), criterion ) == CriterionStatus::Satisfied;
+  }
+
+
+  static const char * GetDescription() { return "Dimensional Component"; }
+
+protected:
+
+  static inline const std::map< std::string, std::string > TemplateProperties()
+  {
+    return { { keys::NameOfClass, "DimensionalComponent" }, { keys::Dimensionality, std::to_string( Dimensionality ) } };
+  }
+};
+
 class ComponentSelectorTest : public ::testing::Test
 {
 public:
@@ -52,6 +78,9 @@ public:
       = TypeList< TransformComponent1, MetricComponent1, GDOptimizer3rdPartyComponent, GDOptimizer4thPartyComponent, SSDMetric3rdPartyComponent,
     SSDMetric4thPartyComponent >;
 
+  using DimensionalComponentList = TypeList< DimensionalComponent< 2 >, TransformComponent1, DimensionalComponent< 3 >,
+    DimensionalComponent< 4 >>;
+
   virtual void SetUp()
   {
   }
@@ -133,6 +162,20 @@ TEST_F( ComponentSelectorTest, AddCriteria )
   EXPECT_TRUE( component->MeetsCriterion( { "NameOfClass", { "TransformComponent1" } } ) );
 }
 
+TEST_F( ComponentSelectorTest, NumberOfThreads )
+{
+  // TransformComponent1 does not know NumberOfThreads, it is a setting of every component
+  auto componentSelector = std::make_shared< ComponentSelector< SmallComponentList >>( "nameless", *( new LoggerImpl() ) );
+  componentSelector->AddCriterion( { "NumberOfThreads", { "2" } } );
+  componentSelector->AddCriterion( { "ComponentOutput", { "Transform" } } );
+  ComponentType::Pointer component = componentSelector->GetComponent();
+  ASSERT_TRUE( component );
+  EXPECT_EQ( component->GetMaximumNumberOfThreads(), 2 );
+
+  EXPECT_THROW( componentSelector->AddCriterion( { "NumberOfThreads", { "-1" } } ), std::runtime_error );
+  EXPECT_THROW( componentSelector->AddCriterion( { "NumberOfThreads", { "2", "4" } } ), std::runtime_error );
+}
+
 TEST_F( ComponentSelectorTest, InterfacedObjects )
 {
   auto componentSelectorA = std::make_shared< ComponentSelector< BigComponentList >>( "nameless", *( new LoggerImpl() ) );
@@ -167,4 +210,73 @@ TEST_F( ComponentSelectorTest, UnknownComponent )
   EXPECT_TRUE( componentSelector->NumberOfComponents() == 0 );
   EXPECT_FALSE( componentSelector->GetComponent() );
 }
+TEST_F( ComponentSelectorTest, InterfaceCompatibilityTable )
+{
+  // The compile-time table must agree with the handshake between constructed components
+  std::list< ComponentPrototypeBase::ConstPointer > prototypes;
+  prototypes = ComponentPrototypesFromTypeList< BigComponentList >::fill( prototypes );
+
+  const std::vector< ComponentBase::InterfaceCriteriaType > interfaceCriteriaList = {
+    {},
+    { { "NameOfInterface", "MetricDerivativeInterface" } },
+    { { "NameOfInterface", "MetricValueInterface" } },
+    { { "NameOfInterface", "DoYouHaveThisInterface?" } }
+  };
+
+  LoggerImpl logger;
+  for( const auto & accepting : prototypes )
+  {
+    for( const auto & providing : prototypes )
+    {
+      for( const auto & interfaceCriteria : interfaceCriteriaList )
+      {
+        const InterfaceStatus staticStatus = InterfaceCompatibilityTable< BigComponentList >::CanAcceptConnectionFrom(
+          accepting->GetIndex(), providing->GetIndex(), accepting->AcceptingInterfacesMask( interfaceCriteria ) );
+        const InterfaceStatus dynamicStatus = accepting->New( "accepting", logger )->CanAcceptConnectionFrom(
+          providing->New( "providing", logger ), interfaceCriteria );
+        EXPECT_EQ( staticStatus, dynamicStatus );
+      }
+    }
+  }
+}
+
+TEST_F( ComponentSelectorTest, PrototypeIndex )
+{
+  // The index must agree with the template properties of each component type
+  std::list< ComponentPrototypeBase::ConstPointer > prototypes;
+  prototypes = ComponentPrototypesFromTypeList< DimensionalComponentList >::fill( prototypes );
+  const ComponentPrototypeIndex prototypeIndex( prototypes );
+
+  const std::vector< CriterionType > criteria = {
+    { "NameOfClass", { "DimensionalComponent" } },
+    { "NameOfClass", { "TransformComponent1" } },
+    { "Dimensionality", { "3" } },
+    { "Dimensionality", { "5" } },
+    { "ComponentOutput", { "Transform" } }
+  };
+  for( const auto & criterion : criteria )
+  {
+    for( const auto & prototype : prototypes )
+    {
+      EXPECT_EQ( prototypeIndex.CheckTemplateCriterion( prototype->GetIndex(), criterion ), prototype->CheckTemplateCriterion( criterion ) );
+    }
+  }
+  EXPECT_FALSE( prototypeIndex.IsTemplateProperty( "ComponentOutput" ) );
+
+  bool isUnknown = false;
+  EXPECT_EQ( prototypeIndex.FindCandidates( { "Dimensionality", { "3" } }, isUnknown ), ComponentPrototypeIndex::PrototypeIndicesType( { 1, 2 } ) );
+  EXPECT_TRUE( isUnknown );
+  EXPECT_THROW( prototypeIndex.FindCandidates( { "Dimensionality", { "2", "3" } }, isUnknown ), std::runtime_error );
+
+  // TransformComponent1 does not know Dimensionality, so it is only rejected when it is constructed
+  LoggerImpl logger;
+  ComponentSelector< DimensionalComponentList > componentSelector( "nameless", logger );
+  componentSelector.AddCriterion( { "Dimensionality", { "3" } } );
+  EXPECT_EQ( componentSelector.NumberOfCandidates(), 2 );
+  EXPECT_EQ( componentSelector.NumberOfConstructedComponents(), 0 );
+  ComponentType::Pointer component = componentSelector.GetComponent();
+  ASSERT_TRUE( component );
+  EXPECT_TRUE( component->MeetsCriterion( { "Dimensionality", { "3" } } ) );
+  EXPECT_EQ( componentSelector.NumberOfConstructedComponents(), 2 );
+}
 } // namespace selx
@@ -28,9 +28,12 @@
 #include "selxSSDMetric4thPartyComponent.h"
 
 #include "selxDefaultComponents.h"
+#include "selxTestUtilities.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
 namespace selx
 {
 class NetworkBuilderTest : public ::testing::Test
@@ -99,6 +102,80 @@ TEST_F( NetworkBuilderTest, Connect )
   bool success;
   EXPECT_NO_THROW( success = networkBuilder->ConnectComponents() );
 }
+TEST_F( NetworkBuilderTest, SelectionCache )
+{
+  typedef NetworkBuilder< CustomComponentList > NetworkBuilderType;
+  NetworkBuilderType::GetSelectionCache().Clear();
+
+  NetworkBuilderType networkBuilder( *logger, *blueprint );
+  EXPECT_TRUE( networkBuilder.Configure() );
+  EXPECT_FALSE( networkBuilder.IsConfiguredFromCache() );
+  EXPECT_EQ( NetworkBuilderType::GetSelectionCache().GetNumberOfEntries(), 1 );
+
+  // The same content, set in a different order
+  BlueprintPointer sameBlueprint = BlueprintPointer( new BlueprintImpl( *logger ) );
+  sameBlueprint->SetComponent( "Transform", { { "NameOfClass", { "TransformComponent1" } } } );
+  sameBlueprint->SetComponent( "Metric", { { "NameOfClass", { "MetricComponent1" } } } );
+  sameBlueprint->SetConnection( "Transform", "Metric", { { "NameOfInterface", { "TransformedImageInterface" } } }, "" );
+  EXPECT_EQ( sameBlueprint->GetCanonicalDescription(), blueprint->GetCanonicalDescription() );
+
+  NetworkBuilderType cachedNetworkBuilder( *logger, *sameBlueprint );
+  EXPECT_TRUE( cachedNetworkBuilder.Configure() );
+  EXPECT_TRUE( cachedNetworkBuilder.IsConfiguredFromCache() );
+  EXPECT_NO_THROW( cachedNetworkBuilder.ConnectComponents() );
+  EXPECT_TRUE( cachedNetworkBuilder.CheckConnectionsSatisfied() );
+
+  // Any other content is selected from all components
+  sameBlueprint->SetConnection( "Transform", "Metric", { { "NameOfInterface", { "TransformedImageInterface" } } }, "Parallel" );
+  EXPECT_NE( sameBlueprint->GetCanonicalDescription(), blueprint->GetCanonicalDescription() );
+  NetworkBuilderType otherNetworkBuilder( *logger, *sameBlueprint );
+  EXPECT_TRUE( otherNetworkBuilder.Configure() );
+  EXPECT_FALSE( otherNetworkBuilder.IsConfiguredFromCache() );
+  EXPECT_EQ( NetworkBuilderType::GetSelectionCache().GetNumberOfEntries(), 2 );
+}
+
+TEST_F( NetworkBuilderTest, PreviousSelection )
+{
+  typedef NetworkBuilder< CustomComponentList > NetworkBuilderType;
+  NetworkBuilderType::GetSelectionCache().Clear();
+
+  blueprint->SetComponent( "SSDMetric", { { "NameOfClass", { "SSDMetric3rdPartyComponent" } } } );
+  NetworkBuilderType networkBuilder( *logger, *blueprint );
+  EXPECT_TRUE( networkBuilder.Configure() );
+  const auto selection    = networkBuilder.GetSelection();
+  const auto modifiedTime = blueprint->GetModifiedTime();
+
+  // Setting the same content is not a modification
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "TransformComponent1" } } } );
+  EXPECT_TRUE( blueprint->GetModifiedComponentNames( modifiedTime ).empty() );
+
+  blueprint->SetComponent( "SSDMetric", { { "NameOfClass", { "SSDMetric4thPartyComponent" } } } );
+  EXPECT_EQ( blueprint->GetModifiedComponentNames( modifiedTime ), BlueprintImpl::ComponentNamesType( { "SSDMetric" } ) );
+
+  // Only the modified component and its neighbors (none) are selected from all component types
+  NetworkBuilderType reconfiguredNetworkBuilder( *logger, *blueprint );
+  reconfiguredNetworkBuilder.SetPreviousSelection( selection, blueprint->GetModifiedComponentNames( modifiedTime ) );
+  EXPECT_TRUE( reconfiguredNetworkBuilder.Configure() );
+  EXPECT_FALSE( reconfiguredNetworkBuilder.IsConfiguredFromCache() );
+  EXPECT_EQ( reconfiguredNetworkBuilder.GetReselectedComponentNames(), BlueprintImpl::ComponentNamesType( { "SSDMetric" } ) );
+  EXPECT_NE( reconfiguredNetworkBuilder.GetSelection().at( "SSDMetric" ), selection.at( "SSDMetric" ) );
+  EXPECT_EQ( reconfiguredNetworkBuilder.GetSelection().at( "Metric" ), selection.at( "Metric" ) );
+
+  // A modified connection reselects the component it goes into and the neighbors of that component
+  const auto connectionModifiedTime = blueprint->GetModifiedTime();
+  blueprint->SetConnection( "Transform", "Metric", { { "NameOfInterface", { "TransformedImageInterface" } } }, "Parallel" );
+  EXPECT_EQ( blueprint->GetModifiedComponentNames( connectionModifiedTime ), BlueprintImpl::ComponentNamesType( { "Metric" } ) );
+
+  NetworkBuilderType connectedNetworkBuilder( *logger, *blueprint );
+  connectedNetworkBuilder.SetPreviousSelection( reconfiguredNetworkBuilder.GetSelection(), blueprint->GetModifiedComponentNames( connectionModifiedTime ) );
+  EXPECT_TRUE( connectedNetworkBuilder.Configure() );
+  auto reselectedComponentNames = connectedNetworkBuilder.GetReselectedComponentNames();
+  std::sort( reselectedComponentNames.begin(), reselectedComponentNames.end() );
+  EXPECT_EQ( reselectedComponentNames, BlueprintImpl::ComponentNamesType( { "Metric", "Transform" } ) );
+  EXPECT_NO_THROW( connectedNetworkBuilder.ConnectComponents() );
+  EXPECT_TRUE( connectedNetworkBuilder.CheckConnectionsSatisfied() );
+}
+
 TEST_F( NetworkBuilderTest, DeduceComponentsFromConnections )
 {
   // Fill the component database with all combinations of Dimensionality:[2,3], PixelType:[float,double] and InternalComputationValueType:[float,double]
@@ -244,9 +321,121 @@ TEST_F( NetworkBuilderTest, DeduceComponentsFromConnections )
   blueprint->SetConnection( "FixedImageSource", "ResampleFilter", { {} }, "" );
   blueprint->SetConnection( "MovingImageSource", "ResampleFilter", { { keys::NameOfInterface, { "itkImageMovingInterface" } } }, "" );
 
-  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, *blueprint ) );
+  NetworkBuilder< RegisterComponents > networkBuilder( *logger, *blueprint );
   bool allUniqueComponents;
-  EXPECT_NO_THROW( allUniqueComponents = networkBuilder->Configure() );
+  EXPECT_NO_THROW( allUniqueComponents = networkBuilder.Configure() );
   EXPECT_TRUE( allUniqueComponents );
+
+  // The ResampleFilter is only selected by its NameOfClass and its connections, which leave 4 candidates and
+  // 1 candidate respectively. Only the component that is left after the handshakes is constructed.
+  EXPECT_EQ( networkBuilder.GetNumberOfConstructedComponents( "ResampleFilter" ), 1 );
+}
+
+TEST_F( NetworkBuilderTest, PreviousSelectionTwoHopsDownstream )
+{
+  using RegisterComponents = TypeList<
+    ItkImageSourceComponent< 2, float >,
+    ItkImageSourceComponent< 3, float >,
+    ItkResampleFilterComponent< 2, float, double >,
+    ItkResampleFilterComponent< 3, float, double >,
+    ItkImageSinkComponent< 2, float >,
+    ItkImageSinkComponent< 3, float >
+    >;
+  typedef NetworkBuilder< RegisterComponents > NetworkBuilderType;
+  NetworkBuilderType::GetSelectionCache().Clear();
+
+  BlueprintPointer blueprint = BlueprintPointer( new BlueprintImpl( *logger ) ); // override old blueprint
+  blueprint->SetComponent( "ImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } },
+                                            { "Dimensionality", { "2" } },
+                                            { "PixelType", { "float" } } } );
+  blueprint->SetComponent( "ResampleFilter", { { "NameOfClass", { "ItkResampleFilterComponent" } } } );
+  blueprint->SetComponent( "ResultImageSink", { { "NameOfClass", { "ItkImageSinkComponent" } } } );
+  blueprint->SetConnection( "ImageSource", "ResampleFilter", { { keys::NameOfInterface, { "itkImageMovingInterface" } } }, "" );
+  blueprint->SetConnection( "ResampleFilter", "ResultImageSink", { { keys::NameOfInterface, { "itkImageInterface" } } }, "" );
+
+  NetworkBuilderType networkBuilder( *logger, *blueprint );
+  EXPECT_TRUE( networkBuilder.Configure() );
+  const auto selection    = networkBuilder.GetSelection();
+  const auto modifiedTime = blueprint->GetModifiedTime();
+
+  // The sink is not a neighbor of the source, but is selected by the type of the resample filter, which changes
+  blueprint->SetComponent( "ImageSource", { { "NameOfClass", { "ItkImageSourceComponent" } },
+                                            { "Dimensionality", { "3" } },
+                                            { "PixelType", { "float" } } } );
+
+  NetworkBuilderType reconfiguredNetworkBuilder( *logger, *blueprint );
+  reconfiguredNetworkBuilder.SetPreviousSelection( selection, blueprint->GetModifiedComponentNames( modifiedTime ) );
+  bool allUniqueComponents = false;
+  EXPECT_NO_THROW( allUniqueComponents = reconfiguredNetworkBuilder.Configure() );
+  EXPECT_TRUE( allUniqueComponents );
+  EXPECT_NE( reconfiguredNetworkBuilder.GetSelection().at( "ResampleFilter" ), selection.at( "ResampleFilter" ) );
+  EXPECT_NE( reconfiguredNetworkBuilder.GetSelection().at( "ResultImageSink" ), selection.at( "ResultImageSink" ) );
+}
+
+#ifdef SUPERELASTIX_BUILD_LONG_UNIT_TESTS
+TEST_F( NetworkBuilderTest, ComponentSelectionStartupBenchmark )
+{
+  // Selecting components for a blueprint of 30 nodes from the default component list. Previously,
+  // every node constructed every registered component before the criteria were applied. This test
+  // repeats that approach and compares it with selection by component prototypes.
+  const std::vector< ParameterMapType > nodeProperties = {
+    { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "float" } } },
+    { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "float" } } },
+    { { "NameOfClass", { "ItkImageRegistrationMethodv4Component" } }, { "Dimensionality", { "2" } }, { "NumberOfLevels", { "2" } } },
+    { { "NameOfClass", { "ItkMeanSquaresImageToImageMetricv4Component" } }, { "Dimensionality", { "2" } } },
+    { { "NameOfClass", { "ItkGradientDescentOptimizerv4Component" } }, { "NumberOfIterations", { "1" } } },
+    { { "NameOfClass", { "ItkAffineTransformComponent" } }, { "Dimensionality", { "2" } } },
+    { { "NameOfClass", { "ItkResampleFilterComponent" } }, { "Dimensionality", { "2" } } },
+    { { "NameOfClass", { "ItkTransformDisplacementFilterComponent" } }, { "Dimensionality", { "2" } } },
+    { { "NameOfClass", { "ItkDisplacementFieldSinkComponent" } }, { "Dimensionality", { "2" } } },
+    { { "NameOfClass", { "NiftyregAladinComponent" } } }
+  };
+  const unsigned int numberOfNodes = 30;
+
+  logger->SetLogLevel( LogLevel::OFF );
+
+  // Construct all, then select
+  unsigned int eagerNumberOfConstructedComponents = 0;
+  const double eagerDuration = TestUtilities::MeasureMilliseconds( [ & ]() {
+      for( unsigned int nodeIndex = 0; nodeIndex < numberOfNodes; ++nodeIndex )
+      {
+        std::list< ComponentPrototypeBase::ConstPointer > prototypes;
+        prototypes = ComponentPrototypesFromTypeList< DefaultComponents >::fill( prototypes );
+        std::list< ComponentBase::Pointer > components;
+        for( const auto & prototype : prototypes )
+        {
+          components.push_back( prototype->New( "Node" + std::to_string( nodeIndex ), *logger ) );
+          ++eagerNumberOfConstructedComponents;
+        }
+        for( const auto & criterion : nodeProperties[ nodeIndex % nodeProperties.size() ] )
+        {
+          components.remove_if( [ & ]( ComponentBase::Pointer component ) { return !component->MeetsCriterion( criterion ); } );
+        }
+        EXPECT_EQ( components.size(), 1 );
+      }
+    } );
+
+  // Select by prototypes, then construct
+  unsigned int lazyNumberOfConstructedComponents = 0;
+  const double lazyDuration = TestUtilities::MeasureMilliseconds( [ & ]() {
+      for( unsigned int nodeIndex = 0; nodeIndex < numberOfNodes; ++nodeIndex )
+      {
+        ComponentSelector< DefaultComponents > componentSelector( "Node" + std::to_string( nodeIndex ), *logger );
+        for( const auto & criterion : nodeProperties[ nodeIndex % nodeProperties.size() ] )
+        {
+          componentSelector.AddCriterion( criterion );
+        }
+        EXPECT_EQ( componentSelector.NumberOfComponents(), 1 );
+        lazyNumberOfConstructedComponents += componentSelector.NumberOfConstructedComponents();
+      }
+    } );
+
+  std::cout << "Component selection for " << numberOfNodes << " nodes:" << std::endl;
+  std::cout << "  construct all, then select: " << eagerNumberOfConstructedComponents << " components constructed in " << eagerDuration << " ms" << std::endl;
+  std::cout << "  select by prototypes:       " << lazyNumberOfConstructedComponents << " components constructed in " << lazyDuration << " ms" << std::endl;
+
+  EXPECT_EQ( lazyNumberOfConstructedComponents, numberOfNodes );
+  EXPECT_LT( lazyNumberOfConstructedComponents, eagerNumberOfConstructedComponents );
 }
+#endif
 } // namespace selx
@@ -0,0 +1,427 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxNetworkContainer.h"
+#include "selxSuperElastixComponent.h"
+#include "selxThreadBudget.h"
+
+#include "gtest/gtest.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace selx
+{
+class NetworkContainerTest : public ::testing::Test
+{
+public:
+
+  // Records the order in which components are updated and how many run at the same time
+  class UpdateRecorder
+  {
+public:
+
+    // The components named by SetRendezvous wait in Start until all of them have started, so that they are
+    // known to run at the same time. If they are not started concurrently, the wait times out instead of hanging.
+    void SetRendezvous( const std::vector< std::string > & names )
+    {
+      m_Rendezvous = names;
+    }
+
+
+    void Start( const std::string & name )
+    {
+      std::unique_lock< std::mutex > lock( m_Mutex );
+      ++m_NumberOfRunning;
+      m_MaximumNumberOfRunning = std::max( m_MaximumNumberOfRunning, m_NumberOfRunning );
+      m_Started.push_back( name );
+      m_Events.push_back( "Start " + name );
+      if( std::find( m_Rendezvous.begin(), m_Rendezvous.end(), name ) != m_Rendezvous.end() )
+      {
+        ++m_NumberOfArrived;
+        m_Arrived.notify_all();
+        m_Arrived.wait_for( lock, std::chrono::seconds( 10 ), [ & ]() { return m_NumberOfArrived == m_Rendezvous.size(); } );
+      }
+    }
+
+
+    void Finish( const std::string & name )
+    {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      --m_NumberOfRunning;
+      m_Finished.push_back( name );
+      m_Events.push_back( "Finish " + name );
+    }
+
+
+    void Release( const std::string & name )
+    {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      m_Released.push_back( name );
+      m_Events.push_back( "Release " + name );
+    }
+
+
+    void Read( const std::string & name )
+    {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      m_Events.push_back( "Read " + name );
+    }
+
+
+    std::size_t EventPosition( const std::string & event ) const
+    {
+      return std::find( m_Events.begin(), m_Events.end(), event ) - m_Events.begin();
+    }
+
+
+    std::mutex                 m_Mutex;
+    std::condition_variable    m_Arrived;
+    std::vector< std::string > m_Rendezvous;
+    std::size_t                m_NumberOfArrived = 0;
+    unsigned int               m_NumberOfRunning = 0;
+    unsigned int               m_MaximumNumberOfRunning = 0;
+    std::vector< std::string > m_Started;
+    std::vector< std::string > m_Finished;
+    std::vector< std::string > m_Released;
+    std::vector< std::string > m_Events;
+  };
+
+  class RecordingUpdateComponent : public UpdateInterface
+  {
+public:
+
+    RecordingUpdateComponent( const std::string & name, UpdateRecorder & recorder, bool throws = false ) :
+      m_Name( name ), m_Recorder( recorder ), m_Throws( throws ) {}
+
+    void Update() override
+    {
+      m_Recorder.Start( m_Name );
+      m_Recorder.Finish( m_Name );
+      if( m_Throws )
+      {
+        throw std::runtime_error( m_Name + " failed" );
+      }
+    }
+
+
+    void ReleaseData() override
+    {
+      m_Recorder.Release( m_Name );
+    }
+
+
+    std::string GetComponentName() const override { return m_Name; }
+
+private:
+
+    const std::string m_Name;
+    UpdateRecorder &  m_Recorder;
+    const bool        m_Throws;
+  };
+
+  // Writes its name as its results
+  class MemoizingUpdateComponent : public RecordingUpdateComponent
+  {
+public:
+
+    MemoizingUpdateComponent( const std::string & name, UpdateRecorder & recorder ) :
+      RecordingUpdateComponent( name, recorder ), m_Name( name ), m_Recorder( recorder ) {}
+
+    bool WriteResults( const std::string & directory ) override
+    {
+      std::ofstream( directory + "/Results.txt" ) << m_Name;
+      return true;
+    }
+
+
+    bool ReadResults( const std::string & directory ) override
+    {
+      std::string results;
+      if( !( std::ifstream( directory + "/Results.txt" ) >> results ) )
+      {
+        throw std::runtime_error( "Cannot read " + directory + "/Results.txt" );
+      }
+      m_Recorder.Read( results );
+      return results == m_Name;
+    }
+
+private:
+
+    const std::string m_Name;
+    UpdateRecorder &  m_Recorder;
+  };
+
+  // Records the share of the ThreadBudget it was updated with
+  class ThreadedUpdateComponent : public SuperElastixComponent< Accepting< >, Providing< UpdateInterface >>
+  {
+public:
+
+    ThreadedUpdateComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+
+    void Update() override
+    {
+      if( m_Recorder )
+      {
+        m_Recorder->Start( this->GetComponentName() );
+        m_Recorder->Finish( this->GetComponentName() );
+      }
+      m_UpdatedNumberOfThreads = this->GetNumberOfThreads();
+    }
+
+
+    bool MeetsCriterion( const CriterionType & ) override { return false; }
+
+    unsigned int m_UpdatedNumberOfThreads = 0;
+
+    // Optional, to let branches run at the same time
+    UpdateRecorder * m_Recorder = nullptr;
+  };
+
+  // An affine registration of a Source that initializes a deformable registration, with their descriptions
+  NetworkContainer CreateMultiStageNetwork( UpdateRecorder & recorder, const std::string & deformableSettings )
+  {
+    NetworkContainer::UpdateOrderType updateOrder = {
+      std::make_shared< MemoizingUpdateComponent >( "Affine", recorder ),
+      std::make_shared< MemoizingUpdateComponent >( "Deformable", recorder )
+    };
+    NetworkContainer::UpdateDependenciesType updateDependencies = { {}, { 0 } };
+    NetworkContainer::UpdateDescriptionsType updateDescriptions = {
+      { "Affine", { "FixedImage" } },
+      { "Affine" + deformableSettings, { "FixedImage" } }
+    };
+    return NetworkContainer( {}, updateOrder, updateOrder, updateDependencies, {}, {}, {}, {}, updateDescriptions );
+  }
+
+
+  // A symmetric network: Source feeds two independent registrations that are combined by Sink
+  NetworkContainer CreateSymmetricNetwork( UpdateRecorder & recorder, bool forwardThrows = false )
+  {
+    NetworkContainer::UpdateOrderType updateOrder = {
+      std::make_shared< RecordingUpdateComponent >( "Source", recorder ),
+      std::make_shared< RecordingUpdateComponent >( "Forward", recorder, forwardThrows ),
+      std::make_shared< RecordingUpdateComponent >( "Backward", recorder ),
+      std::make_shared< RecordingUpdateComponent >( "Sink", recorder )
+    };
+    NetworkContainer::UpdateDependenciesType updateDependencies = { {}, { 0 }, { 0 }, { 0, 1, 2 } };
+    return NetworkContainer( {}, updateOrder, updateOrder, updateDependencies, {} );
+  }
+};
+
+TEST_F( NetworkContainerTest, RequestedOutputs )
+{
+  // Source feeds two registrations, each with its own Sink, and a component that writes a file itself
+  NetworkContainer::OutputObjectsMapType outputObjectsMap = { { "ForwardSink", nullptr }, { "BackwardSink", nullptr } };
+  NetworkContainer::SinkDependenciesType sinkDependencies = { { "ForwardSink", { 0, 1 } }, { "BackwardSink", { 0, 2 } } };
+  NetworkContainer::UpdateDependenciesType updateDependencies = { {}, { 0 }, { 0 }, { 0 } };
+
+  for( unsigned int numberOfConcurrentUpdates : { 1u, 4u } )
+  {
+    UpdateRecorder                    recorder;
+    NetworkContainer::UpdateOrderType updateOrder = {
+      std::make_shared< RecordingUpdateComponent >( "Source", recorder ),
+      std::make_shared< RecordingUpdateComponent >( "Forward", recorder ),
+      std::make_shared< RecordingUpdateComponent >( "Backward", recorder ),
+      std::make_shared< RecordingUpdateComponent >( "Writer", recorder )
+    };
+    NetworkContainer networkContainer( {}, updateOrder, updateOrder, updateDependencies, outputObjectsMap, {}, {}, sinkDependencies );
+    networkContainer.SetMaximumNumberOfConcurrentUpdates( numberOfConcurrentUpdates );
+
+    networkContainer.SetRequestedOutputs( { "BackwardSink" } );
+    EXPECT_EQ( networkContainer.GetRequiredUpdates(), std::vector< bool >( { true, false, true, true } ) );
+    networkContainer.Update();
+    std::sort( recorder.m_Finished.begin(), recorder.m_Finished.end() );
+    EXPECT_EQ( recorder.m_Finished, std::vector< std::string >( { "Backward", "Source", "Writer" } ) );
+
+    networkContainer.RequestAllOutputs();
+    EXPECT_EQ( networkContainer.GetRequiredUpdates(), std::vector< bool >( 4, true ) );
+  }
+
+  NetworkContainer networkContainer( {}, {}, {}, {}, outputObjectsMap, {}, {}, sinkDependencies );
+  EXPECT_THROW( networkContainer.SetRequestedOutputs( { "DebugSink" } ), std::runtime_error );
+}
+
+TEST_F( NetworkContainerTest, SerialByDefault )
+{
+  UpdateRecorder   recorder;
+  NetworkContainer networkContainer = CreateSymmetricNetwork( recorder );
+  EXPECT_EQ( networkContainer.GetMaximumNumberOfConcurrentUpdates(), 1 );
+
+  networkContainer.Update();
+  EXPECT_EQ( recorder.m_MaximumNumberOfRunning, 1 );
+  EXPECT_EQ( recorder.m_Finished, std::vector< std::string >( { "Source", "Forward", "Backward", "Sink" } ) );
+}
+
+TEST_F( NetworkContainerTest, ConcurrentBranches )
+{
+  UpdateRecorder recorder;
+  recorder.SetRendezvous( { "Forward", "Backward" } );
+  NetworkContainer networkContainer = CreateSymmetricNetwork( recorder );
+  networkContainer.SetMaximumNumberOfConcurrentUpdates( 8 );
+
+  networkContainer.Update();
+  ASSERT_EQ( recorder.m_Finished.size(), 4 );
+  // Forward and Backward are independent, all other components have dependencies
+  EXPECT_EQ( recorder.m_MaximumNumberOfRunning, 2 );
+  EXPECT_LT( recorder.EventPosition( "Finish Source" ), recorder.EventPosition( "Start Forward" ) );
+  EXPECT_LT( recorder.EventPosition( "Finish Source" ), recorder.EventPosition( "Start Backward" ) );
+  EXPECT_LT( recorder.EventPosition( "Finish Forward" ), recorder.EventPosition( "Start Sink" ) );
+  EXPECT_LT( recorder.EventPosition( "Finish Backward" ), recorder.EventPosition( "Start Sink" ) );
+}
+
+TEST_F( NetworkContainerTest, ReleaseData )
+{
+  for( unsigned int numberOfConcurrentUpdates : { 1u, 8u } )
+  {
+    UpdateRecorder   recorder;
+    NetworkContainer networkContainer = CreateSymmetricNetwork( recorder );
+    networkContainer.SetMaximumNumberOfConcurrentUpdates( numberOfConcurrentUpdates );
+    EXPECT_TRUE( networkContainer.GetReleaseIntermediateData() );
+
+    networkContainer.Update();
+    std::vector< std::string > released = recorder.m_Released;
+    std::sort( released.begin(), released.end() );
+    EXPECT_EQ( released, std::vector< std::string >( { "Backward", "Forward", "Sink", "Source" } ) );
+    // The data of Source is used by all other components
+    EXPECT_LT( recorder.EventPosition( "Finish Sink" ), recorder.EventPosition( "Release Source" ) );
+    EXPECT_LT( recorder.EventPosition( "Finish Sink" ), recorder.EventPosition( "Release Forward" ) );
+    EXPECT_LT( recorder.EventPosition( "Finish Sink" ), recorder.EventPosition( "Release Backward" ) );
+  }
+
+  UpdateRecorder   recorder;
+  NetworkContainer networkContainer = CreateSymmetricNetwork( recorder );
+  networkContainer.SetReleaseIntermediateData( false );
+  networkContainer.Update();
+  EXPECT_TRUE( recorder.m_Released.empty() );
+}
+
+TEST_F( NetworkContainerTest, Memoization )
+{
+  const boost::filesystem::path directory = boost::filesystem::temp_directory_path()
+    / boost::filesystem::unique_path( "selxMemoizationCache-%%%%-%%%%" );
+  auto memoizationCache = std::make_shared< MemoizationCache >( directory.string() );
+
+  auto update = [ & ]( const std::string & deformableSettings, const std::string & fixedImageKey ) {
+      UpdateRecorder   recorder;
+      NetworkContainer networkContainer = CreateMultiStageNetwork( recorder, deformableSettings );
+      networkContainer.SetMemoizationCache( memoizationCache );
+      networkContainer.SetReleaseIntermediateData( false );
+      if( !fixedImageKey.empty() )
+      {
+        networkContainer.SetSourceKeys( { { "FixedImage", fixedImageKey } } );
+      }
+      networkContainer.Update();
+      return recorder.m_Events;
+    };
+
+  using EventsType = std::vector< std::string >;
+  const EventsType updateAll = { "Start Affine", "Finish Affine", "Start Deformable", "Finish Deformable" };
+
+  EXPECT_EQ( update( "Iterations=100", "" ), updateAll );
+  EXPECT_EQ( update( "Iterations=100", "1234" ), updateAll );
+  EXPECT_EQ( update( "Iterations=100", "1234" ), EventsType( { "Read Affine", "Read Deformable" } ) );
+
+  // Tuning the deformable stage
+  EXPECT_EQ( update( "Iterations=200", "1234" ), EventsType( { "Read Affine", "Start Deformable", "Finish Deformable" } ) );
+
+  // Other data
+  EXPECT_EQ( update( "Iterations=100", "5678" ), updateAll );
+
+  // A corrupt entry is replaced
+  {
+    UpdateRecorder   recorder;
+    NetworkContainer networkContainer = CreateMultiStageNetwork( recorder, "Iterations=100" );
+    networkContainer.SetMemoizationCache( memoizationCache );
+    networkContainer.SetSourceKeys( { { "FixedImage", "1234" } } );
+    std::ofstream( memoizationCache->Find( networkContainer.GetMemoizationKey( 0 ) ) + "/Results.txt", std::ios::trunc );
+  }
+  EXPECT_EQ( update( "Iterations=100", "1234" ), EventsType( { "Start Affine", "Finish Affine", "Read Deformable" } ) );
+  EXPECT_EQ( update( "Iterations=100", "1234" ), EventsType( { "Read Affine", "Read Deformable" } ) );
+
+  boost::filesystem::remove_all( directory );
+}
+
+TEST_F( NetworkContainerTest, FailingBranch )
+{
+  UpdateRecorder   recorder;
+  NetworkContainer networkContainer = CreateSymmetricNetwork( recorder, true );
+  networkContainer.SetMaximumNumberOfConcurrentUpdates( 2 );
+
+  EXPECT_THROW( networkContainer.Update(), std::runtime_error );
+  // Components downstream of the failure are not started
+  EXPECT_EQ( recorder.EventPosition( "Start Sink" ), recorder.m_Events.size() );
+}
+
+TEST_F( NetworkContainerTest, ThreadBudget )
+{
+  ThreadBudget::SetNumberOfThreads( 8 );
+  EXPECT_EQ( ThreadBudget::GetNumberOfThreadsPerConsumer(), 8 );
+
+  LoggerImpl logger;
+  auto       forward  = std::make_shared< ThreadedUpdateComponent >( "Forward", logger );
+  auto       backward = std::make_shared< ThreadedUpdateComponent >( "Backward", logger );
+  backward->SetMaximumNumberOfThreads( 2 );
+  NetworkContainer::UpdateOrderType updateOrder = { forward, backward };
+  NetworkContainer networkContainer( {}, updateOrder, updateOrder, { {}, {} }, {} );
+
+  networkContainer.Update();
+  EXPECT_EQ( forward->m_UpdatedNumberOfThreads, 8 );
+  EXPECT_EQ( backward->m_UpdatedNumberOfThreads, 2 );
+
+  networkContainer.SetMaximumNumberOfConcurrentUpdates( 2 );
+  networkContainer.Update();
+  EXPECT_EQ( forward->m_UpdatedNumberOfThreads, 4 );
+  EXPECT_EQ( backward->m_UpdatedNumberOfThreads, 2 );
+
+  {
+    // As if the network is executed by one of the 2 workers of a batch
+    ThreadBudget::Reservation reservation( 2 );
+    networkContainer.Update();
+    EXPECT_EQ( forward->m_UpdatedNumberOfThreads, 2 );
+    EXPECT_EQ( backward->m_UpdatedNumberOfThreads, 2 );
+  }
+  EXPECT_EQ( ThreadBudget::GetNumberOfThreadsPerConsumer(), 8 );
+
+  // Source and Sink run on their own and are not limited by the branches in between
+  auto source = std::make_shared< ThreadedUpdateComponent >( "Source", logger );
+  auto sink   = std::make_shared< ThreadedUpdateComponent >( "Sink", logger );
+  backward->SetMaximumNumberOfThreads( 0 );
+  UpdateRecorder recorder;
+  recorder.SetRendezvous( { "Forward", "Backward" } );
+  forward->m_Recorder  = &recorder;
+  backward->m_Recorder = &recorder;
+  NetworkContainer::UpdateOrderType symmetricUpdateOrder = { source, forward, backward, sink };
+  NetworkContainer symmetricNetworkContainer( {}, symmetricUpdateOrder, symmetricUpdateOrder, { {}, { 0 }, { 0 }, { 1, 2 } }, {} );
+  symmetricNetworkContainer.SetMaximumNumberOfConcurrentUpdates( 2 );
+  symmetricNetworkContainer.Update();
+  EXPECT_EQ( source->m_UpdatedNumberOfThreads, 8 );
+  EXPECT_EQ( forward->m_UpdatedNumberOfThreads, 4 );
+  EXPECT_EQ( backward->m_UpdatedNumberOfThreads, 4 );
+  EXPECT_EQ( sink->m_UpdatedNumberOfThreads, 8 );
+
+  ThreadBudget::SetNumberOfThreads( 0 );
+  EXPECT_GE( ThreadBudget::GetNumberOfThreads(), 1 );
+}
+} // namespace selx
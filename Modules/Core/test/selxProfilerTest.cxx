@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxProfiler.h"
+#include "selxNetworkContainer.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace selx
+{
+class ProfilerTest : public ::testing::Test
+{
+public:
+
+  class SleepingUpdateComponent : public UpdateInterface
+  {
+public:
+
+    SleepingUpdateComponent( const std::string & name ) : m_Name( name ) {}
+
+    void Update() override
+    {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    }
+
+
+    std::string GetComponentName() const override { return m_Name; }
+
+private:
+
+    const std::string m_Name;
+  };
+};
+
+TEST_F( ProfilerTest, Scope )
+{
+  Profiler::Pointer profiler = std::make_shared< Profiler >();
+  {
+    Profiler::Scope scope( profiler, "Registration", "Update" );
+    // Touch some memory and spend some CPU time
+    std::vector< double > buffer( 1 << 20, 1.0 );
+    volatile double       sum = 0.0;
+    for( double value : buffer )
+    {
+      sum = sum + value;
+    }
+  }
+
+  const auto measurements = profiler->GetMeasurements();
+  ASSERT_EQ( measurements.size(), 1 );
+  EXPECT_EQ( measurements[ 0 ].componentName, "Registration" );
+  EXPECT_EQ( measurements[ 0 ].phase, "Update" );
+  EXPECT_GT( measurements[ 0 ].wallTime, 0.0 );
+  EXPECT_GE( measurements[ 0 ].cpuTime, 0.0 );
+  EXPECT_GE( measurements[ 0 ].peakMemoryIncrease, 0 );
+
+  profiler->Clear();
+  EXPECT_TRUE( profiler->GetMeasurements().empty() );
+}
+
+TEST_F( ProfilerTest, NullProfiler )
+{
+  // Profiling is disabled by passing a null profiler
+  EXPECT_NO_THROW( Profiler::Scope( nullptr, "Registration", "Update" ) );
+}
+
+TEST_F( ProfilerTest, NetworkContainer )
+{
+  NetworkContainer::UpdateOrderType updateOrder = {
+    std::make_shared< SleepingUpdateComponent >( "Source" ),
+    std::make_shared< SleepingUpdateComponent >( "Forward" ),
+    std::make_shared< SleepingUpdateComponent >( "Backward" ),
+    std::make_shared< SleepingUpdateComponent >( "Sink" )
+  };
+  NetworkContainer::UpdateDependenciesType updateDependencies = { {}, { 0 }, { 0 }, { 0, 1, 2 } };
+
+  for( unsigned int numberOfConcurrentUpdates : { 1u, 2u } )
+  {
+    NetworkContainer  networkContainer( {}, updateOrder, updateOrder, updateDependencies, {} );
+    Profiler::Pointer profiler = std::make_shared< Profiler >();
+    networkContainer.SetMaximumNumberOfConcurrentUpdates( numberOfConcurrentUpdates );
+    networkContainer.SetProfiler( profiler );
+    EXPECT_EQ( networkContainer.GetProfiler(), profiler );
+
+    networkContainer.BeforeUpdate();
+    networkContainer.Update();
+
+    // Each component is measured in BeforeUpdate, in Update and when its data is released after its consumers updated
+    const auto measurements = profiler->GetMeasurements();
+    ASSERT_EQ( measurements.size(), 12 );
+    std::map< std::string, unsigned int > numberOfMeasurementsPerPhase;
+    for( const auto & measurement : measurements )
+    {
+      ++numberOfMeasurementsPerPhase[ measurement.phase ];
+      if( measurement.phase == "Update" )
+      {
+        EXPECT_GE( measurement.wallTime, 0.015 );
+      }
+    }
+    EXPECT_EQ( numberOfMeasurementsPerPhase[ "BeforeUpdate" ], 4 );
+    EXPECT_EQ( numberOfMeasurementsPerPhase[ "Update" ], 4 );
+    EXPECT_EQ( numberOfMeasurementsPerPhase[ "ReleaseData" ], 4 );
+  }
+}
+
+TEST_F( ProfilerTest, WriteJson )
+{
+  Profiler profiler;
+  EXPECT_EQ( [ & ]() { std::ostringstream out; profiler.WriteJson( out ); return out.str(); } (),
+    "{\n  \"Measurements\": [],\n  \"Iterations\": []\n}\n" );
+
+  profiler.AddMeasurement( { "Fixed \"image\"", "Update", 1.5, 0.25, 1024 } );
+  profiler.AddIteration( { "Registration", 0, 3, { { "MetricValue", -0.5 } } } );
+
+  std::ostringstream out;
+  profiler.WriteJson( out );
+  EXPECT_EQ( out.str(),
+    "{\n"
+    "  \"Measurements\": [\n"
+    "    { \"Component\": \"Fixed \\\"image\\\"\", \"Phase\": \"Update\", \"WallTime\": 1.5, \"CpuTime\": 0.25, \"PeakMemoryIncrease\": 1024 }\n"
+    "  ],\n"
+    "  \"Iterations\": [\n"
+    "    { \"Component\": \"Registration\", \"Level\": 0, \"Iteration\": 3, \"MetricValue\": -0.5 }\n"
+    "  ]\n"
+    "}\n" );
+}
+} // namespace selx
@@ -52,6 +52,8 @@ public:
 
   virtual void SetFileName( const std::string ) = 0;
 
+  virtual std::string GetFileName( void ) const = 0;
+
   /** SetInput accepts any input data as long as it is derived from itk::DataObject */
   //void SetInput(const DataObjectIdentifierType&, InputDataType*) ITK_OVERRIDE;
 
@@ -61,6 +63,10 @@ public:
   /** This method should be overriden. See fx. the FileReaderDecorator. */
   virtual void Update( void ) override = 0;
 
+  /** Reads the meta data of the output, e.g. the size, spacing and origin of an image, without reading the
+   * pixel data. This is what the SuperElastixFilter needs to configure the network. */
+  virtual void UpdateOutputInformation( void ) override = 0;
+
   /** GetOutput tries dynamic cast to required output type */
   //template<typename ReturnType>
   //ReturnType* GetOutput(const DataObjectIdentifierType&);
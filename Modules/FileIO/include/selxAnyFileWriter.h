@@ -48,6 +48,10 @@ public:
   /** SetInput accepts any input data as long as it is derived from itk::DataObject */
   virtual void SetInput( const InputDataType * ) = 0;
 
+  /** Write the data in this number of pieces, such that only one piece needs to be in memory at a time.
+   * Writers of data without regions and file formats that do not support streamed writing ignore this. */
+  virtual void SetNumberOfStreamDivisions( unsigned int ) {}
+
   /** This method should be overriden. See fx. the FileWriterDecorator. */
   virtual void Update( void ) override = 0;
 
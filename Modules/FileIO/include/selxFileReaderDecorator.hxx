@@ -56,6 +56,15 @@ FileReaderDecorator< TReader >
 }
 
 
+template< typename TReader >
+std::string
+FileReaderDecorator< TReader >
+::GetFileName() const
+{
+  return m_Reader->GetFileName();
+}
+
+
 template< typename TReader >
 typename FileReaderDecorator< TReader >::OutputDataType
 * FileReaderDecorator< TReader >
@@ -72,6 +81,16 @@ FileReaderDecorator< TReader >
 {
   return m_Reader->Update();
 }
+
+
+template< typename TReader >
+void
+FileReaderDecorator< TReader >
+::UpdateOutputInformation()
+{
+  // The itk readers only read the header of the file to generate the output information
+  return m_Reader->UpdateOutputInformation();
+}
 } // namespace elx
 
 #endif // selxProcessObject_hxx
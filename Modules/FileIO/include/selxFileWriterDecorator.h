@@ -63,6 +63,8 @@ public:
   /** SetInput accepts any input data as long as it is derived from itk::DataObject */
   virtual void SetInput( const InputDataType * ) ITK_OVERRIDE;
 
+  virtual void SetNumberOfStreamDivisions( unsigned int ) ITK_OVERRIDE;
+
   virtual void Update( void ) ITK_OVERRIDE;
 
   FileWriterDecorator( void );
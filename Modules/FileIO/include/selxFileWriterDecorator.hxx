@@ -71,6 +71,15 @@ FileWriterDecorator< TWriter, FileWriterDecoratorTraits >
 }
 
 
+template< typename TWriter, typename FileWriterDecoratorTraits >
+void
+FileWriterDecorator< TWriter, FileWriterDecoratorTraits >
+::SetNumberOfStreamDivisions( unsigned int numberOfStreamDivisions )
+{
+  FileWriterDecoratorTraits::SetNumberOfStreamDivisions( m_Writer, numberOfStreamDivisions );
+}
+
+
 template< typename TWriter, typename FileWriterDecoratorTraits >
 void
 FileWriterDecorator< TWriter, FileWriterDecoratorTraits >
@@ -42,18 +42,27 @@ template< typename T1 >
 struct FileWriterDecoratorDefaultTraits< itk::ImageFileWriter< T1 >>
 {
   typedef typename itk::ImageFileWriter< T1 >::InputImageType DerivedInputDataType;
+
+  static void SetNumberOfStreamDivisions( itk::ImageFileWriter< T1 > * writer, unsigned int numberOfStreamDivisions )
+  {
+    writer->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  }
 };
 
 template< typename T1 >
 struct FileWriterDecoratorDefaultTraits< itk::MeshFileWriter< T1 >>
 {
   typedef typename itk::MeshFileWriter< T1 >::InputMeshType DerivedInputDataType;
+
+  static void SetNumberOfStreamDivisions( itk::MeshFileWriter< T1 > *, unsigned int ) {}
 };
 
 template< typename T1 >
 struct FileWriterDecoratorDefaultTraits< itk::TransformFileWriterTemplate< T1 >>
 {
   typedef typename itk::TransformFileWriterTemplate< T1 >::TransformType DerivedInputDataType;
+
+  static void SetNumberOfStreamDivisions( itk::TransformFileWriterTemplate< T1 > *, unsigned int ) {}
 };
 
 }
@@ -121,6 +121,24 @@ TEST_F( AnyFileIOTest, Readers )
   Image3DType::Pointer image3DOutput = dynamic_cast< Image3DType * >( anyOutput3.GetPointer() );
   EXPECT_FALSE( image3DOutput == nullptr );
 }
+TEST_F( AnyFileIOTest, ReadHeaderOnly )
+{
+  DataManagerType::Pointer dataManager = DataManagerType::New();
+
+  AnyFileReader::Pointer anyReader = DecoratedImage3DReaderType::New();
+  anyReader->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+
+  // UpdateOutputInformation reads the header of the file, not its pixel data
+  EXPECT_NO_THROW( anyReader->UpdateOutputInformation() );
+
+  Image3DType::Pointer image3DOutput = dynamic_cast< Image3DType * >( anyReader->GetOutput() );
+  ASSERT_FALSE( image3DOutput == nullptr );
+  EXPECT_GT( image3DOutput->GetLargestPossibleRegion().GetNumberOfPixels(), 0u );
+  EXPECT_EQ( image3DOutput->GetBufferedRegion().GetNumberOfPixels(), 0u );
+
+  EXPECT_NO_THROW( anyReader->Update() );
+  EXPECT_EQ( image3DOutput->GetBufferedRegion(), image3DOutput->GetLargestPossibleRegion() );
+}
 TEST_F( AnyFileIOTest, Writers )
 {
   DataManagerType::Pointer dataManager = DataManagerType::New();
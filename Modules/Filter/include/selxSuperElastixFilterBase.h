@@ -22,10 +22,17 @@
 
 #include "selxBlueprint.h"
 #include "selxLogger.h"
+#include "selxProfiler.h"
+#include "selxComponentSelectionCache.h"
 
 #include "selxAnyFileReader.h"
 #include "selxAnyFileWriter.h"
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 /**
  * \class SuperElastixFilterBase
  * \brief ITK Filter interface to the SuperElastix registration library.
@@ -37,6 +44,8 @@ namespace selx
 class NetworkBuilderBase;
 class NetworkBuilderFactoryBase;
 class NetworkContainer;
+class SourceInterface;
+class SinkInterface;
 
 class SuperElastixFilterBase : public itk::ProcessObject
 {
@@ -70,6 +79,43 @@ public:
   itkSetObjectMacro( Logger, Logger );
   itkGetObjectMacro( Logger, Logger );
 
+  /** Maximum number of independent branches of the network that are executed concurrently. Components
+   * are multi-threaded themselves, so the default of 1 executes the network serially. */
+  itkSetMacro( MaximumNumberOfConcurrentUpdates, unsigned int );
+  itkGetConstMacro( MaximumNumberOfConcurrentUpdates, unsigned int );
+
+  /** In batch mode the realized network is kept after execution. As long as the Blueprint is not modified,
+   * a subsequent Update with new inputs skips component selection and handshakes: the inputs are grafted
+   * into the DataObjects the Source components were given the first time and the network is executed again.
+   * Outputs are overwritten by each execution. */
+  itkSetMacro( BatchMode, bool );
+  itkGetConstMacro( BatchMode, bool );
+  itkBooleanMacro( BatchMode );
+
+  /** If profiling is on, the wall time, CPU time and peak memory increase are recorded for realizing the network
+   * and for each component, as well as the iterations reported by optimizing components. Measurements of
+   * subsequent Updates are appended to the same Profiler. */
+  itkSetMacro( Profiling, bool );
+  itkGetConstMacro( Profiling, bool );
+  itkBooleanMacro( Profiling );
+
+  Profiler::Pointer GetProfiler() const;
+
+  /** If the connection phase check is on, the filter throws if the pipeline of any of its inputs, or any process
+   * object upstream of the data objects passed to its Sinks, is executed while the components are connected:
+   * Accept() may only record connections and query meta data, data is computed when the network is executed.
+   * On by default in debug builds. */
+  itkSetMacro( ConnectionPhaseCheck, bool );
+  itkGetConstMacro( ConnectionPhaseCheck, bool );
+  itkBooleanMacro( ConnectionPhaseCheck );
+
+  /** If a memoization directory is set, the results of components that support it are stored in this directory
+   * and read back instead of recomputed when the filter is run again with the same settings and inputs. Only
+   * inputs read by the readers of GetInputFileReader are identified, by the content of their files; components
+   * that depend on other inputs are always executed. Empty by default. */
+  itkSetMacro( MemoizationDirectory, std::string );
+  itkGetConstMacro( MemoizationDirectory, std::string );
+
   // Adding a BlueprintImpl composes SuperElastixFilter' internal blueprint (accessible by Set/Get BlueprintImpl) with the otherBlueprint.
   // void AddBlueprint(BlueprintPointer otherBlueprint);
 
@@ -121,6 +167,8 @@ protected:
 
   virtual void GenerateOutputInformation( void ) ITK_OVERRIDE;
 
+  virtual void GenerateOutputRequestedRegion( DataObject * output ) ITK_OVERRIDE;
+
   virtual void GenerateData( void ) ITK_OVERRIDE;
 
   std::unique_ptr< NetworkBuilderFactoryBase > m_NetworkBuilderFactory;
@@ -130,10 +178,47 @@ protected:
 
 private:
 
+  typedef std::map< std::string, std::shared_ptr< SourceInterface >> SourceInterfaceMapType;
+  typedef std::map< std::string, std::shared_ptr< SinkInterface >>   SinkInterfaceMapType;
+
+  /** Pass the inputs of the filter to the Source components and check that all inputs are used */
+  void SetMiniPipelineInputs( const SourceInterfaceMapType & sources );
+
+  /** Check that all outputs of the filter are provided by Sink components. Returns the names of the Sinks
+   * whose output is requested; the network is only executed for these. */
+  std::vector< std::string > CheckMiniPipelineOutputs( const SinkInterfaceMapType & sinks );
+
+  /** Connects the components. Throws if the connection phase check is on and inputs were updated meanwhile. */
+  void ConnectComponents( void );
+
+  /** The DataObject that is passed to the Source component for this input */
+  itk::DataObject::Pointer GetMiniPipelineInput( const DataObjectIdentifierType & inputName );
+
+  /** Content keys of the inputs that are read by the readers of GetInputFileReader */
+  std::map< std::string, std::string > GetInputKeys( void );
+
   BlueprintPointer m_Blueprint;
 
   bool m_IsConnected;
   bool m_AllUniqueComponents;
+
+  unsigned int m_MaximumNumberOfConcurrentUpdates;
+
+  bool              m_Profiling;
+  Profiler::Pointer m_Profiler;
+
+  bool m_ConnectionPhaseCheck;
+
+  std::string m_MemoizationDirectory;
+  std::map< DataObjectIdentifierType, AnyFileReaderType::Pointer > m_InputFileReaders;
+
+  bool                  m_BatchMode;
+  bool                  m_IsNetworkUpdated;
+  const Blueprint *     m_RealizedBlueprint;
+  itk::ModifiedTimeType m_RealizedBlueprintMTime;
+  unsigned long         m_RealizedBlueprintModifiedTime; // see BlueprintImpl::GetModifiedTime
+  ComponentSelectionCache::SelectionType m_RealizedSelection;
+  std::map< DataObjectIdentifierType, itk::DataObject::Pointer > m_BatchInputs;
 };
 } // namespace elx
 
@@ -21,9 +21,102 @@
 #include "selxNetworkBuilder.h"
 #include "selxNetworkBuilderFactory.h"
 #include "selxNetworkContainer.h"
+#include "selxMemoizationCache.h"
+
+#include "itkCommand.h"
+#include "itkProcessObject.h"
+#include "itkTimeStamp.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <set>
 
 namespace selx
 {
+namespace
+{
+// Records whether the process object it observes has been executed
+class ExecutionObserver : public itk::Command
+{
+public:
+
+  typedef ExecutionObserver           Self;
+  typedef itk::Command                Superclass;
+  typedef itk::SmartPointer< Self >   Pointer;
+
+  itkNewMacro( Self );
+
+  void Execute( itk::Object *, const itk::EventObject & ) ITK_OVERRIDE { this->m_Executed = true; }
+
+  void Execute( const itk::Object *, const itk::EventObject & ) ITK_OVERRIDE { this->m_Executed = true; }
+
+  bool m_Executed = false;
+
+protected:
+
+  ExecutionObserver() {}
+};
+
+// Collects the process objects upstream of the data object that generated their outputs after the given time
+void
+CollectExecutedSources( itk::DataObject * dataObject, const itk::ModifiedTimeType time,
+  std::set< itk::ProcessObject * > & visitedSources, std::stringstream & executedSources )
+{
+  if( dataObject == nullptr )
+  {
+    return;
+  }
+  itk::ProcessObject * source = dataObject->GetSource();
+  if( source == nullptr || !visitedSources.insert( source ).second )
+  {
+    return;
+  }
+  if( dataObject->GetUpdateMTime() > time )
+  {
+    executedSources << " " << source->GetNameOfClass();
+  }
+  for( const auto & input : source->GetInputs() )
+  {
+    CollectExecutedSources( input, time, visitedSources, executedSources );
+  }
+}
+
+
+// The files that hold the data of an image or mesh file: the file itself and, for header/data pairs, the data file
+std::vector< std::string >
+GetDataFileNames( const std::string & fileName )
+{
+  std::vector< std::string > fileNames = { fileName };
+  const boost::filesystem::path path( fileName );
+  const std::string extension = boost::algorithm::to_lower_copy( path.extension().string() );
+  if( extension == ".mhd" )
+  {
+    std::ifstream header( fileName );
+    std::string   line;
+    while( std::getline( header, line ) )
+    {
+      std::vector< std::string > keyAndValue;
+      boost::algorithm::split( keyAndValue, line, boost::algorithm::is_any_of( "=" ) );
+      if( keyAndValue.size() == 2 && boost::algorithm::trim_copy( keyAndValue[ 0 ] ) == "ElementDataFile" )
+      {
+        const std::string dataFile = boost::algorithm::trim_copy( keyAndValue[ 1 ] );
+        if( dataFile != "LOCAL" && dataFile.find( ' ' ) == std::string::npos )  // LIST and patterns are not identified
+        {
+          fileNames.push_back( ( path.parent_path() / dataFile ).string() );
+        }
+      }
+    }
+  }
+  else if( extension == ".hdr" )
+  {
+    fileNames.push_back( boost::filesystem::path( path ).replace_extension( ".img" ).string() );
+  }
+  return fileNames;
+}
+} // end anonymous namespace
+
 /**
  * ********************* Constructor *********************
  */
@@ -31,7 +124,20 @@ namespace selx
 SuperElastixFilterBase
 ::SuperElastixFilterBase() :
   m_IsConnected( false ),
-  m_AllUniqueComponents( false )
+  m_AllUniqueComponents( false ),
+  m_MaximumNumberOfConcurrentUpdates( 1 ),
+  m_Profiling( false ),
+  m_Profiler( std::make_shared< Profiler >() ),
+#ifdef NDEBUG
+  m_ConnectionPhaseCheck( false ),
+#else
+  m_ConnectionPhaseCheck( true ),
+#endif
+  m_BatchMode( false ),
+  m_IsNetworkUpdated( false ),
+  m_RealizedBlueprint( nullptr ),
+  m_RealizedBlueprintMTime( 0 ),
+  m_RealizedBlueprintModifiedTime( 0 )
 {
   this->m_Blueprint = nullptr;
 
@@ -51,6 +157,12 @@ SuperElastixFilterBase
   if( ( this->m_Blueprint->GetMTime() > this->GetMTime() || !this->m_NetworkBuilder ) )
   {
     m_NetworkBuilder = m_NetworkBuilderFactory->New( this->m_Logger->GetLoggerImpl(), this->m_Blueprint->GetBlueprintImpl() );
+    if( this->m_RealizedBlueprint == this->m_Blueprint.GetPointer() && !this->m_RealizedSelection.empty() )
+    {
+      // Only the components that were modified since the previous network was realized need to be reselected
+      this->m_NetworkBuilder->SetPreviousSelection( this->m_RealizedSelection,
+        this->m_Blueprint->GetBlueprintImpl().GetModifiedComponentNames( this->m_RealizedBlueprintModifiedTime ) );
+    }
     this->m_AllUniqueComponents = this->m_NetworkBuilder->Configure();
   }
   return this->m_AllUniqueComponents;
@@ -86,11 +198,159 @@ SuperElastixFilterBase
     itkExceptionMacro( << "Setting a BlueprintImpl is required first." )
   }
 
-  this->ParseBlueprint();
+  const bool reuseNetwork = this->m_BatchMode && this->m_NetworkContainer
+    && this->m_RealizedBlueprint == this->m_Blueprint.GetPointer()
+    && this->m_Blueprint->GetMTime() <= this->m_RealizedBlueprintMTime;
+
+  std::vector< std::string > requestedOutputs;
+  if( reuseNetwork )
+  {
+    this->m_Logger->Log( LogLevel::INF, "Reusing realized network." );
+    this->SetMiniPipelineInputs( this->m_NetworkContainer->GetSourceInterfaces() );
+    requestedOutputs = this->CheckMiniPipelineOutputs( this->m_NetworkContainer->GetSinkInterfaces() );
+  }
+  else
+  {
+    Profiler::Scope scope( this->m_Profiling ? this->m_Profiler : nullptr, "SuperElastixFilter", "RealizeNetwork" );
+
+    // A network kept in batch mode was realized from another blueprint
+    this->m_NetworkContainer = nullptr;
+    this->m_BatchInputs.clear();
+
+    this->ParseBlueprint();
+
+    this->SetMiniPipelineInputs( this->m_NetworkBuilder->GetSourceInterfaces() );
+    requestedOutputs = this->CheckMiniPipelineOutputs( this->m_NetworkBuilder->GetSinkInterfaces() );
+
+    this->ConnectComponents();
+
+    this->m_Logger->Log( LogLevel::INF, "Searching for missing connections  ..." );
+    const bool connectionSatisfied = this->m_NetworkBuilder->CheckConnectionsSatisfied();
+    this->m_Logger->Log( LogLevel::INF, "Searching for missing connections ... Done" );
+
+    if( connectionSatisfied )
+    {
+      this->m_Logger->Log( LogLevel::INF, "All required connections are satisfied." );
+    }
+    else
+    {
+      this->m_Logger->Log( LogLevel::CRT, "Missing connections found." );
+      itkExceptionMacro( << "One or more components has unsatisfied connections" )
+    }
+
+    // Print citing information
+    this->m_NetworkBuilder->Cite();
+
+    this->m_NetworkContainer = std::make_unique<NetworkContainer>(this->m_NetworkBuilder->GetRealizedNetwork());
+    this->m_RealizedBlueprint = this->m_Blueprint.GetPointer();
+    this->m_RealizedBlueprintMTime = this->m_Blueprint->GetMTime();
+    this->m_RealizedBlueprintModifiedTime = this->m_Blueprint->GetBlueprintImpl().GetModifiedTime();
+    this->m_RealizedSelection = this->m_NetworkBuilder->GetSelection();
+
+    // delete the networkbuilder
+    this->m_NetworkBuilder = nullptr;
+  }
+
+  this->m_NetworkContainer->SetRequestedOutputs( requestedOutputs );
+  this->m_NetworkContainer->SetMaximumNumberOfConcurrentUpdates( this->m_MaximumNumberOfConcurrentUpdates );
+  this->m_NetworkContainer->SetProfiler( this->m_Profiling ? this->m_Profiler : nullptr );
+  if( !this->m_MemoizationDirectory.empty() )
+  {
+    this->m_NetworkContainer->SetMemoizationCache( std::make_shared< MemoizationCache >( this->m_MemoizationDirectory ) );
+    this->m_NetworkContainer->SetSourceKeys( this->GetInputKeys() );
+  }
+  else
+  {
+    this->m_NetworkContainer->SetMemoizationCache( nullptr );
+  }
+
+  // Allow components to setup internal state AFTER all accepters/providers
+  // have been set BEFORE UpdateOutputInformation is called
+  this->m_NetworkContainer->BeforeUpdate();
+  this->m_IsNetworkUpdated = false;
+
+  auto sinks = this->m_NetworkContainer->GetSinkInterfaces();
+  for( const auto & outputName : requestedOutputs )
+  {
+    // Update information: ask the mini pipeline what the size of the data will be
+    sinks[ outputName ]->GetMiniPipelineOutput()->UpdateOutputInformation();
+    // Put the information into the Filter's output Objects by grafting
+    this->GetOutput( outputName )->Graft( sinks[ outputName ]->GetMiniPipelineOutput() );
+  }
+}
+
+
+void
+SuperElastixFilterBase
+::ConnectComponents()
+{
+  // Executing a process object invokes its StartEvent, reading the header of a file in UpdateOutputInformation does not
+  std::map< DataObjectIdentifierType, std::pair< itk::ProcessObject::Pointer, unsigned long > > observedSources;
+  std::map< DataObjectIdentifierType, ExecutionObserver::Pointer >                            observers;
+  if( this->m_ConnectionPhaseCheck )
+  {
+    for( const auto & inputName : this->GetInputNames() )
+    {
+      itk::ProcessObject::Pointer source = this->GetInput( inputName )->GetSource();
+      if( source != nullptr )
+      {
+        observers[ inputName ]       = ExecutionObserver::New();
+        observedSources[ inputName ] = { source, source->AddObserver( itk::StartEvent(), observers[ inputName ] ) };
+      }
+    }
+  }
 
+  itk::TimeStamp connectionTime;
+  connectionTime.Modified();
+
+  this->m_Logger->Log( LogLevel::INF, "Connecting Components ..." );
+  this->m_IsConnected = this->m_NetworkBuilder->ConnectComponents();
+  this->m_Logger->Log( LogLevel::INF, "Connecting Components ... Done" );
+
+  if( !this->m_ConnectionPhaseCheck )
+  {
+    return;
+  }
+
+  std::stringstream executedInputs;
+  for( const auto & nameAndSource : observedSources )
+  {
+    nameAndSource.second.first->RemoveObserver( nameAndSource.second.second );
+    if( observers[ nameAndSource.first ]->m_Executed )
+    {
+      executedInputs << " " << nameAndSource.first;
+    }
+  }
+  if( !executedInputs.str().empty() )
+  {
+    this->m_Logger->Log( LogLevel::CRT, "Inputs were updated while connecting components:" + executedInputs.str() );
+    itkExceptionMacro( << "Inputs were updated while connecting components:" << executedInputs.str()
+                       << ". Accept() may only record connections, data is computed when the network is executed." )
+  }
+
+  // The pipelines that components built inside the network, e.g. of an in-memory input that has no process object
+  // to observe, are found upstream of the data objects that the Sinks were passed
+  std::set< itk::ProcessObject * > visitedSources;
+  std::stringstream                executedSources;
+  for( const auto & nameAndSink : this->m_NetworkBuilder->GetSinkInterfaces() )
+  {
+    CollectExecutedSources( nameAndSink.second->GetMiniPipelineOutput(), connectionTime.GetMTime(), visitedSources, executedSources );
+  }
+  if( !executedSources.str().empty() )
+  {
+    this->m_Logger->Log( LogLevel::CRT, "Process objects were executed while connecting components:" + executedSources.str() );
+    itkExceptionMacro( << "Process objects were executed while connecting components:" << executedSources.str()
+                       << ". Accept() may only record connections, data is computed when the network is executed." )
+  }
+}
+
+
+void
+SuperElastixFilterBase
+::SetMiniPipelineInputs( const SourceInterfaceMapType & sources )
+{
   // Handle inputs:
   auto                                       inputNames = this->GetInputNames();
-  NetworkBuilderBase::SourceInterfaceMapType sources = this->m_NetworkBuilder->GetSourceInterfaces();
   for( const auto & nameAndInterface : sources )
   {
     auto inputName = std::find( inputNames.begin(), inputNames.end(), nameAndInterface.first );
@@ -101,10 +361,11 @@ SuperElastixFilterBase
       itkExceptionMacro( << "SuperElastixFilter requires the input " "" << nameAndInterface.first << "" " for the Source Component with that name" )
     }
 
-    // We have to update the image to know the world info before SuperElastix is run
-    this->GetInput( nameAndInterface.first );
+    // We have to know the world info before SuperElastix is run. Only the meta data is read, e.g. the header of
+    // an image file: the pixel data is read when the network is executed.
+    this->GetInput( nameAndInterface.first )->UpdateOutputInformation();
 
-    nameAndInterface.second->SetMiniPipelineInput( this->GetInput( nameAndInterface.first ) );
+    nameAndInterface.second->SetMiniPipelineInput( this->GetMiniPipelineInput( nameAndInterface.first ) );
     inputNames.erase( inputName );
   }
   if( inputNames.size() > 0 )
@@ -119,19 +380,27 @@ SuperElastixFilterBase
     itkExceptionMacro( << msg.str() )
     //throw std::runtime_error(msg.str());
   }
+}
 
+
+std::vector< std::string >
+SuperElastixFilterBase
+::CheckMiniPipelineOutputs( const SinkInterfaceMapType & sinks )
+{
   // Handle outputs:
   auto                                     usedOutputs = this->GetOutputNames();
-  NetworkBuilderBase::SinkInterfaceMapType sinks       = this->m_NetworkBuilder->GetSinkInterfaces();
+  std::vector< std::string >               requestedOutputs;
   for( const auto & nameAndInterface : sinks )
   {
     auto foundIndex = std::find( usedOutputs.begin(), usedOutputs.end(), nameAndInterface.first );
 
     if( foundIndex == usedOutputs.end() )
     {
-      // or should we catch and rethrow nameAndInterface.second->SetMiniPipelineOutput(this->GetOutput(nameAndInterface.first)); ?
-      itkExceptionMacro( << "SuperElastixFilter requires the output " "" << nameAndInterface.first << "" " for the Sink Component with that name" )
+      // Nobody asked for the output of this Sink, so the components that only this Sink depends on are not executed
+      this->m_Logger->Log( LogLevel::INF, "Output '" + nameAndInterface.first + "' is not requested, its Sink Component is not executed." );
+      continue;
     }
+    requestedOutputs.push_back( nameAndInterface.first );
     // This (empty) Output DataObject is known to the outside of the SuperElastixFilter and might be connected to an itk pipeline.
     // To keep the pipeline intact we need to propagate the DataObject upstream. Additional information such as requested region is preserved as well.
     // nameAndInterface.second->SetMiniPipelineOutput( this->GetOutput( nameAndInterface.first ) );
@@ -147,44 +416,46 @@ SuperElastixFilterBase
     }
     itkExceptionMacro( << msg.str() )
   }
+  return requestedOutputs;
+}
 
-  this->m_Logger->Log( LogLevel::INF, "Connecting Components ..." );
-  this->m_IsConnected =  this->m_NetworkBuilder->ConnectComponents();
-  this->m_Logger->Log( LogLevel::INF, "Connecting Components ... Done" );
-
-  this->m_Logger->Log( LogLevel::INF, "Searching for missing connections  ..." );
-  bool connectionSatisfied = this->m_NetworkBuilder->CheckConnectionsSatisfied();
-  this->m_Logger->Log( LogLevel::INF, "Searching for missing connections ... Done" );
 
-  if( this->m_NetworkBuilder->CheckConnectionsSatisfied() )
-  {
-    this->m_Logger->Log( LogLevel::INF, "All required connections are satisfied." );
-  }
-  else
+itk::DataObject::Pointer
+SuperElastixFilterBase
+::GetMiniPipelineInput( const DataObjectIdentifierType & inputName )
+{
+  if( !this->m_BatchMode )
   {
-    this->m_Logger->Log( LogLevel::CRT, "Missing connections found." );
-    itkExceptionMacro( << "One or more components has unsatisfied connections" )
+    return this->GetInput( inputName );
   }
 
-  // Print citing information
-  this->m_NetworkBuilder->Cite();
+  // Components hold on to the DataObject of their Source component after they are connected. In batch mode
+  // each Source component therefore gets its own DataObject once, into which every new input is grafted.
+  // The input is read in full: the DataObject has no pipeline through which components could read it later,
+  // while some components derive the output geometry from the pixel data (e.g. the Cropper).
+  itk::DataObject * input = this->GetInput( inputName );
+  input->Update();
 
-  this->m_NetworkContainer = std::make_unique<NetworkContainer>(this->m_NetworkBuilder->GetRealizedNetwork());
+  itk::DataObject::Pointer & batchInput = this->m_BatchInputs[ inputName ];
+  if( !batchInput )
+  {
+    batchInput = dynamic_cast< itk::DataObject * >( input->CreateAnother().GetPointer() );
+  }
+  batchInput->Graft( input );
+  return batchInput;
+}
 
-  // delete the networkbuilder
-  this->m_NetworkBuilder = nullptr;
 
-  // Allow components to setup internal state AFTER all accepters/providers
-  // have been set BEFORE UpdateOutputInformation is called
-  this->m_NetworkContainer->BeforeUpdate();
+/**
+ * ********************* GenerateOutputRequestedRegion *********************
+ */
 
-  for( const auto & nameAndInterface : sinks )
-  {
-    // Update information: ask the mini pipeline what the size of the data will be
-    nameAndInterface.second->GetMiniPipelineOutput()->UpdateOutputInformation();
-    // Put the information into the Filter's output Objects by grafting
-    this->GetOutput( nameAndInterface.first )->Graft( nameAndInterface.second->GetMiniPipelineOutput() );
-  }
+void
+SuperElastixFilterBase
+::GenerateOutputRequestedRegion( DataObject * itkNotUsed( output ) )
+{
+  // The outputs are of different types and sizes and each has its own requested region: the region requested
+  // from one output, e.g. a slab by a streaming writer, is not propagated to the other outputs.
 }
 
 
@@ -196,25 +467,57 @@ void
 SuperElastixFilterBase
 ::GenerateData( void )
 {
-  this->m_Logger->Log( LogLevel::INF, "Executing network ..." );
+  if( !this->m_NetworkContainer )
+  {
+    itkExceptionMacro( << "The network has been released after it was executed, the outputs need to be updated again." )
+  }
+
+  // When an output is streamed, GenerateData is called for each piece, but the network is executed once.
+  if( !this->m_IsNetworkUpdated )
+  {
+    this->m_Logger->Log( LogLevel::INF, "Executing network ..." );
+
+    // This calls controller components that take over the control flow if the itk pipeline is broken.
+    this->m_NetworkContainer->Update();
+    this->m_IsNetworkUpdated = true;
+
+    this->m_Logger->Log( LogLevel::INF, "Executing network ... Done" );
+  }
 
-  // This calls controller components that take over the control flow if the itk pipeline is broken.
-  this->m_NetworkContainer->Update();
+  // Connect the itk pipeline: the Sinks generate the regions that are requested from the outputs.
+  auto sinks = this->m_NetworkContainer->GetSinkInterfaces();
+  const auto outputNames = this->GetOutputNames();
+  bool       allOutputsComplete = true;
+  for( const auto & nameAndSink : sinks )
+  {
+    // Only the requested outputs are updated, the mini pipelines of the other Sinks are left outdated.
+    if( std::find( outputNames.begin(), outputNames.end(), nameAndSink.first ) == outputNames.end() )
+    {
+      continue;
+    }
+    DataObject * output = this->GetOutput( nameAndSink.first );
+    {
+      Profiler::Scope scope( this->m_NetworkContainer->GetProfiler(), nameAndSink.first, "Output" );
+      allOutputsComplete &= nameAndSink.second->UpdateMiniPipelineOutput( output );
+    }
+    output->Graft( nameAndSink.second->GetMiniPipelineOutput() );
+  }
 
-  // Connect the itk pipeline.
-  auto outputObjectsMap = this->m_NetworkContainer->GetOutputObjectsMap();
-  for( const auto & nameAndObject : outputObjectsMap )
+  // Deallocate network, unless it is executed again for the next inputs or it still has to generate the
+  // remaining pieces of a streamed output. In the latter case it is deallocated when the filter is updated
+  // with new inputs or destructed.
+  if( !this->m_BatchMode && allOutputsComplete )
   {
-    // Here we force all output to be updated.
-    // TODO: it might be desirable to leave parts of the mini pipeline 'outdated' for memory/speed reasons and only update if requested downsteam.
-    nameAndObject.second->Update();
-    this->GetOutput( nameAndObject.first )->Graft( nameAndObject.second );
+    this->m_NetworkContainer = nullptr;
   }
+}
 
-  // Deallocate network
-  this->m_NetworkContainer = nullptr;
 
-  this->m_Logger->Log( LogLevel::INF, "Executing network ... Done" );
+Profiler::Pointer
+SuperElastixFilterBase
+::GetProfiler() const
+{
+  return this->m_Profiler;
 }
 
 
@@ -228,7 +531,32 @@ SuperElastixFilterBase
   {
     itkExceptionMacro( << "BlueprintImpl was not sufficiently specified to build a network." )
   }
-  return this->m_NetworkBuilder->GetInputFileReader( inputName );
+  auto reader = this->m_NetworkBuilder->GetInputFileReader( inputName );
+  this->m_InputFileReaders[ inputName ] = reader;
+  return reader;
+}
+
+
+std::map< std::string, std::string >
+SuperElastixFilterBase
+::GetInputKeys()
+{
+  std::map< std::string, std::string > inputKeys;
+  for( const auto & nameAndReader : this->m_InputFileReaders )
+  {
+    // An input that was replaced by other data after the reader was requested has no key
+    if( this->GetInput( nameAndReader.first ) != nameAndReader.second->GetOutput() )
+    {
+      continue;
+    }
+    std::string fileHashes;
+    for( const auto & fileName : GetDataFileNames( nameAndReader.second->GetFileName() ) )
+    {
+      fileHashes += MemoizationCache::HashFile( fileName );
+    }
+    inputKeys[ nameAndReader.first ] = MemoizationCache::Hash( fileHashes );
+  }
+  return inputKeys;
 }
 
 
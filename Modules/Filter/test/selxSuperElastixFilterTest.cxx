@@ -40,10 +40,41 @@
 
 #include "selxDefaultComponents.h"
 #include "selxDataManager.h"
+#include "selxTestUtilities.h"
 #include "gtest/gtest.h"
 
 namespace selx
 {
+// Executes its pipeline in Accept, which the connection phase check of the SuperElastixFilter must report
+template< int Dimensionality, class TPixel >
+class UpdateInAcceptComponent : public ItkSmoothingRecursiveGaussianImageFilterComponent< Dimensionality, TPixel >
+{
+public:
+
+  typedef UpdateInAcceptComponent< Dimensionality, TPixel >                           Self;
+  typedef ItkSmoothingRecursiveGaussianImageFilterComponent< Dimensionality, TPixel > Superclass;
+  typedef std::shared_ptr< Self >                                                     Pointer;
+  typedef std::shared_ptr< const Self >                                               ConstPointer;
+
+  UpdateInAcceptComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger ) {}
+
+  virtual int Accept( typename itkImageInterface< Dimensionality, TPixel >::Pointer component ) override
+  {
+    Superclass::Accept( component );
+    this->GetItkImage()->Update();
+    return 0;
+  }
+
+  static const char * GetDescription() { return "UpdateInAccept Component"; }
+
+protected:
+
+  static inline const std::map< std::string, std::string > TemplateProperties()
+  {
+    return { { keys::NameOfClass, "UpdateInAcceptComponent" }, { keys::PixelType, PodString< TPixel >::Get() }, { keys::Dimensionality, std::to_string( Dimensionality ) } };
+  }
+};
+
 class SuperElastixFilterTest : public ::testing::Test
 {
 public:
@@ -61,6 +92,7 @@ public:
     ItkImageSinkComponent< 3, double >,
     ItkImageSourceComponent< 3, double >,
     ItkSmoothingRecursiveGaussianImageFilterComponent< 3, double >,
+    UpdateInAcceptComponent< 3, double >,
     ItkMeshSinkComponent< 2, float >,
     ItkMeshSourceComponent< 2, float >> CustomComponents;
 
@@ -92,6 +124,63 @@ public:
   }
 
 
+  // Two independent smoothing branches, one for each image of a pair
+  static BlueprintPointer CreatePairBlueprint()
+  {
+    BlueprintPointer blueprint = Blueprint::New();
+    blueprint->SetComponent( "FixedImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+    blueprint->SetComponent( "MovingImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+    blueprint->SetComponent( "FixedFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+    blueprint->SetComponent( "MovingFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+    blueprint->SetComponent( "FixedOutput", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+    blueprint->SetComponent( "MovingOutput", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+    blueprint->SetConnection( "FixedImage", "FixedFilter", { {} } );
+    blueprint->SetConnection( "FixedFilter", "FixedOutput", { {} } );
+    blueprint->SetConnection( "MovingImage", "MovingFilter", { {} } );
+    blueprint->SetConnection( "MovingFilter", "MovingOutput", { {} } );
+    return blueprint;
+  }
+
+
+  // Constant images, which stay constant after smoothing: the output tells which pair was processed
+  static Image3DType::Pointer CreateConstantImage( double value )
+  {
+    Image3DType::Pointer    image = Image3DType::New();
+    Image3DType::RegionType region;
+    region.SetSize( { { 16, 16, 16 } } );
+    image->SetRegions( region );
+    image->Allocate();
+    image->FillBuffer( value );
+    return image;
+  }
+
+
+  // Processes numberOfPairs pairs by a new filter for each pair, or by one filter that keeps its realized network
+  void ProcessPairs( const BlueprintPointer & pairBlueprint, unsigned int numberOfPairs, bool batchMode )
+  {
+    const Image3DType::IndexType center = { { 8, 8, 8 } };
+
+    SuperElastixFilterCustomComponents< RegisterComponents >::Pointer superElastixFilter;
+    for( unsigned int pairIndex = 0; pairIndex < numberOfPairs; ++pairIndex )
+    {
+      if( !batchMode || !superElastixFilter )
+      {
+        superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+        superElastixFilter->SetLogger( logger );
+        superElastixFilter->SetBlueprint( pairBlueprint );
+        superElastixFilter->SetBatchMode( batchMode );
+      }
+      superElastixFilter->SetInput( "FixedImage", CreateConstantImage( pairIndex ) );
+      superElastixFilter->SetInput( "MovingImage", CreateConstantImage( -1.0 * pairIndex ) );
+      auto fixedOutput  = superElastixFilter->GetOutput< Image3DType >( "FixedOutput" );
+      auto movingOutput = superElastixFilter->GetOutput< Image3DType >( "MovingOutput" );
+      EXPECT_NO_THROW( superElastixFilter->Update() );
+      EXPECT_NEAR( fixedOutput->GetPixel( center ), pairIndex, 1e-6 );
+      EXPECT_NEAR( movingOutput->GetPixel( center ), -1.0 * pairIndex, 1e-6 );
+    }
+  }
+
+
   // BlueprintImpl holds a configuration for SuperElastix
   BlueprintPointer blueprint;
   // Data manager provides the paths to the input and output data for unit tests
@@ -234,25 +323,60 @@ TEST_F( SuperElastixFilterTest, TooManyOutputs )
 
   EXPECT_THROW( imageWriter3D_B->Update(), itk::ExceptionObject );
 }
-TEST_F( SuperElastixFilterTest, TooManySinks )
+TEST_F( SuperElastixFilterTest, UnrequestedUnconnectedSink )
 {
+  ImageReader3DType::Pointer imageReader3D_A = ImageReader3DType::New();
   ImageWriter3DType::Pointer imageWriter3D_A = ImageWriter3DType::New();
-  imageWriter3D_A->SetFileName( dataManager->GetOutputFile( "SuperElastixFilterTest_TooManyOutputs.mhd" ) );
+  imageReader3D_A->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+  imageWriter3D_A->SetFileName( dataManager->GetOutputFile( "SuperElastixFilterTest_UnrequestedUnconnectedSink.mhd" ) );
 
+  // Sink_B is not requested, so it is not executed, but its connections are checked like those of any other component
   BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "Source_A", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
   blueprint->SetComponent( "Sink_A", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
   blueprint->SetComponent( "Sink_B", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "Source_A", "Sink_A", { {} } );
 
   SuperElastixFilterCustomComponents< RegisterComponents >::Pointer superElastixFilter;
   EXPECT_NO_THROW( superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New() );
   superElastixFilter->SetLogger(logger);
   superElastixFilter->SetBlueprint( blueprint );
 
+  superElastixFilter->SetInput( "Source_A", imageReader3D_A->GetOutput() );
   imageWriter3D_A->SetInput( superElastixFilter->GetOutput< Image3DType >( "Sink_A" ) );
 
   EXPECT_THROW( imageWriter3D_A->Update(), itk::ExceptionObject );
 }
 
+TEST_F( SuperElastixFilterTest, UnrequestedSink )
+{
+  ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
+  ImageWriter3DType::Pointer imageWriter3D = ImageWriter3DType::New();
+
+  imageReader3D->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+  imageWriter3D->SetFileName( dataManager->GetOutputFile( "SuperElastixFilterTest_UnrequestedSink.mhd" ) );
+
+  // A debugging Sink that nobody asks an output from
+  BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+  blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "DebugImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+  blueprint->SetConnection( "InputImage", "DebugImage", { {} } );
+
+  SuperElastixFilterCustomComponents< RegisterComponents >::Pointer superElastixFilter;
+  EXPECT_NO_THROW( superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New() );
+  superElastixFilter->SetLogger( logger );
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetInput( "InputImage", imageReader3D->GetOutput() );
+  imageWriter3D->SetInput( superElastixFilter->GetOutput< Image3DType >( "OutputImage" ) );
+
+  EXPECT_NO_THROW( imageWriter3D->Update() );
+  EXPECT_EQ( superElastixFilter->GetOutputNames().size(), 1 );
+}
+
 TEST_F( SuperElastixFilterTest, UnsatisfiedConnections )
 {
   //ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
@@ -278,4 +402,52 @@ TEST_F( SuperElastixFilterTest, UnsatisfiedConnections )
 
   EXPECT_THROW( imageWriter3D->Update(), itk::ExceptionObject );
 }
+
+TEST_F( SuperElastixFilterTest, UpdateInAccept )
+{
+  // An in-memory image has no process object behind it, the pipeline that is executed is built by a component
+  Image3DType::Pointer image = Image3DType::New();
+  Image3DType::SizeType size;
+  size.Fill( 8 );
+  image->SetRegions( size );
+  image->Allocate();
+  image->FillBuffer( 1.0 );
+
+  BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "UpdateInAcceptComponent" } } } );
+  blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+
+  SuperElastixFilterCustomComponents< RegisterComponents >::Pointer superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+  superElastixFilter->SetLogger( logger );
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetInput( "InputImage", image );
+  superElastixFilter->ConnectionPhaseCheckOn();
+  auto output = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+
+  EXPECT_THROW( output->Update(), itk::ExceptionObject );
+}
+
+TEST_F( SuperElastixFilterTest, BatchMode )
+{
+  logger->SetLogLevel( LogLevel::OFF );
+  this->ProcessPairs( CreatePairBlueprint(), 3, true );
+}
+
+#ifdef SUPERELASTIX_BUILD_LONG_UNIT_TESTS
+TEST_F( SuperElastixFilterTest, BatchThroughput )
+{
+  const BlueprintPointer pairBlueprint = CreatePairBlueprint();
+  const unsigned int     numberOfPairs = 20;
+  logger->SetLogLevel( LogLevel::OFF );
+
+  const double singleShotDuration = TestUtilities::MeasureMilliseconds( [ & ]() { this->ProcessPairs( pairBlueprint, numberOfPairs, false ); } );
+  const double batchDuration      = TestUtilities::MeasureMilliseconds( [ & ]() { this->ProcessPairs( pairBlueprint, numberOfPairs, true ); } );
+
+  std::cout << "Single-shot: " << 1000.0 * numberOfPairs / singleShotDuration << " pairs/s" << std::endl;
+  std::cout << "Batched:     " << 1000.0 * numberOfPairs / batchDuration << " pairs/s" << std::endl;
+}
+#endif
 }
@@ -20,6 +20,7 @@
 #ifndef selxLoggerImpl_h
 #define selxLoggerImpl_h
 
+#include <chrono>
 #include <iterator>
 
 #include "selxLogger.h"
@@ -44,6 +45,9 @@ public:
   void SetLogLevel( const LogLevel& level );
   void SetPattern( const std::string& pattern );
 
+  // The level, pattern and (a)sync mode apply to this instance only. In async mode, each stream
+  // gets its own bounded queue and background thread. Queue settings apply to streams that are
+  // added (or switched to async mode) afterwards.
   void SetSyncMode();
   void SetAsyncMode();
   void SetAsyncQueueBlockOnOverflow(void);
@@ -55,16 +59,35 @@ public:
   void RemoveStream( const std::string& identifier );
   void RemoveAllStreams( void );
 
+  /** Returns false if a message of this level would not reach any stream. Call sites can use this
+   * to skip building expensive log arguments, Log() itself checks it before formatting. */
+  bool ShouldLog( const LogLevel& level ) const
+  {
+    return level >= this->m_LogLevel && level != LogLevel::OFF && !this->m_Loggers.empty();
+  }
+
   void Log( const LogLevel& level, const std::string& message );
 
   template < typename ... Args >
   void
   Log( const LogLevel& level, const std::string& fmt, const Args& ... args )
   {
-  	for( const auto& identifierAndLogger : this->m_Loggers )
-  	{
-      identifierAndLogger.second->log( this->ToSpdLogLevel( level ), fmt.c_str(), args ... );
-  	}
+    if( !this->ShouldLog( level ) )
+    {
+      return;
+    }
+
+    // Format once for all streams
+    std::string message;
+    try
+    {
+      message = fmt::format( fmt, args ... );
+    }
+    catch( const std::exception& e )
+    {
+      message = "Failed to format log message '" + fmt + "': " + e.what();
+    }
+    this->Log( level, message );
   }
 
   // Stream std:vector to string
@@ -127,14 +150,26 @@ private:
     }
   }
 
+  // Logger container
+  typedef std::shared_ptr< spdlog::logger > LoggerType;
+  typedef std::map< std::string, LoggerType > LoggerVectorType;
+
+  // Creates a logger that is owned by this instance only, i.e. it is not registered in spdlog's global registry.
+  // In async mode the logger has its own bounded queue and worker thread that periodically flushes the sinks.
+  LoggerType CreateLogger( const std::string& identifier, const std::vector< spdlog::sink_ptr >& sinks ) const;
+
+  // Recreates all loggers with the current (a)sync configuration, keeping their sinks
+  void RecreateLoggers();
+
   // Spdlog configuration
-  spdlog::level::level_enum ToSpdLogLevel( const LogLevel& level );
+  spdlog::level::level_enum ToSpdLogLevel( const LogLevel& level ) const;
+  LogLevel m_LogLevel;
+  std::string m_Pattern;
+  bool m_IsAsync;
   size_t m_AsyncQueueSize;
   AsyncQueueOverflowPolicyType m_AsyncQueueOverflowPolicy;
+  std::chrono::milliseconds m_AsyncFlushInterval;
 
-  // Logger container
-  typedef std::shared_ptr< spdlog::logger > LoggerType;
-  typedef std::map< std::string, LoggerType > LoggerVectorType;
   LoggerVectorType m_Loggers;
 
 };
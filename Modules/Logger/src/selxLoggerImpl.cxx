@@ -18,16 +18,20 @@
  *=========================================================================*/
 
 #include "selxLoggerImpl.h"
-#include "spdlog/details/registry.h"
 
 namespace selx
 {
 
 LoggerImpl
-::LoggerImpl() : m_Loggers(), m_AsyncQueueSize( 262144 ), m_AsyncQueueOverflowPolicy( spdlog::async_overflow_policy::block_retry )
+::LoggerImpl() :
+  m_LogLevel( LogLevel::INF ),
+  m_Pattern( "[%Y-%m-%d %H:%M:%S.%f] [thread %t] [%l] %v" ),
+  m_IsAsync( false ),
+  m_AsyncQueueSize( 262144 ),
+  m_AsyncQueueOverflowPolicy( spdlog::async_overflow_policy::block_retry ),
+  m_AsyncFlushInterval( 500 ),
+  m_Loggers()
 {
-  this->SetSyncMode();
-  this->SetPattern( "[%Y-%m-%d %H:%M:%S.%f] [thread %t] [%l] %v" );
 }
 
 LoggerImpl
@@ -38,7 +42,7 @@ LoggerImpl
 
 spdlog::level::level_enum
 LoggerImpl
-::ToSpdLogLevel( const LogLevel& level ) {
+::ToSpdLogLevel( const LogLevel& level ) const {
   switch (level) {
     case LogLevel::TRC:
       return spdlog::level::level_enum::trace;
@@ -63,7 +67,7 @@ void
 LoggerImpl
 ::SetLogLevel( const LogLevel& level ) {
   spdlog::level::level_enum spdloglevel = this->ToSpdLogLevel( level );
-  spdlog::set_level( spdloglevel );
+  this->m_LogLevel = level;
   for( const auto& item : this->m_Loggers )
   {
     item.second->set_level( spdloglevel );
@@ -74,21 +78,33 @@ void
 LoggerImpl
 ::SetPattern( const std::string& pattern )
 {
-  spdlog::set_pattern( pattern );
+  this->m_Pattern = pattern;
+  for( const auto& item : this->m_Loggers )
+  {
+    item.second->set_pattern( pattern );
+  }
 }
 
 void
 LoggerImpl
 ::SetSyncMode()
 {
-  spdlog::set_sync_mode();
+  if( this->m_IsAsync )
+  {
+    this->m_IsAsync = false;
+    this->RecreateLoggers();
+  }
 }
 
 void
 LoggerImpl
 ::SetAsyncMode()
 {
-  spdlog::set_async_mode(this->m_AsyncQueueSize, this->m_AsyncQueueOverflowPolicy);
+  if( !this->m_IsAsync )
+  {
+    this->m_IsAsync = true;
+    this->RecreateLoggers();
+  }
 }
 
 void
@@ -126,16 +142,18 @@ void
 LoggerImpl
 ::AddStream( const std::string& identifier, std::ostream& stream, const bool& forceFlush )
 {
+  if( this->m_Loggers.count( identifier ) > 0 )
+  {
+    throw std::runtime_error( "Logger with name '" + identifier + "' already exists." );
+  }
   auto sink = std::make_shared< spdlog::sinks::ostream_sink< std::mutex > >(stream, forceFlush);
-  auto logger = spdlog::details::registry::instance().create(identifier, sink );
-  this->m_Loggers.insert( std::make_pair( identifier, logger ) );
+  this->m_Loggers.insert( std::make_pair( identifier, this->CreateLogger( identifier, { sink } ) ) );
 }
 
 void
 LoggerImpl
 ::RemoveStream( const std::string& name )
 {
-  spdlog::drop( name );
   this->m_Loggers.erase( name );
 }
 
@@ -143,11 +161,6 @@ void
 LoggerImpl
 ::RemoveAllStreams( void )
 {
-  for( const auto& identifierAndLogger : this->m_Loggers )
-  {
-    spdlog::drop( identifierAndLogger.first );
-  }
-
   this->m_Loggers.clear();
 }
 
@@ -155,6 +168,11 @@ void
 LoggerImpl
 ::Log( const LogLevel& level, const std::string& message )
 {
+  if( !this->ShouldLog( level ) )
+  {
+    return;
+  }
+
   auto spdLogLevel = this->ToSpdLogLevel( level );
   for( const auto& identifierAndLogger : this->m_Loggers )
   {
@@ -162,4 +180,36 @@ LoggerImpl
   }
 }
 
+LoggerImpl::LoggerType
+LoggerImpl
+::CreateLogger( const std::string& identifier, const std::vector< spdlog::sink_ptr >& sinks ) const
+{
+  LoggerType logger;
+  if( this->m_IsAsync )
+  {
+    logger = std::make_shared< spdlog::async_logger >( identifier, sinks.begin(), sinks.end(), this->m_AsyncQueueSize,
+      this->m_AsyncQueueOverflowPolicy, nullptr, this->m_AsyncFlushInterval );
+  }
+  else
+  {
+    logger = std::make_shared< spdlog::logger >( identifier, sinks.begin(), sinks.end() );
+  }
+  logger->set_pattern( this->m_Pattern );
+  logger->set_level( this->ToSpdLogLevel( this->m_LogLevel ) );
+  return logger;
+}
+
+void
+LoggerImpl
+::RecreateLoggers()
+{
+  for( auto& identifierAndLogger : this->m_Loggers )
+  {
+    // Pending messages of an async logger are written before its worker thread is joined
+    auto sinks = identifierAndLogger.second->sinks();
+    identifierAndLogger.second->flush();
+    identifierAndLogger.second = this->CreateLogger( identifierAndLogger.first, sinks );
+  }
+}
+
 } // namespace
@@ -21,6 +21,10 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
 using namespace selx;
 
 TEST( LoggerImplTest, Initialization )
@@ -55,3 +59,100 @@ TEST( LoggerImplTest, Console )
    LoggerImpl logger = LoggerImpl();
    logger.AddStream( "cout", std::cout );
  }
+
+namespace
+{
+// Counts how often it is streamed, i.e. formatted into a log message
+struct FormatCounter
+{
+  mutable int count = 0;
+};
+
+std::ostream& operator<<( std::ostream& os, const FormatCounter& counter )
+{
+  ++counter.count;
+  return os << "counted";
+}
+}
+
+TEST( LoggerImplTest, LevelGate )
+{
+  LoggerImpl logger = LoggerImpl();
+  FormatCounter counter;
+
+  // Without streams nothing is logged, not even critical messages
+  EXPECT_FALSE( logger.ShouldLog( LogLevel::CRT ) );
+  logger.Log( LogLevel::CRT, "{0}", counter );
+  EXPECT_EQ( 0, counter.count );
+
+  std::ostringstream stream1;
+  std::ostringstream stream2;
+  logger.AddStream( "stream1", stream1 );
+  logger.AddStream( "stream2", stream2 );
+  EXPECT_FALSE( logger.ShouldLog( LogLevel::DBG ) );
+  EXPECT_TRUE( logger.ShouldLog( LogLevel::INF ) );
+
+  // Messages below the level are not formatted
+  logger.Log( LogLevel::DBG, "{0}", counter );
+  EXPECT_EQ( 0, counter.count );
+  EXPECT_TRUE( stream1.str().empty() );
+
+  // Messages are formatted once for all streams
+  logger.Log( LogLevel::INF, "{0}", counter );
+  EXPECT_EQ( 1, counter.count );
+  EXPECT_NE( std::string::npos, stream1.str().find( "counted" ) );
+  EXPECT_NE( std::string::npos, stream2.str().find( "counted" ) );
+}
+
+TEST( LoggerImplTest, IndependentInstances )
+{
+  // Level, pattern and stream names of one instance do not affect another
+  std::ostringstream stream1;
+  LoggerImpl logger1 = LoggerImpl();
+  logger1.AddStream( "stream", stream1 );
+  logger1.SetPattern( "%v" );
+  logger1.SetLogLevel( LogLevel::TRC );
+
+  std::ostringstream stream2;
+  LoggerImpl logger2 = LoggerImpl();
+  logger2.AddStream( "stream", stream2 );
+  EXPECT_THROW( logger2.AddStream( "stream", stream2 ), std::runtime_error );
+
+  logger1.Log( LogLevel::DBG, "debug" );
+  logger2.Log( LogLevel::DBG, "debug" );
+  EXPECT_EQ( "debug\n", stream1.str() );
+  EXPECT_TRUE( stream2.str().empty() );
+}
+
+TEST( LoggerImplTest, AsyncMode )
+{
+  std::ostringstream stream;
+  LoggerImpl logger = LoggerImpl();
+  logger.SetPattern( "%v" );
+  logger.AddStream( "stream", stream );
+  logger.SetAsyncQueueSize( 1024 );
+  logger.SetAsyncMode();
+
+  const unsigned int numberOfThreads = 4;
+  const unsigned int numberOfMessages = 100;
+  std::vector< std::thread > threads;
+  for( unsigned int thread = 0; thread < numberOfThreads; ++thread )
+  {
+    threads.emplace_back( [ &logger, thread ]() {
+      for( unsigned int message = 0; message < numberOfMessages; ++message )
+      {
+        logger.Log( LogLevel::INF, "thread {0} message {1}", thread, message );
+      }
+    } );
+  }
+  for( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  // Switching back to sync mode writes all pending messages
+  logger.SetSyncMode();
+  const std::string output = stream.str();
+  EXPECT_EQ( numberOfThreads * numberOfMessages, std::count( output.begin(), output.end(), '\n' ) );
+  EXPECT_NE( std::string::npos, output.find( "thread 3 message 99\n" ) );
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxTestUtilities_h
+#define selxTestUtilities_h
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace selx
+{
+/** Helpers shared by the unit tests of the filters and by the benchmarks. Benchmarks print their timings and
+ * are only built with BUILD_LONG_UNIT_TESTS, i.e. when SUPERELASTIX_BUILD_LONG_UNIT_TESTS is defined. */
+class TestUtilities
+{
+public:
+
+  /** A smooth 3D test image of size^3 voxels: sin along x, cos along y and a ramp along z */
+  template< class TImage >
+  static typename TImage::Pointer MakeSinCosImage( unsigned int size, const typename TImage::SpacingType & spacing,
+    const typename TImage::PointType & origin )
+  {
+    typename TImage::SizeType imageSize;
+    imageSize.Fill( size );
+
+    auto image = TImage::New();
+    image->SetRegions( imageSize );
+    image->SetSpacing( spacing );
+    image->SetOrigin( origin );
+    image->Allocate();
+    itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetLargestPossibleRegion() );
+    for( ; !it.IsAtEnd(); ++it )
+    {
+      const auto & index = it.GetIndex();
+      it.Set( static_cast< typename TImage::PixelType >( 100.0 * std::sin( 0.1 * index[ 0 ] ) * std::cos( 0.07 * index[ 1 ] ) + index[ 2 ] ) );
+    }
+    return image;
+  }
+
+
+  /** A resample filter of type TFilter (itk::ResampleImageFilter or one of the filters derived from it) that
+   * samples image on the grid of reference, with a linear or nearest neighbour interpolator */
+  template< class TFilter, class TTransform, class TReference >
+  static typename TFilter::Pointer MakeResampleFilter( const typename TFilter::InputImageType * image, const TTransform * transform,
+    const TReference * reference, bool nearestNeighbor )
+  {
+    typedef itk::NearestNeighborInterpolateImageFunction< typename TFilter::InputImageType,
+      typename TFilter::InterpolatorType::CoordRepType > NearestNeighborInterpolatorType;
+
+    auto filter = TFilter::New();
+    filter->SetInput( image );
+    filter->SetTransform( transform );
+    filter->SetOutputParametersFromImage( reference );
+    filter->SetDefaultPixelValue( -1 );
+    if( nearestNeighbor )
+    {
+      filter->SetInterpolator( NearestNeighborInterpolatorType::New() );
+    }
+    return filter;
+  }
+
+
+  /** Expects at most maximumFractionOfDifferences of the pixels of actual to differ more than tolerance from expected */
+  template< class TImage >
+  static void ExpectImagesNear( const TImage * expected, const TImage * actual, double tolerance, double maximumFractionOfDifferences )
+  {
+    itk::ImageRegionConstIterator< TImage > expectedIt( expected, expected->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator< TImage > actualIt( actual, actual->GetLargestPossibleRegion() );
+    itk::SizeValueType                      numberOfDifferences = 0;
+    for( ; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt )
+    {
+      numberOfDifferences += std::abs( expectedIt.Get() - actualIt.Get() ) > tolerance;
+    }
+    EXPECT_LE( numberOfDifferences, maximumFractionOfDifferences * expected->GetLargestPossibleRegion().GetNumberOfPixels() );
+  }
+
+
+  /** The wall clock time of calling function, in milliseconds */
+  template< class TFunction >
+  static double MeasureMilliseconds( TFunction && function )
+  {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+  }
+};
+} // namespace selx
+
+#endif // selxTestUtilities_h